@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_benchmark_h
+#define __kmnd_benchmark_h
+
+#include <stddef.h>
+
+/*
+ * This is the signature of a function that is measured. It is called
+ * repeatedly with the given context and returns a value that is accumulated
+ * so that the compiler cannot optimize the work away.
+ */
+typedef size_t (*kmnd_benchmark_cb)(void *context);
+
+/**
+ * This function runs the given callback until at least a fixed amount of time
+ * has elapsed and prints the throughput in megabytes per second, given the
+ * number of bytes that a single call processes.
+ */
+void kmnd_benchmark_run(const char *name, kmnd_benchmark_cb cb, void *context,
+                        const size_t num_bytes);
+
+/**
+ * This function runs all benchmarks for running lines.
+ */
+void kmnd_benchmark_line(void);
+
+/**
+ * This function runs all benchmarks for parsing numbers.
+ */
+void kmnd_benchmark_number(void);
+
+/**
+ * This function runs all benchmarks for the terminal.
+ */
+void kmnd_benchmark_terminal(void);
+
+#endif /* __kmnd_benchmark_h */
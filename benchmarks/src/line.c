@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kmnd.h>
+
+#include "benchmark.h"
+#include "line.h"
+
+/*
+ * This is the number of lines that are run per iteration.
+ */
+#define KMND_BENCHMARK_LINE_COUNT 4096
+
+typedef struct kmnd_benchmark_line_s {
+    char *text;
+    size_t length;
+
+    /* These are the offsets of the lines in `text`, which are separated by
+     * newlines. */
+    size_t *offsets;
+
+    kmnd_t *kmnd;
+    kmnd_line_t line;
+} kmnd_benchmark_line_t;
+
+static int kmnd_benchmark_line_run(kmnd_t *kmnd) {
+    (void) kmnd;
+
+    return 0;
+}
+
+static kmnd_t *kmnd_benchmark_line_tree(void) {
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0),
+           *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *count = kmnd_int32_new('c', "count", "This is count.",
+                                   KMND_FLAGS_NONE, 3),
+           *key = kmnd_input_new("key", "This is key.", KMND_FLAGS_REQUIRED,
+                                 NULL),
+           *value = kmnd_input_new("value", "This is value.",
+                                   KMND_FLAGS_NONE, NULL),
+           *set = kmnd_new("set", "This is set.", kmnd_benchmark_line_run,
+                           count, key, value, NULL),
+           *get = kmnd_new("get", "This is get.", kmnd_benchmark_line_run,
+                           kmnd_input_new("key", "This is key.",
+                                          KMND_FLAGS_REQUIRED, NULL), NULL);
+
+    return kmnd_new("control", "This is control.", NULL, verbose, name, set,
+                    get, NULL);
+}
+
+/* This is the previous approach, which splits the line on spaces and runs it
+ * with a new tree. */
+static size_t kmnd_benchmark_line_rebuild(void *context) {
+    kmnd_benchmark_line_t *benchmark = context;
+
+    size_t sum = 0;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_LINE_COUNT; i ++) {
+        const char *string = benchmark->text + benchmark->offsets[i];
+        const size_t length = benchmark->offsets[i + 1] - 1 -
+                              benchmark->offsets[i];
+
+        int argc = 0;
+        kmnd_line_split(&benchmark->line, string, length, "control", &argc);
+
+        kmnd_t *kmnd = kmnd_benchmark_line_tree();
+        sum += (size_t) kmnd_run(kmnd, argc, benchmark->line.argv);
+        kmnd_free(kmnd);
+    }
+
+    return sum;
+}
+
+static size_t kmnd_benchmark_line_reuse(void *context) {
+    kmnd_benchmark_line_t *benchmark = context;
+
+    size_t sum = 0;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_LINE_COUNT; i ++) {
+        const char *string = benchmark->text + benchmark->offsets[i];
+        const size_t length = benchmark->offsets[i + 1] - 1 -
+                              benchmark->offsets[i];
+
+        sum += (size_t) kmnd_run_line(benchmark->kmnd, string, length);
+    }
+
+    return sum;
+}
+
+void kmnd_benchmark_line(void) {
+    kmnd_benchmark_line_t benchmark;
+    memset(&benchmark, 0, sizeof(kmnd_benchmark_line_t));
+
+    benchmark.text = malloc(KMND_BENCHMARK_LINE_COUNT * 64);
+    benchmark.offsets = malloc((KMND_BENCHMARK_LINE_COUNT + 1) *
+                               sizeof(size_t));
+
+    srand(42);
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_LINE_COUNT; i ++) {
+        benchmark.offsets[i] = benchmark.length;
+
+        if (rand() % 2 == 0)
+            benchmark.length += (size_t) sprintf(
+                benchmark.text + benchmark.length,
+                "set -v --count=%d 'key %d' \"value\\\"%d\"\n", rand() % 1000,
+                rand() % 1000, rand() % 1000);
+        else
+            benchmark.length += (size_t) sprintf(
+                benchmark.text + benchmark.length, "get --name=n%d key%d\n",
+                rand() % 1000, rand() % 1000);
+    }
+
+    benchmark.offsets[i] = benchmark.length;
+
+    benchmark.kmnd = kmnd_benchmark_line_tree();
+    benchmark.line.allocator = kmnd_allocator_current();
+
+    kmnd_benchmark_run("line/rebuild", kmnd_benchmark_line_rebuild, &benchmark,
+                       benchmark.length);
+    kmnd_benchmark_run("line/run", kmnd_benchmark_line_reuse, &benchmark,
+                       benchmark.length);
+
+    kmnd_line_release(&benchmark.line);
+    kmnd_free(benchmark.kmnd);
+
+    free(benchmark.offsets);
+    free(benchmark.text);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "benchmark.h"
+
+/*
+ * This is the minimum amount of time that each benchmark runs for.
+ */
+#define KMND_BENCHMARK_SECONDS 1.0
+
+static double kmnd_benchmark_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+void kmnd_benchmark_run(const char *name, kmnd_benchmark_cb cb, void *context,
+                        const size_t num_bytes) {
+    /* Warm up caches (and the dispatcher) before measuring. */
+    volatile size_t sink = cb(context);
+
+    const double start = kmnd_benchmark_now();
+    double elapsed = 0;
+    size_t iterations = 0;
+
+    while (elapsed < KMND_BENCHMARK_SECONDS) {
+        sink += cb(context);
+        iterations ++;
+
+        elapsed = kmnd_benchmark_now() - start;
+    }
+
+    (void) sink;
+
+    const double throughput = (double) num_bytes * iterations / elapsed / 1e6;
+
+    printf("%-32s %10.1f MB/s %10.3f ms/iter\n", name, throughput,
+           elapsed * 1e3 / iterations);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    kmnd_benchmark_line();
+    kmnd_benchmark_number();
+    kmnd_benchmark_terminal();
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "number.h"
+#include "real.h"
+
+/*
+ * This is the number of values that are parsed per iteration.
+ */
+#define KMND_BENCHMARK_NUMBER_COUNT (1 << 20)
+
+typedef struct kmnd_benchmark_number_s {
+    char *text;
+    size_t length;
+
+    /* These are the offsets of the values in `text`, which are separated by
+     * NUL bytes. */
+    size_t *offsets;
+} kmnd_benchmark_number_t;
+
+/* This is the previous implementation, which calls strtoimax and checks
+ * errno. */
+static int kmnd_benchmark_strto(const char *string, int64_t *value) {
+    char *end = NULL;
+    errno = 0;
+    intmax_t result = strtoimax(string, &end, 10);
+
+    if ((end != NULL && end[0] != 0) || errno != 0)
+        return -1;
+
+    *value = result;
+
+    return 0;
+}
+
+static size_t kmnd_benchmark_number_strto(void *context) {
+    kmnd_benchmark_number_t *benchmark = context;
+
+    size_t sum = 0;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_NUMBER_COUNT; i ++) {
+        int64_t value = 0;
+        kmnd_benchmark_strto(benchmark->text + benchmark->offsets[i], &value);
+        sum += (size_t) value;
+    }
+
+    return sum;
+}
+
+static size_t kmnd_benchmark_number_parse(void *context) {
+    kmnd_benchmark_number_t *benchmark = context;
+
+    size_t sum = 0;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_NUMBER_COUNT; i ++) {
+        const char *string = benchmark->text + benchmark->offsets[i];
+
+        int64_t value = 0;
+        kmnd_number_parse_signed(string, strlen(string), INT64_MIN, INT64_MAX,
+                                 &value);
+        sum += (size_t) value;
+    }
+
+    return sum;
+}
+
+/* This is the previous implementation, which switches to the C locale around
+ * strtod. */
+static int kmnd_benchmark_strtod(const char *string, double *value) {
+    errno = 0;
+    char *end = NULL;
+
+    char *locale = setlocale(LC_NUMERIC, "C");
+    double result = strtod(string, &end);
+    setlocale(LC_NUMERIC, locale);
+
+    if ((end != NULL && end[0] != 0) || errno != 0)
+        return -1;
+
+    *value = result;
+
+    return 0;
+}
+
+static size_t kmnd_benchmark_real_strtod(void *context) {
+    kmnd_benchmark_number_t *benchmark = context;
+
+    double sum = 0;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_NUMBER_COUNT; i ++) {
+        double value = 0;
+        kmnd_benchmark_strtod(benchmark->text + benchmark->offsets[i], &value);
+        sum += value;
+    }
+
+    return sum != 0;
+}
+
+static size_t kmnd_benchmark_real_parse(void *context) {
+    kmnd_benchmark_number_t *benchmark = context;
+
+    double sum = 0;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_NUMBER_COUNT; i ++) {
+        const char *string = benchmark->text + benchmark->offsets[i];
+
+        double value = 0;
+        kmnd_real_parse_double(string, strlen(string), &value);
+        sum += value;
+    }
+
+    return sum != 0;
+}
+
+static void kmnd_benchmark_real(void) {
+    kmnd_benchmark_number_t benchmark;
+
+    benchmark.text = malloc(KMND_BENCHMARK_NUMBER_COUNT * 32);
+    benchmark.offsets = malloc(KMND_BENCHMARK_NUMBER_COUNT * sizeof(size_t));
+    benchmark.length = 0;
+
+    /* Half of the values are short decimals (as typed on a command line) and
+     * the other half are doubles printed with full precision. */
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_NUMBER_COUNT; i ++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        char *string = benchmark.text + benchmark.length;
+        int length;
+
+        if (i % 2 == 0)
+            length = sprintf(string, "%d.%02d", (int) (state % 1000),
+                             (int) ((state >> 16) % 100));
+        else
+            length = sprintf(string, "%.17g", (double) (state >> 11) /
+                             (double) (1ULL << 53) * 1e6);
+
+        benchmark.offsets[i] = benchmark.length;
+        benchmark.length += length + 1;
+    }
+
+    kmnd_benchmark_run("real/strtod", kmnd_benchmark_real_strtod, &benchmark,
+                       benchmark.length);
+    kmnd_benchmark_run("real/parse", kmnd_benchmark_real_parse, &benchmark,
+                       benchmark.length);
+
+    free(benchmark.offsets);
+    free(benchmark.text);
+}
+
+void kmnd_benchmark_number(void) {
+    kmnd_benchmark_number_t benchmark;
+
+    benchmark.text = malloc(KMND_BENCHMARK_NUMBER_COUNT * 21);
+    benchmark.offsets = malloc(KMND_BENCHMARK_NUMBER_COUNT * sizeof(size_t));
+    benchmark.length = 0;
+
+    /* Values have a uniformly distributed number of digits (1 to 19) and
+     * about a quarter of them is negative. */
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    size_t i;
+    for (i = 0; i < KMND_BENCHMARK_NUMBER_COUNT; i ++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        int num_digits = 1 + (int) (state % 19);
+        uint64_t value = state >> 8;
+
+        char *string = benchmark.text + benchmark.length;
+        size_t length = 0;
+
+        if ((state & 0xC0) == 0)
+            string[length ++] = '-';
+
+        string[length ++] = '1' + (char) (value % 9);
+
+        while (-- num_digits > 0) {
+            value /= 3;
+            string[length ++] = '0' + (char) (value % 10);
+        }
+
+        string[length ++] = '\0';
+
+        benchmark.offsets[i] = benchmark.length;
+        benchmark.length += length;
+    }
+
+    kmnd_benchmark_run("number/strtoimax", kmnd_benchmark_number_strto,
+                       &benchmark, benchmark.length);
+    kmnd_benchmark_run("number/parse", kmnd_benchmark_number_parse,
+                       &benchmark, benchmark.length);
+
+    free(benchmark.offsets);
+    free(benchmark.text);
+
+    kmnd_benchmark_real();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "benchmark.h"
+#include "scan.h"
+#include "terminal.h"
+
+/*
+ * This is the size of the generated markup text that is formatted.
+ */
+#define KMND_BENCHMARK_TERMINAL_SIZE (4 << 20)
+
+typedef struct kmnd_benchmark_terminal_s {
+    char *text;
+    size_t length;
+    kmnd_terminal_t *terminal;
+} kmnd_benchmark_terminal_t;
+
+static size_t kmnd_benchmark_scan_portable(void *context) {
+    kmnd_benchmark_terminal_t *benchmark = context;
+
+    size_t count = 0;
+    size_t i = 0;
+
+    while (i < benchmark->length) {
+        i += kmnd_scan_any_portable(benchmark->text + i, benchmark->length - i,
+                                    "`*_{", 4) + 1;
+        count ++;
+    }
+
+    return count;
+}
+
+static size_t kmnd_benchmark_scan(void *context) {
+    kmnd_benchmark_terminal_t *benchmark = context;
+
+    size_t count = 0;
+    size_t i = 0;
+
+    while (i < benchmark->length) {
+        i += kmnd_scan_any(benchmark->text + i, benchmark->length - i,
+                           "`*_{", 4) + 1;
+        count ++;
+    }
+
+    return count;
+}
+
+static size_t kmnd_benchmark_format(void *context) {
+    kmnd_benchmark_terminal_t *benchmark = context;
+
+    kmnd_terminal_format(benchmark->terminal, benchmark->text,
+                         KMND_TERMINAL_OPTIONS_NONE);
+    kmnd_terminal_flush(benchmark->terminal);
+
+    return benchmark->length;
+}
+
+void kmnd_benchmark_terminal(void) {
+    kmnd_benchmark_terminal_t benchmark;
+
+    /* Markup in help texts is sparse: most of it is plain prose with an
+     * occasional bold word or code sample. */
+    static const char *const paragraph =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+        "eiusmod tempor incididunt ut labore et dolore magna aliqua. Use "
+        "`--verbose` to print **more** output and *less* noise. Ut enim ad "
+        "minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+        "aliquip ex ea commodo consequat.\n";
+
+    const size_t paragraph_length = strlen(paragraph);
+
+    benchmark.length = KMND_BENCHMARK_TERMINAL_SIZE -
+                       KMND_BENCHMARK_TERMINAL_SIZE % paragraph_length;
+    benchmark.text = malloc(benchmark.length + 1);
+
+    size_t i;
+    for (i = 0; i < benchmark.length; i += paragraph_length)
+        memcpy(benchmark.text + i, paragraph, paragraph_length);
+
+    benchmark.text[benchmark.length] = '\0';
+
+    const int fd = open("/dev/null", O_WRONLY);
+    benchmark.terminal = kmnd_terminal_new(fd);
+
+    kmnd_benchmark_run("terminal/scan_portable", kmnd_benchmark_scan_portable,
+                       &benchmark, benchmark.length);
+    kmnd_benchmark_run("terminal/scan", kmnd_benchmark_scan, &benchmark,
+                       benchmark.length);
+    kmnd_benchmark_run("terminal/format", kmnd_benchmark_format, &benchmark,
+                       benchmark.length);
+
+    kmnd_terminal_free(benchmark.terminal);
+    close(fd);
+
+    free(benchmark.text);
+}
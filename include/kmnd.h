@@ -27,7 +27,9 @@
 extern "C" {
 #endif /* __cplusplus */
 
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 typedef struct kmnd_s kmnd_t;
 
@@ -38,6 +40,25 @@ typedef enum kmnd_flags_e {
     KMND_FLAGS_REQUIRED = (1 << 0),
 } kmnd_flags_t;
 
+/*
+ * These are the types of the values of options. The value of an input is a
+ * string.
+ */
+typedef enum kmnd_value_e {
+    KMND_VALUE_BOOLEAN = 0,
+    KMND_VALUE_STRING  = 1,
+    KMND_VALUE_INT8    = 2,
+    KMND_VALUE_INT16   = 3,
+    KMND_VALUE_INT32   = 4,
+    KMND_VALUE_INT64   = 5,
+    KMND_VALUE_UINT8   = 6,
+    KMND_VALUE_UINT16  = 7,
+    KMND_VALUE_UINT32  = 8,
+    KMND_VALUE_UINT64  = 9,
+    KMND_VALUE_FLOAT   = 10,
+    KMND_VALUE_DOUBLE  = 11
+} kmnd_value_t;
+
 /**
  * This function creates a new kmnd. This can be either the root command or a
  * subcommand. The first argument is the name of the kmnd. If it is the root
@@ -50,15 +71,66 @@ kmnd_t *kmnd_new(const char *name, const char *description, kmnd_run_cb *run,
 
 /**
  * This function can be used on kmnds and options to free the memory that is
- * allocated for them.
+ * allocated for them, including all of their subcommands, options, inputs and
+ * usage sections.
  */
 void kmnd_free(kmnd_t *kmnd);
 
 /**
  * This function can be used to override the default file descriptor (stdout).
+ * The file descriptor is used for this command and all of its subcommands
+ * unless they override it themselves.
  */
 int kmnd_fd(kmnd_t *kmnd, const int fd);
 
+/**
+ * This callback receives output written by kmnd (see kmnd_callback). It should
+ * return 0 on success and -1 if the output could not be written.
+ */
+typedef int (kmnd_write_cb)(void *context, const char *data,
+                            const size_t length);
+
+/**
+ * This function is similar to kmnd_fd but writes the output to the given
+ * stream instead. The stream is not closed by kmnd.
+ */
+int kmnd_file(kmnd_t *kmnd, FILE *file);
+
+/**
+ * This function makes the given command (and its subcommands) render their
+ * output into a growable buffer in memory instead, without any system calls.
+ * Use kmnd_output to retrieve it.
+ */
+int kmnd_memory(kmnd_t *kmnd);
+
+/**
+ * This function makes the given command (and its subcommands) pass their
+ * output to the given callback instead.
+ */
+int kmnd_callback(kmnd_t *kmnd, kmnd_write_cb *callback, void *context);
+
+/**
+ * This function returns the output that has been rendered into memory (see
+ * kmnd_memory) by the given command so far and stores its length in `length`.
+ * The output is terminated and remains owned by kmnd until it is cleared with
+ * kmnd_output_clear or the command is freed. NULL is returned if the command
+ * does not render into memory.
+ */
+const char *kmnd_output(kmnd_t *kmnd, size_t *length);
+
+/**
+ * This function discards the output that has been rendered into memory so
+ * far.
+ */
+void kmnd_output_clear(kmnd_t *kmnd);
+
+/**
+ * This function writes the output of the given command that is still buffered
+ * to its file descriptor, stream or callback (see kmnd_fd, kmnd_file and
+ * kmnd_callback). It returns -1 if the output could not be written.
+ */
+int kmnd_flush(kmnd_t *kmnd);
+
 /**
  * This function can be used to run the actual kmnd. The arguments you pass to
  * this function may simple be the argc and argv that is passed to your main
@@ -68,6 +140,34 @@ int kmnd_fd(kmnd_t *kmnd, const int fd);
  */
 int kmnd_run(kmnd_t *kmnd, const int argc, const char **argv);
 
+/**
+ * This function runs the given kmnd for a single line (e.g. read from a socket)
+ * instead of an argument vector. The line is split into arguments with the
+ * quoting rules of a POSIX shell (without any expansions or operators), and
+ * words that start with `#` are comments. Options and inputs that were set by
+ * the previous line are reset to their initial values first, so the same tree
+ * can run any number of lines. String values point into a buffer that is
+ * reused by the next line. It returns -1 if a quote is not terminated and the
+ * exit code of kmnd_run otherwise.
+ */
+int kmnd_run_line(kmnd_t *kmnd, const char *line, const size_t length);
+
+/**
+ * This function runs every line of the file at the given path (see
+ * kmnd_run_line) on `jobs` threads (0 means one for each processor), including
+ * the calling thread. Empty lines and comments are skipped. The tree is reset
+ * and frozen (see kmnd_freeze) and each line is parsed into a result of its
+ * own (see kmnd_parse), so string values are only valid while the callback of
+ * their line runs. The output of each line is written at once and in the
+ * order of the lines. If `codes` is not NULL, it is set to the exit codes of
+ * the lines (0 for empty lines and comments and -1 for lines that could not
+ * be run), which belong to the tree and remain valid until the next batch, and
+ * `num_lines` to their number. It returns the number of lines that failed, or
+ * -1 if the file could not be read.
+ */
+int kmnd_run_batch(kmnd_t *kmnd, const char *path, const size_t jobs,
+                   const int **codes, size_t *num_lines);
+
 /**
  * This function returns a new usage section based on the command and
  * description that you provide. Note that both will automatically be
@@ -76,6 +176,127 @@ int kmnd_run(kmnd_t *kmnd, const int argc, const char **argv);
  */
 kmnd_t *kmnd_usage_new(const char *command, const char *description);
 
+/**
+ * This function enables (or disables) caching of the rendered usage text of
+ * the given command and its subcommands. The rendered text is stored in
+ * $XDG_CACHE_HOME/kmnd (or ~/.cache/kmnd) per command, terminal width and color
+ * support, and is keyed by the build-id of the binary. Only enable this if the
+ * usage text does not depend on anything but the binary itself.
+ */
+void kmnd_usage_cache(kmnd_t *kmnd, const unsigned char enabled);
+
+/**
+ * This function makes the usage text of the given command and its subcommands
+ * wrap descriptions such that their lines are as even as possible, rather than
+ * filling each line with as many words as possible (which is the default).
+ */
+void kmnd_usage_balance(kmnd_t *kmnd, const unsigned char enabled);
+
+/**
+ * This function allows subcommands of the given command (and of its
+ * subcommands) to be abbreviated to any prefix of their name that is not
+ * shared with another subcommand, e.g. `st` for `status`.
+ */
+void kmnd_abbreviate(kmnd_t *kmnd, const unsigned char enabled);
+
+/**
+ * This function makes string options and inputs of the given command (and of
+ * its subcommands) point into the arguments that are passed to kmnd_run instead
+ * of copying them. The arguments must then outlive the values, which is always
+ * the case for the argv that is passed to main.
+ */
+void kmnd_borrow(kmnd_t *kmnd, const unsigned char enabled);
+
+/**
+ * This function makes kmnd_run expand each `@path` argument of the given
+ * command (and of its subcommands) into the arguments in the file at that path,
+ * which are split like a line (see kmnd_run_line) and may refer to other files.
+ * The file is read as its arguments are needed, without copying them. A file
+ * that cannot be read is passed on as a regular argument. kmnd_parse expands
+ * response files as well, and keeps them until its result is reset or freed.
+ */
+void kmnd_response_files(kmnd_t *kmnd, const unsigned char enabled);
+
+/**
+ * This function makes kmnd_run of the given root command run every line of a
+ * file (see kmnd_run_batch) when it is given `--batch=FILE` and optionally
+ * `--jobs=N` (and no other arguments).
+ */
+void kmnd_batch(kmnd_t *kmnd, const unsigned char enabled);
+
+/** ALLOCATION */
+
+typedef void *(kmnd_allocate_cb)(void *context, const size_t size);
+typedef void (kmnd_release_cb)(void *context, void *pointer);
+
+/*
+ * An allocator provides the memory for commands, options, inputs and usage
+ * sections and for everything they allocate themselves (such as parsed
+ * values). If `release` is NULL, memory is never released piece by piece (e.g.
+ * because it is all released at once).
+ */
+typedef struct kmnd_allocator_s {
+    kmnd_allocate_cb *allocate;
+    kmnd_release_cb *release;
+    void *context;
+} kmnd_allocator_t;
+
+/**
+ * This function makes the kmnd_X_new functions that are called from now on in
+ * the current thread allocate with the given allocator (or with malloc if
+ * allocator=NULL). It returns the allocator that was used before. The allocator
+ * must outlive the nodes that are allocated with it.
+ */
+const kmnd_allocator_t *kmnd_allocator_use(const kmnd_allocator_t *allocator);
+
+typedef struct kmnd_arena_s kmnd_arena_t;
+
+/**
+ * This function returns a new arena, which allocates memory from contiguous
+ * blocks of the given size (or a default size if block_size=0) and releases all
+ * of it at once when the arena is freed. Build a tree with the allocator of an
+ * arena, free it with kmnd_free (which then only releases the resources that do
+ * not belong to the arena, such as terminals) and free the arena afterwards.
+ */
+kmnd_arena_t *kmnd_arena_new(const size_t block_size);
+
+/**
+ * This function returns the allocator of the given arena.
+ */
+const kmnd_allocator_t *kmnd_arena_allocator(kmnd_arena_t *arena);
+
+/**
+ * This function frees the arena and all memory that was allocated from it.
+ */
+void kmnd_arena_free(kmnd_arena_t *arena);
+
+/** TEMPLATES */
+
+typedef struct kmnd_template_s kmnd_template_t;
+
+/**
+ * This function compiles the given format into a template that can be printed
+ * any number of times. The format uses the same markup as usage descriptions
+ * (e.g. `code`, *underline* and **bold**) and may contain placeholders {0},
+ * {1}, etc. that are substituted when the template is printed. Use {{ for a
+ * literal brace.
+ */
+kmnd_template_t *kmnd_template_new(const char *format);
+
+/**
+ * This function frees the memory that is allocated for the template.
+ */
+void kmnd_template_free(kmnd_template_t *tmpl);
+
+/**
+ * This function prints the template to the output of the given kmnd, followed
+ * by a newline. Placeholder {i} is replaced with values[i]; values are written
+ * as-is, without markup. It returns 0 on success and -1 if the output could not
+ * be written.
+ */
+int kmnd_template_print(kmnd_t *kmnd, const kmnd_template_t *tmpl,
+                        const char *const *values, const size_t num_values);
+
 /** INPUT */
 
 typedef int (kmnd_validator_cb)(kmnd_t *kmnd, const char *string);
@@ -96,6 +317,12 @@ kmnd_t *kmnd_input_new(const char *name, const char *description,
  */
 const char *kmnd_input_get(kmnd_t *kmnd, const char *path);
 
+/**
+ * This function is similar to kmnd_input_get but also stores the length of the
+ * value in `length`, so that it does not have to be measured again.
+ */
+const char *kmnd_input_view(kmnd_t *kmnd, const char *path, size_t *length);
+
 /** OPTIONS */
 
 /**
@@ -125,6 +352,12 @@ kmnd_t *kmnd_string_new(const char character, const char *name,
  */
 const char *kmnd_string_get(kmnd_t *kmnd, const char *path);
 
+/**
+ * This function is similar to kmnd_string_get but also stores the length of the
+ * string in `length`, so that it does not have to be measured again.
+ */
+const char *kmnd_string_view(kmnd_t *kmnd, const char *path, size_t *length);
+
 /*
  * These functions create signed integer options. Each _intN creates a N-bit
  * signed integer (i.e. -2^(N-1) <= i < 2^(N-1)).
@@ -194,6 +427,375 @@ kmnd_t *kmnd_double_new(const char character, const char *name,
 float kmnd_float_get(kmnd_t *kmnd, const char *path);
 double kmnd_double_get(kmnd_t *kmnd, const char *path);
 
+/*
+ * These functions create options that are bound to variables of your own. The
+ * current value of the variable is the default value and parsed values are
+ * written to the variable directly, so that you can read them without kmnd.
+ * The variable must outlive the option. Strings that are parsed remain owned by
+ * the option.
+ */
+kmnd_t *kmnd_boolean_bind(const char character, const char *name,
+                          const char *description, const kmnd_flags_t flags,
+                          unsigned char *variable);
+kmnd_t *kmnd_string_bind(const char character, const char *name,
+                         const char *description, const kmnd_flags_t flags,
+                         const char **variable);
+kmnd_t *kmnd_int8_bind(const char character, const char *name,
+                       const char *description, const kmnd_flags_t flags,
+                       int8_t *variable);
+kmnd_t *kmnd_int16_bind(const char character, const char *name,
+                        const char *description, const kmnd_flags_t flags,
+                        int16_t *variable);
+kmnd_t *kmnd_int32_bind(const char character, const char *name,
+                        const char *description, const kmnd_flags_t flags,
+                        int32_t *variable);
+kmnd_t *kmnd_int64_bind(const char character, const char *name,
+                        const char *description, const kmnd_flags_t flags,
+                        int64_t *variable);
+kmnd_t *kmnd_uint8_bind(const char character, const char *name,
+                        const char *description, const kmnd_flags_t flags,
+                        uint8_t *variable);
+kmnd_t *kmnd_uint16_bind(const char character, const char *name,
+                         const char *description, const kmnd_flags_t flags,
+                         uint16_t *variable);
+kmnd_t *kmnd_uint32_bind(const char character, const char *name,
+                         const char *description, const kmnd_flags_t flags,
+                         uint32_t *variable);
+kmnd_t *kmnd_uint64_bind(const char character, const char *name,
+                         const char *description, const kmnd_flags_t flags,
+                         uint64_t *variable);
+kmnd_t *kmnd_float_bind(const char character, const char *name,
+                        const char *description, const kmnd_flags_t flags,
+                        float *variable);
+kmnd_t *kmnd_double_bind(const char character, const char *name,
+                         const char *description, const kmnd_flags_t flags,
+                         double *variable);
+
+/** STATIC TREES */
+
+/*
+ * These specs describe a tree in tables that can be declared `static const`,
+ * which kmnd_spec_new turns into a tree without any variadic calls and with a
+ * single allocation. Use the KMND_X_SPEC macros to declare options and
+ * KMND_SPEC_ARRAY to refer to a table.
+ */
+typedef struct kmnd_option_spec_s {
+    char character;
+    const char *name;
+    const char *description;
+    kmnd_flags_t flags;
+
+    kmnd_value_t type;
+
+    /* Only the default value that matches the type is used. */
+    int64_t integer;
+    uint64_t unsigned_integer;
+    double real;
+    const char *string;
+
+    /* If this is not NULL, the option is bound to this variable (see
+     * kmnd_X_bind) and the default value is ignored. */
+    void *variable;
+} kmnd_option_spec_t;
+
+typedef struct kmnd_input_spec_s {
+    const char *name;
+    const char *description;
+    kmnd_flags_t flags;
+    kmnd_validator_cb *validator;
+} kmnd_input_spec_t;
+
+typedef struct kmnd_spec_s kmnd_spec_t;
+
+struct kmnd_spec_s {
+    const char *name;
+    const char *description;
+    kmnd_run_cb *run;
+
+    /* This is the command line of the usage section (see kmnd_usage_new),
+     * which is described by `description`. Use NULL for no usage section. */
+    const char *usage;
+
+    const kmnd_option_spec_t *options;
+    size_t num_options;
+
+    const kmnd_input_spec_t *inputs;
+    size_t num_inputs;
+
+    const kmnd_spec_t *commands;
+    size_t num_commands;
+};
+
+#define KMND_SPEC_ARRAY(array) (array), (sizeof(array) / sizeof((array)[0]))
+
+#define KMND_BOOLEAN_SPEC(character, name, description, flags, value) \
+    { (character), (name), (description), (flags), KMND_VALUE_BOOLEAN, \
+      (value), 0, 0, NULL, NULL }
+
+#define KMND_STRING_SPEC(character, name, description, flags, value) \
+    { (character), (name), (description), (flags), KMND_VALUE_STRING, \
+      0, 0, 0, (value), NULL }
+
+/* The type is INT8, INT16, INT32 or INT64. */
+#define KMND_INT_SPEC(type, character, name, description, flags, value) \
+    { (character), (name), (description), (flags), KMND_VALUE_##type, \
+      (value), 0, 0, NULL, NULL }
+
+/* The type is UINT8, UINT16, UINT32 or UINT64. */
+#define KMND_UINT_SPEC(type, character, name, description, flags, value) \
+    { (character), (name), (description), (flags), KMND_VALUE_##type, \
+      0, (value), 0, NULL, NULL }
+
+/* The type is FLOAT or DOUBLE. */
+#define KMND_REAL_SPEC(type, character, name, description, flags, value) \
+    { (character), (name), (description), (flags), KMND_VALUE_##type, \
+      0, 0, (value), NULL, NULL }
+
+/* The type is any of the above and the variable must have that type. */
+#define KMND_BIND_SPEC(type, character, name, description, flags, variable) \
+    { (character), (name), (description), (flags), KMND_VALUE_##type, \
+      0, 0, 0, NULL, (void *) (variable) }
+
+#define KMND_INPUT_SPEC(name, description, flags, validator) \
+    { (name), (description), (flags), (validator) }
+
+/**
+ * This function returns a new tree for the given spec (and NULL if it could
+ * not be allocated). Only the root command is created right away. The options,
+ * inputs and subcommands of a command are created from the spec when the
+ * command is first run, looked up by a path or frozen, so commands that are
+ * not used are never created. All nodes are allocated from one arena that is
+ * sized for the spec and freed with the tree by kmnd_free. Names, descriptions
+ * and the spec itself are not copied and must outlive the tree.
+ */
+kmnd_t *kmnd_spec_new(const kmnd_spec_t *spec);
+
+/** BINDING */
+
+/*
+ * A field describes where the value of an option or input is stored in a
+ * struct of your own. Use KMND_FIELD to declare one.
+ */
+typedef struct kmnd_field_s {
+    const char *path;
+    kmnd_value_t type;
+
+    size_t offset;
+    size_t size;
+} kmnd_field_t;
+
+/**
+ * This macro declares a field for the option or input at the given path, which
+ * is stored in the given member of the given struct. The type is the name of a
+ * value type without its prefix, e.g. INT32 or STRING. The member must be an
+ * unsigned char for booleans and a const char * for strings and inputs.
+ */
+#define KMND_FIELD(path, type, structure, member) \
+    { (path), KMND_VALUE_##type, offsetof(structure, member), \
+      sizeof(((structure *) 0)->member) }
+
+typedef struct kmnd_fields_s kmnd_fields_t;
+
+/**
+ * This function resolves the paths of the given fields and checks their types
+ * and sizes, once, so that kmnd_load only has to copy the values. It returns
+ * NULL if a path does not exist, if its type or size does not match the field
+ * or if memory could not be allocated. The compiled fields remain valid until
+ * the tree is freed and do not refer to the given array.
+ */
+kmnd_fields_t *kmnd_fields_compile(kmnd_t *kmnd, const kmnd_field_t *fields,
+                                   const size_t num_fields);
+
+/**
+ * This function frees the given compiled fields.
+ */
+void kmnd_fields_free(kmnd_fields_t *fields);
+
+/**
+ * This function stores the values of the options and inputs of the given
+ * compiled fields in the given struct, in a single pass (e.g. in the callback
+ * of a command after the command line has been parsed). Strings are not copied
+ * and remain owned by kmnd.
+ */
+void kmnd_load(const kmnd_fields_t *fields, void *target);
+
+/** HANDLES */
+
+/*
+ * A handle refers to a single option or input. Reading a value through a handle
+ * does not involve looking up its path.
+ */
+typedef struct kmnd_handle_s *kmnd_handle_t;
+
+/**
+ * This function returns a handle for the option or input at the given path,
+ * which is resolved in the same way as by the kmnd_X_get functions. NULL is
+ * returned if there is no option or input at that path. The handle remains
+ * valid until the tree is freed.
+ */
+kmnd_handle_t kmnd_resolve(kmnd_t *kmnd, const char *path);
+
+/**
+ * These functions return the value of the option that the given handle refers
+ * to. The handle must refer to an option of the same type.
+ */
+unsigned char kmnd_boolean_value(kmnd_handle_t handle);
+const char *kmnd_string_value(kmnd_handle_t handle);
+int8_t kmnd_int8_value(kmnd_handle_t handle);
+int16_t kmnd_int16_value(kmnd_handle_t handle);
+int32_t kmnd_int32_value(kmnd_handle_t handle);
+int64_t kmnd_int64_value(kmnd_handle_t handle);
+uint8_t kmnd_uint8_value(kmnd_handle_t handle);
+uint16_t kmnd_uint16_value(kmnd_handle_t handle);
+uint32_t kmnd_uint32_value(kmnd_handle_t handle);
+uint64_t kmnd_uint64_value(kmnd_handle_t handle);
+float kmnd_float_value(kmnd_handle_t handle);
+double kmnd_double_value(kmnd_handle_t handle);
+
+/**
+ * This function returns the value of the input that the given handle refers to.
+ */
+const char *kmnd_input_value(kmnd_handle_t handle);
+
+/**
+ * This function returns the value of the string option or input that the given
+ * handle refers to and stores its length in `length`.
+ */
+const char *kmnd_view(kmnd_handle_t handle, size_t *length);
+
+/*
+ * This is the handle that KMND_HANDLE keeps for each call site, together with
+ * the generation of the kmnd it was resolved for (which is never 0).
+ */
+typedef struct kmnd_handle_cache_s {
+    unsigned long generation;
+    kmnd_handle_t handle;
+} kmnd_handle_cache_t;
+
+/**
+ * This function returns the handle in the cache if it was resolved for the
+ * given kmnd, and resolves the given path and stores it in the cache otherwise.
+ * Use KMND_HANDLE instead.
+ */
+kmnd_handle_t kmnd_resolve_cached(kmnd_handle_cache_t *cache, kmnd_t *kmnd,
+                                  const char *path);
+
+/**
+ * This macro returns a handle for the given path that is only resolved the
+ * first time the call site is reached by a thread (and again when it is reached
+ * with a different kmnd, including a new tree at the address of a freed one).
+ * The path should therefore be constant. Compilers without statement
+ * expressions resolve the path every time.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define KMND_HANDLE(k_, path_) \
+    (__extension__ ({ \
+        static __thread kmnd_handle_cache_t kmnd_handle_cache_; \
+        kmnd_resolve_cached(&kmnd_handle_cache_, (k_), (path_)); \
+    }))
+#else
+#define KMND_HANDLE(k_, path_) kmnd_resolve((k_), (path_))
+#endif
+
+/** RESULTS */
+
+typedef struct kmnd_result_s kmnd_result_t;
+
+/**
+ * This function prepares the given tree for kmnd_parse. Afterwards the tree is
+ * only read by kmnd_parse and kmnd_result_run (including when they write usage
+ * text), so it can be shared by any number of threads (or processes that are
+ * forked afterwards). Output is written to the terminal of the tree, which is
+ * not synchronized, so threads should not write output at the same time unless
+ * it goes to their own terminals (as with kmnd_run_batch). The current values
+ * of the options become the defaults of each result. It returns -1 if memory
+ * could not be allocated. A frozen tree should no longer be passed to kmnd_run.
+ */
+int kmnd_freeze(kmnd_t *kmnd);
+
+/**
+ * This function returns a new result for the given frozen tree, which can be
+ * reused for any number of calls to kmnd_parse.
+ */
+kmnd_result_t *kmnd_result_new(const kmnd_t *kmnd);
+
+/**
+ * This function frees the given result.
+ */
+void kmnd_result_free(kmnd_result_t *result);
+
+/**
+ * This function parses the given arguments (in the same way as kmnd_run) and
+ * stores the values of all options and inputs in the result instead of in the
+ * tree. String values point into the arguments (or into the response files,
+ * which the result keeps), which must therefore outlive the result. Nothing is
+ * printed and no callback is run. It returns -1 if the arguments are invalid
+ * (see kmnd_result_report).
+ */
+int kmnd_parse(const kmnd_t *kmnd, const int argc, const char **argv,
+               kmnd_result_t *result);
+
+/**
+ * This function returns the (sub)command that the arguments that were parsed
+ * into the result selected.
+ */
+kmnd_t *kmnd_result_command(const kmnd_result_t *result);
+
+/**
+ * This function runs the callback of the command that was selected (or prints
+ * its usage, like kmnd_run). While the callback runs, kmnd_X_get and the other
+ * functions that retrieve values return the values in the result on this
+ * thread. It returns -1 if kmnd_parse failed and otherwise the value that the
+ * callback returned.
+ */
+int kmnd_result_run(kmnd_result_t *result);
+
+/**
+ * This function prints the error that kmnd_parse returned -1 for (or the usage
+ * text that was asked for with --help) to the terminal of the command.
+ */
+void kmnd_result_report(const kmnd_result_t *result);
+
+/**
+ * This function returns whether the option or input that the given handle
+ * refers to was given in the arguments that were parsed into the result.
+ */
+unsigned char kmnd_result_activated(const kmnd_result_t *result,
+                                    kmnd_handle_t handle);
+
+/**
+ * These functions return the value of the option that the given handle refers
+ * to in the given result. The handle must refer to an option of the same type.
+ */
+unsigned char kmnd_result_boolean(const kmnd_result_t *result,
+                                  kmnd_handle_t handle);
+const char *kmnd_result_string(const kmnd_result_t *result,
+                               kmnd_handle_t handle);
+int8_t kmnd_result_int8(const kmnd_result_t *result, kmnd_handle_t handle);
+int16_t kmnd_result_int16(const kmnd_result_t *result, kmnd_handle_t handle);
+int32_t kmnd_result_int32(const kmnd_result_t *result, kmnd_handle_t handle);
+int64_t kmnd_result_int64(const kmnd_result_t *result, kmnd_handle_t handle);
+uint8_t kmnd_result_uint8(const kmnd_result_t *result, kmnd_handle_t handle);
+uint16_t kmnd_result_uint16(const kmnd_result_t *result, kmnd_handle_t handle);
+uint32_t kmnd_result_uint32(const kmnd_result_t *result, kmnd_handle_t handle);
+uint64_t kmnd_result_uint64(const kmnd_result_t *result, kmnd_handle_t handle);
+float kmnd_result_float(const kmnd_result_t *result, kmnd_handle_t handle);
+double kmnd_result_double(const kmnd_result_t *result, kmnd_handle_t handle);
+
+/**
+ * This function returns the value of the input that the given handle refers to
+ * in the given result.
+ */
+const char *kmnd_result_input(const kmnd_result_t *result,
+                              kmnd_handle_t handle);
+
+/**
+ * This function returns the value of the string option or input that the given
+ * handle refers to in the given result and stores its length in `length`.
+ */
+const char *kmnd_result_view(const kmnd_result_t *result, kmnd_handle_t handle,
+                             size_t *length);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
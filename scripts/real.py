@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026-10-17, Tim van Elsloo
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# This script generates src/real_table.h, which contains the powers of five
+# that are used to parse floating point numbers:
+# `python3 scripts/real.py > src/real_table.h`.
+
+import sys
+
+# These are the smallest and largest powers of ten for which a decimal with at
+# most 19 digits is neither zero nor infinite as a double.
+SMALLEST_POWER = -342
+LARGEST_POWER = 308
+
+def powers():
+    # Each power of five is normalized to 128 bits, such that its most
+    # significant bit is set. Negative powers are rounded up and positive
+    # powers are truncated.
+    for q in range(SMALLEST_POWER, 0):
+        power = 5 ** -q
+        z = power.bit_length()
+
+        if q >= -27:
+            value = 2 ** (z + 127) // power + 1
+        else:
+            value = 2 ** (2 * z + 128) // power + 1
+
+            while value >= 1 << 128:
+                value //= 2
+
+        yield value
+
+    for q in range(0, LARGEST_POWER + 1):
+        value = 5 ** q
+
+        while value < 1 << 127:
+            value *= 2
+
+        while value >= 1 << 128:
+            value //= 2
+
+        yield value
+
+def main():
+    with open(__file__) as f:
+        license = [line[2:].rstrip() for line in f.readlines()[2:21]]
+
+    print('/*')
+    print('\n'.join((' * ' + line).rstrip() for line in license))
+    print(' */')
+    print()
+    print('/*')
+    print(' * This file is generated by scripts/real.py. Do not edit it manually.')
+    print(' */')
+    print()
+    print('#ifndef __kmnd_real_table_h')
+    print('#define __kmnd_real_table_h')
+    print()
+    print('#define KMND_REAL_SMALLEST_POWER (%d)' % SMALLEST_POWER)
+    print('#define KMND_REAL_LARGEST_POWER (%d)' % LARGEST_POWER)
+    print()
+    print('/*')
+    print(' * These are the high and low 64 bits of the powers of five from 5^%d' %
+          SMALLEST_POWER)
+    print(' * up to and including 5^%d.' % LARGEST_POWER)
+    print(' */')
+    print('static const uint64_t kmnd_real_powers[] = {')
+
+    for value in powers():
+        print('    0x%016XULL, 0x%016XULL,' % (value >> 64,
+                                               value & ((1 << 64) - 1)))
+
+    print('};')
+    print()
+    print('#endif /* __kmnd_real_table_h */')
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026-10-17, Tim van Elsloo
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# This script generates src/width_table.h from the Unicode database that ships
+# with Python: `python3 scripts/width.py > src/width_table.h`.
+
+import sys
+import unicodedata
+
+def ranges(predicate):
+    result = []
+
+    for code in range(0x80, 0x110000):
+        if not predicate(code):
+            continue
+
+        if result and result[-1][1] == code - 1:
+            result[-1][1] = code
+        else:
+            result.append([code, code])
+
+    return result
+
+def is_zero(code):
+    # Combining marks and format characters take no space, except for the
+    # soft hyphen which most terminals render. The same goes for the medial
+    # vowels and final consonants of Hangul syllables.
+    if code == 0xAD:
+        return False
+
+    if 0x1160 <= code <= 0x11FF or code == 0x200B:
+        return True
+
+    return unicodedata.category(chr(code)) in ('Mn', 'Me', 'Cf')
+
+def is_wide(code):
+    # The supplementary and tertiary ideographic planes are wide even where
+    # no characters have been assigned yet.
+    if 0x20000 <= code <= 0x2FFFD or 0x30000 <= code <= 0x3FFFD:
+        return True
+
+    if unicodedata.category(chr(code)) == 'Cn':
+        return False
+
+    return unicodedata.east_asian_width(chr(code)) in ('W', 'F')
+
+def table(name, values):
+    lines = ['static const kmnd_width_range_t %s[] = {' % name]
+
+    for start, end in values:
+        lines.append('    { 0x%05X, 0x%05X },' % (start, end))
+
+    lines.append('};')
+
+    return '\n'.join(lines)
+
+def main():
+    with open(__file__) as f:
+        license = [line[2:].rstrip() for line in f.readlines()[2:21]]
+
+    print('/*')
+    print('\n'.join((' * ' + line).rstrip() for line in license))
+    print(' */')
+    print()
+    print('/*')
+    print(' * This file is generated by scripts/width.py from Unicode %s. Do not' %
+          unicodedata.unidata_version)
+    print(' * edit it manually.')
+    print(' */')
+    print()
+    print('#ifndef __kmnd_width_table_h')
+    print('#define __kmnd_width_table_h')
+    print()
+    print(table('kmnd_width_zero', ranges(is_zero)))
+    print()
+    print(table('kmnd_width_wide', ranges(is_wide)))
+    print()
+    print('#endif /* __kmnd_width_table_h */')
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "core.h"
+
+#define KMND_ARENA_BLOCK_SIZE 16384
+
+static void *kmnd_malloc_allocate(void *context, const size_t size) {
+    (void) context;
+
+    return malloc(size);
+}
+
+static void kmnd_malloc_release(void *context, void *pointer) {
+    (void) context;
+
+    free(pointer);
+}
+
+static const kmnd_allocator_t kmnd_allocator_default = {
+    kmnd_malloc_allocate, kmnd_malloc_release, NULL
+};
+
+static KMND_THREAD_LOCAL const kmnd_allocator_t *kmnd_allocator_thread = NULL;
+
+const kmnd_allocator_t *kmnd_allocator_use(const kmnd_allocator_t *allocator) {
+    const kmnd_allocator_t *previous = kmnd_allocator_current();
+
+    kmnd_allocator_thread = allocator;
+
+    return previous;
+}
+
+const kmnd_allocator_t *kmnd_allocator_current(void) {
+    if (kmnd_allocator_thread == NULL)
+        return &kmnd_allocator_default;
+
+    return kmnd_allocator_thread;
+}
+
+void *kmnd_allocate(const kmnd_allocator_t *allocator, const size_t size) {
+    if (size == 0)
+        return NULL;
+
+    void *pointer = allocator->allocate(allocator->context, size);
+
+    if (pointer != NULL)
+        memset(pointer, 0, size);
+
+    return pointer;
+}
+
+void kmnd_release(const kmnd_allocator_t *allocator, void *pointer) {
+    if (pointer != NULL && allocator->release != NULL)
+        allocator->release(allocator->context, pointer);
+}
+
+char *kmnd_duplicate(const kmnd_allocator_t *allocator, const char *string) {
+    const size_t length = strlen(string);
+    char *copy = allocator->allocate(allocator->context, length + 1);
+
+    if (copy != NULL)
+        memcpy(copy, string, length + 1);
+
+    return copy;
+}
+
+/** -- Arenas -- */
+
+typedef struct kmnd_arena_block_s kmnd_arena_block_t;
+
+struct kmnd_arena_block_s {
+    kmnd_arena_block_t *next;
+
+    size_t size;
+    size_t used;
+};
+
+struct kmnd_arena_s {
+    kmnd_allocator_t allocator;
+
+    /* The first block is the one that memory is allocated from. */
+    kmnd_arena_block_t *blocks;
+    size_t block_size;
+};
+
+#define KMND_ARENA_HEADER KMND_ARENA_ALIGN(sizeof(kmnd_arena_block_t))
+
+static void *kmnd_arena_allocate(void *context, const size_t size) {
+    kmnd_arena_t *arena = context;
+    kmnd_arena_block_t *block = arena->blocks;
+
+    const size_t aligned = KMND_ARENA_ALIGN(size);
+
+    if (block == NULL || block->size - block->used < aligned) {
+        const size_t block_size = aligned > arena->block_size ?
+                                  aligned : arena->block_size;
+
+        kmnd_arena_block_t *next = malloc(KMND_ARENA_HEADER + block_size);
+
+        if (next == NULL)
+            return NULL;
+
+        next->size = block_size;
+        next->used = 0;
+
+        /* Memory keeps being allocated from the current block if it has more
+         * room left than the new one will have (e.g. for large sizes). */
+        if (block != NULL &&
+            block->size - block->used > block_size - aligned) {
+            next->next = block->next;
+            block->next = next;
+        }else {
+            next->next = block;
+            arena->blocks = next;
+        }
+
+        block = next;
+    }
+
+    void *pointer = (char *) block + KMND_ARENA_HEADER + block->used;
+    block->used += aligned;
+
+    return pointer;
+}
+
+kmnd_arena_t *kmnd_arena_new(const size_t block_size) {
+    kmnd_arena_t *arena = malloc(sizeof(kmnd_arena_t));
+
+    if (arena == NULL)
+        return NULL;
+
+    memset(arena, 0, sizeof(kmnd_arena_t));
+
+    arena->allocator.allocate = kmnd_arena_allocate;
+    arena->allocator.release = NULL;
+    arena->allocator.context = arena;
+
+    arena->block_size = block_size ? KMND_ARENA_ALIGN(block_size) :
+                                     KMND_ARENA_BLOCK_SIZE;
+
+    return arena;
+}
+
+const kmnd_allocator_t *kmnd_arena_allocator(kmnd_arena_t *arena) {
+    return &arena->allocator;
+}
+
+void kmnd_arena_free(kmnd_arena_t *arena) {
+    kmnd_arena_block_t *block = arena->blocks;
+
+    while (block != NULL) {
+        kmnd_arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    memset(arena, 0, sizeof(kmnd_arena_t));
+    free(arena);
+}
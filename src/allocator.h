@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_allocator_h
+#define __kmnd_allocator_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <kmnd.h>
+#include <stddef.h>
+
+/*
+ * Memory from an arena is aligned to this number of bytes, which is enough for
+ * any type that kmnd stores. KMND_ARENA_ALIGN returns the number of bytes that
+ * an allocation of the given size takes up in an arena.
+ */
+#define KMND_ARENA_ALIGNMENT 16
+
+#define KMND_ARENA_ALIGN(x) \
+    (((x) + KMND_ARENA_ALIGNMENT - 1) & ~((size_t) KMND_ARENA_ALIGNMENT - 1))
+
+/**
+ * This function returns the allocator that new nodes are allocated with in
+ * this thread (see kmnd_allocator_use).
+ */
+const kmnd_allocator_t *kmnd_allocator_current(void);
+
+/**
+ * This function allocates `size` bytes of zeroed memory with the given
+ * allocator. It returns NULL if `size` is 0 or the memory could not be
+ * allocated.
+ */
+void *kmnd_allocate(const kmnd_allocator_t *allocator, const size_t size);
+
+/**
+ * This function releases memory that was allocated with the given allocator.
+ * It does nothing if the allocator only releases memory all at once.
+ */
+void kmnd_release(const kmnd_allocator_t *allocator, void *pointer);
+
+/**
+ * This function returns a copy of the given string that is allocated with the
+ * given allocator, or NULL if it could not be allocated.
+ */
+char *kmnd_duplicate(const kmnd_allocator_t *allocator, const char *string);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_allocator_h */
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "allocator.h"
+#include "args.h"
+#include "command.h"
+#include "line.h"
+
+/*
+ * Pages of a response file that were read are given back to the system in
+ * steps of at least this many bytes.
+ */
+#define KMND_ARGS_RELEASE_SIZE (1 << 20)
+
+void kmnd_args_init(kmnd_args_t *args, const kmnd_allocator_t *allocator,
+                    kmnd_args_mapping_t **mappings, const int argc,
+                    const char **argv) {
+    memset(args, 0, sizeof(kmnd_args_t));
+
+    args->argv = argv;
+    args->argc = argc;
+    args->index = 1;
+    args->allocator = allocator;
+    args->mappings = mappings;
+}
+
+/*
+ * This function maps the response file at the given path. It returns -1 if the
+ * file cannot be read.
+ */
+static int kmnd_args_open(kmnd_args_file_t *file, const char *path) {
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return -1;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return -1;
+    }
+
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+
+    memset(file, 0, sizeof(kmnd_args_file_t));
+    file->size = (size_t) info.st_size;
+    file->mapped = (file->size + 1 + page - 1) / page * page;
+
+    /* The file is mapped over anonymous memory that is one byte larger, so
+     * there is a zero byte after the last argument even if the size of the
+     * file is a multiple of the page size. */
+    void *data = mmap(NULL, file->mapped, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (data == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    if (file->size > 0 &&
+        mmap(data, file->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+             fd, 0) == MAP_FAILED) {
+        munmap(data, file->mapped);
+        close(fd);
+        return -1;
+    }
+
+    close(fd);
+
+    if (file->size > 0)
+        madvise(data, file->size, MADV_SEQUENTIAL);
+
+    file->data = data;
+
+    return 0;
+}
+
+/*
+ * This function closes the given response file. It remains mapped if any of
+ * its arguments is borrowed.
+ */
+static void kmnd_args_close(kmnd_args_t *args, kmnd_args_file_t *file) {
+    if (file->keep) {
+        kmnd_args_mapping_t *mapping =
+            kmnd_allocate(args->allocator, sizeof(kmnd_args_mapping_t));
+
+        /* If the mapping cannot be recorded, it is better to never unmap it
+         * than to unmap borrowed arguments. */
+        if (mapping != NULL) {
+            mapping->data = file->data;
+            mapping->size = file->mapped;
+            mapping->next = *args->mappings;
+            *args->mappings = mapping;
+        }
+
+        return;
+    }
+
+    munmap(file->data, file->mapped);
+}
+
+/*
+ * This function gives the pages of the response file that were read back to
+ * the system, unless its arguments are borrowed.
+ */
+static void kmnd_args_discard(kmnd_args_file_t *file) {
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    const size_t end = file->position / page * page;
+
+    if (file->keep || end < file->released + KMND_ARGS_RELEASE_SIZE)
+        return;
+
+    madvise(file->data + file->released, end - file->released,
+            MADV_DONTNEED);
+
+    file->released = end;
+}
+
+const char *kmnd_args_next(kmnd_args_t *args, const kmnd_command_t *command) {
+    const unsigned char borrow =
+        args->borrow || kmnd_command_borrows(command);
+
+    for (;;) {
+        const char *arg = NULL;
+
+        if (args->depth > 0) {
+            kmnd_args_file_t *file = &args->files[args->depth - 1];
+            kmnd_args_discard(file);
+
+            char *argument = NULL;
+            size_t size = 0;
+
+            int res = kmnd_line_next(file->data, file->size, &file->position,
+                                     &argument, &size);
+
+            if (res == -1) {
+                kmnd_error_init_unterminated_quote(&args->error);
+                return NULL;
+            }
+
+            if (res == 1) {
+                kmnd_args_close(args, file);
+                args->depth --;
+                continue;
+            }
+
+            /* This is within the file or in the zero byte after it. */
+            argument[size] = '\0';
+            arg = argument;
+
+            if (borrow)
+                file->keep = 1;
+        }else if (args->index < args->argc)
+            arg = args->argv[args->index ++];
+        else
+            return NULL;
+
+        if (arg[0] != '@' || arg[1] == '\0' ||
+            !kmnd_command_expands(command))
+            return arg;
+
+        if (args->depth == KMND_ARGS_MAX_DEPTH) {
+            kmnd_error_init_nested_response_file(&args->error, arg);
+            return NULL;
+        }
+
+        /* Like other tools, a response file that cannot be read is passed on
+         * as a regular argument. */
+        if (kmnd_args_open(&args->files[args->depth], arg + 1) != 0)
+            return arg;
+
+        args->depth ++;
+    }
+}
+
+void kmnd_args_release(kmnd_args_t *args) {
+    while (args->depth > 0)
+        kmnd_args_close(args, &args->files[-- args->depth]);
+}
+
+void kmnd_args_unmap(const kmnd_allocator_t *allocator,
+                     kmnd_args_mapping_t **mappings) {
+    while (*mappings != NULL) {
+        kmnd_args_mapping_t *mapping = *mappings;
+        *mappings = mapping->next;
+
+        munmap(mapping->data, mapping->size);
+        kmnd_release(allocator, mapping);
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_args_h
+#define __kmnd_args_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "error.h"
+
+struct kmnd_allocator_s;
+struct kmnd_command_s;
+
+/*
+ * This is the maximum number of response files that can be open at the same
+ * time, i.e. the maximum depth of response files that refer to other response
+ * files.
+ */
+#define KMND_ARGS_MAX_DEPTH 16
+
+/*
+ * A mapping is a response file that remains mapped after its arguments were
+ * read, because values borrow them (see kmnd_borrow). Mappings are kept by the
+ * root command until its tree is reset or freed, or by a result until it is
+ * reset or freed.
+ */
+typedef struct kmnd_args_mapping_s kmnd_args_mapping_t;
+
+struct kmnd_args_mapping_s {
+    char *data;
+    size_t size;
+
+    kmnd_args_mapping_t *next;
+};
+
+typedef struct kmnd_args_file_s {
+    /* The file is mapped privately and followed by at least one zero byte, so
+     * arguments are split and terminated in place. `size` is the size of the
+     * file and `mapped` the size of the mapping. */
+    char *data;
+    size_t size;
+    size_t mapped;
+
+    /* This is where the next argument starts. Pages before `released` have
+     * been given back to the system. */
+    size_t position;
+    size_t released;
+
+    /* This is set once an argument of the file is read by a command whose
+     * values borrow their arguments. */
+    unsigned char keep;
+} kmnd_args_file_t;
+
+/*
+ * An argument iterator returns the arguments that are passed to kmnd_run one at
+ * a time, and expands `@path` arguments into the arguments in the file at that
+ * path (see kmnd_response_files) as they are reached.
+ */
+typedef struct kmnd_args_s {
+    const char **argv;
+    int argc;
+    int index;
+
+    /* Mappings are recorded in this list and allocated with this allocator.
+     * If `borrow` is set, all arguments are borrowed regardless of the
+     * command. */
+    const struct kmnd_allocator_s *allocator;
+    kmnd_args_mapping_t **mappings;
+    unsigned char borrow;
+
+    kmnd_args_file_t files[KMND_ARGS_MAX_DEPTH];
+    size_t depth;
+
+    /* This is set if the iterator stopped because of an error. */
+    kmnd_error_t error;
+} kmnd_args_t;
+
+/*
+ * This function prepares an iterator for the given arguments (of which the
+ * first is skipped). Response files that remain mapped are added to the given
+ * list.
+ */
+void kmnd_args_init(kmnd_args_t *args,
+                    const struct kmnd_allocator_s *allocator,
+                    kmnd_args_mapping_t **mappings, const int argc,
+                    const char **argv);
+
+/*
+ * This function returns the next argument for the given command, which remains
+ * valid until the next call. It returns NULL if there are no arguments left or
+ * if an error occurred, which is then stored in `args->error`.
+ */
+const char *kmnd_args_next(kmnd_args_t *args,
+                           const struct kmnd_command_s *command);
+
+/*
+ * This function closes the response files that are still open.
+ */
+void kmnd_args_release(kmnd_args_t *args);
+
+/*
+ * This function unmaps the response files in the given list, which were
+ * recorded with the given allocator.
+ */
+void kmnd_args_unmap(const struct kmnd_allocator_s *allocator,
+                     kmnd_args_mapping_t **mappings);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_args_h */
@@ -0,0 +1,574 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "allocator.h"
+#include "batch.h"
+#include "command.h"
+#include "error.h"
+#include "line.h"
+#include "number.h"
+#include "terminal.h"
+
+typedef struct kmnd_batch_line_s {
+    const char *string;
+    size_t length;
+
+    /* This is the output of the line if it finished before the lines before
+     * it, which is written once they have finished as well. */
+    char *output;
+    size_t output_length;
+
+    int code;
+    unsigned char done;
+} kmnd_batch_line_t;
+
+typedef struct kmnd_batch_s kmnd_batch_t;
+
+/*
+ * Each worker owns a range of lines, which it takes from the front. A worker
+ * that runs out of lines steals the second half of the range of another
+ * worker.
+ */
+typedef struct kmnd_batch_worker_s {
+    kmnd_batch_t *batch;
+    size_t index;
+
+    pthread_mutex_t lock;
+    size_t begin;
+    size_t end;
+
+    pthread_t thread;
+} kmnd_batch_worker_t;
+
+struct kmnd_batch_s {
+    kmnd_command_t *command;
+
+    /* Workers allocate with the allocator of the tree through this allocator,
+     * which only lets one of them do so at a time. */
+    kmnd_allocator_t allocator;
+    pthread_mutex_t allocator_lock;
+
+    kmnd_batch_line_t *lines;
+    size_t num_lines;
+
+    kmnd_batch_worker_t *workers;
+    size_t num_workers;
+
+    /* This is the terminal that the output of all lines is written to, in
+     * order. The lock guards the lines and `next`, which is the first line
+     * that has not been written yet. */
+    kmnd_terminal_t *terminal;
+    pthread_mutex_t lock;
+    size_t next;
+};
+
+static void *kmnd_batch_allocate(void *context, const size_t size) {
+    kmnd_batch_t *batch = context;
+    const kmnd_allocator_t *allocator = batch->command->core.allocator;
+
+    pthread_mutex_lock(&batch->allocator_lock);
+    void *pointer = allocator->allocate(allocator->context, size);
+    pthread_mutex_unlock(&batch->allocator_lock);
+
+    return pointer;
+}
+
+static void kmnd_batch_release(void *context, void *pointer) {
+    kmnd_batch_t *batch = context;
+
+    pthread_mutex_lock(&batch->allocator_lock);
+    kmnd_release(batch->command->core.allocator, pointer);
+    pthread_mutex_unlock(&batch->allocator_lock);
+}
+
+/*
+ * This function returns whether the given line has no arguments, i.e. whether
+ * it is empty or only contains blanks or a comment.
+ */
+static unsigned char kmnd_batch_blank(const char *string, const size_t length) {
+    size_t i;
+    for (i = 0; i < length; i ++) {
+        if (string[i] == '#')
+            return 1;
+
+        if (string[i] != ' ' && string[i] != '\t' && string[i] != '\r' &&
+            string[i] != '\0')
+            return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * This function splits the given file into lines. It returns -1 if memory
+ * could not be allocated.
+ */
+static int kmnd_batch_split(kmnd_batch_t *batch, const char *data,
+                            const size_t size) {
+    const kmnd_allocator_t *allocator = batch->command->core.allocator;
+
+    size_t num_lines = 0;
+    const char *start = data, *end = data + size;
+
+    while (start < end) {
+        const char *newline = memchr(start, '\n', (size_t) (end - start));
+
+        num_lines ++;
+        start = (newline != NULL) ? newline + 1 : end;
+    }
+
+    if (num_lines == 0)
+        return 0;
+
+    batch->lines = kmnd_allocate(allocator, num_lines *
+                                            sizeof(kmnd_batch_line_t));
+
+    if (batch->lines == NULL)
+        return -1;
+
+    batch->num_lines = num_lines;
+
+    size_t i = 0;
+    start = data;
+
+    while (start < end) {
+        const char *newline = memchr(start, '\n', (size_t) (end - start));
+        const char *stop = (newline != NULL) ? newline : end;
+
+        batch->lines[i].string = start;
+        batch->lines[i].length = (size_t) (stop - start);
+        i ++;
+
+        start = (newline != NULL) ? newline + 1 : end;
+    }
+
+    return 0;
+}
+
+/*
+ * This function takes the next line for the given worker, stealing lines from
+ * other workers if it has none left. It returns 0 if all lines were taken.
+ */
+static int kmnd_batch_take(kmnd_batch_worker_t *worker, size_t *index) {
+    pthread_mutex_lock(&worker->lock);
+
+    if (worker->begin < worker->end) {
+        *index = worker->begin ++;
+        pthread_mutex_unlock(&worker->lock);
+        return 1;
+    }
+
+    pthread_mutex_unlock(&worker->lock);
+
+    kmnd_batch_t *batch = worker->batch;
+
+    size_t k;
+    for (k = 1; k < batch->num_workers; k ++) {
+        kmnd_batch_worker_t *victim =
+            &batch->workers[(worker->index + k) % batch->num_workers];
+
+        pthread_mutex_lock(&victim->lock);
+
+        const size_t remaining = victim->end - victim->begin;
+
+        if (remaining == 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+
+        const size_t begin = victim->end - (remaining + 1) / 2,
+                     end = victim->end;
+
+        victim->end = begin;
+
+        pthread_mutex_unlock(&victim->lock);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->begin = begin + 1;
+        worker->end = end;
+        pthread_mutex_unlock(&worker->lock);
+
+        *index = begin;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * This function records that the given line has finished with the output in
+ * the given terminal, and writes the output of all lines that can be written
+ * in order.
+ */
+static void kmnd_batch_finish(kmnd_batch_t *batch, const size_t index,
+                              const int code, kmnd_terminal_t *terminal) {
+    size_t length = 0;
+    const char *output = kmnd_terminal_output(terminal, &length);
+
+    pthread_mutex_lock(&batch->lock);
+
+    kmnd_batch_line_t *line = &batch->lines[index];
+    line->code = code;
+    line->done = 1;
+
+    if (index != batch->next) {
+        /* The output is lost if it cannot be kept, but the line still
+         * counts. */
+        if (length > 0) {
+            line->output = kmnd_allocate(&batch->allocator, length);
+
+            if (line->output != NULL) {
+                memcpy(line->output, output, length);
+                line->output_length = length;
+            }
+        }
+
+        pthread_mutex_unlock(&batch->lock);
+        return;
+    }
+
+    kmnd_terminal_raw(batch->terminal, output, length);
+    batch->next ++;
+
+    while (batch->next < batch->num_lines &&
+           batch->lines[batch->next].done) {
+        line = &batch->lines[batch->next ++];
+
+        kmnd_terminal_raw(batch->terminal, line->output, line->output_length);
+
+        kmnd_release(&batch->allocator, line->output);
+        line->output = NULL;
+    }
+
+    kmnd_terminal_flush(batch->terminal);
+
+    pthread_mutex_unlock(&batch->lock);
+}
+
+/*
+ * This function runs a single line against the frozen tree and returns its
+ * exit code, which is the same as that of kmnd_run_line.
+ */
+static int kmnd_batch_line(kmnd_command_t *command, kmnd_line_t *line,
+                           kmnd_result_t *result,
+                           const kmnd_batch_line_t *batch_line) {
+    if (kmnd_batch_blank(batch_line->string, batch_line->length))
+        return 0;
+
+    int argc = 0;
+    int res = kmnd_line_split(line, batch_line->string, batch_line->length,
+                              command->core.name, &argc);
+
+    if (res == -1)
+        return -1;
+
+    if (res == -2) {
+        kmnd_line_report(command);
+        return -1;
+    }
+
+    if (kmnd_parse((kmnd_t *) command, argc, line->argv, result) != 0) {
+        kmnd_result_report(result);
+        return -1;
+    }
+
+    return kmnd_result_run(result);
+}
+
+static void *kmnd_batch_work(void *context) {
+    kmnd_batch_worker_t *worker = context;
+    kmnd_batch_t *batch = worker->batch;
+
+    kmnd_line_t line;
+    memset(&line, 0, sizeof(kmnd_line_t));
+    line.allocator = &batch->allocator;
+
+    const kmnd_allocator_t *allocator = kmnd_allocator_use(&batch->allocator);
+    kmnd_result_t *result = kmnd_result_new((kmnd_t *) batch->command);
+    kmnd_allocator_use(allocator);
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new_memory();
+
+    /* The output of each line is rendered in memory as if it were written to
+     * the terminal of the batch directly. */
+    if (result != NULL && terminal != NULL) {
+        terminal->num_columns = kmnd_terminal_columns(batch->terminal);
+        terminal->supports_formatting = batch->terminal->supports_formatting;
+
+        kmnd_terminal_t *previous = kmnd_command_redirect(terminal);
+
+        size_t index;
+        while (kmnd_batch_take(worker, &index)) {
+            const int code = kmnd_batch_line(batch->command, &line, result,
+                                             &batch->lines[index]);
+
+            kmnd_batch_finish(batch, index, code, terminal);
+            kmnd_terminal_output_clear(terminal);
+        }
+
+        kmnd_command_redirect(previous);
+    }
+
+    if (terminal != NULL)
+        kmnd_terminal_free(terminal);
+
+    if (result != NULL)
+        kmnd_result_free(result);
+
+    kmnd_line_release(&line);
+
+    return NULL;
+}
+
+/*
+ * This function runs the lines of the batch on the given number of threads
+ * (including the calling thread, which is the only one if `jobs` is 1). It
+ * returns -1 if memory could not be allocated.
+ */
+static int kmnd_batch_workers(kmnd_batch_t *batch, const size_t jobs) {
+    const kmnd_allocator_t *allocator = batch->command->core.allocator;
+
+    /* Every line starts from the initial values of the options, rather than
+     * from the values that a previous kmnd_run left behind. */
+    kmnd_command_reset(kmnd_command_root(batch->command));
+
+    if (kmnd_freeze((kmnd_t *) batch->command) != 0)
+        return -1;
+
+    batch->workers = kmnd_allocate(allocator,
+                                   jobs * sizeof(kmnd_batch_worker_t));
+
+    if (batch->workers == NULL)
+        return -1;
+
+    batch->num_workers = jobs;
+    batch->terminal = kmnd_command_terminal(batch->command);
+
+    size_t i;
+    for (i = 0; i < jobs; i ++) {
+        kmnd_batch_worker_t *worker = &batch->workers[i];
+
+        worker->batch = batch;
+        worker->index = i;
+        worker->begin = i * batch->num_lines / jobs;
+        worker->end = (i + 1) * batch->num_lines / jobs;
+
+        pthread_mutex_init(&worker->lock, NULL);
+    }
+
+    /* Workers that cannot be started leave their lines to the others. */
+    unsigned char *started = kmnd_allocate(allocator, jobs);
+
+    for (i = 1; i < jobs && started != NULL; i ++) {
+        started[i] = (unsigned char) (pthread_create(&batch->workers[i].thread,
+                                                     NULL, kmnd_batch_work,
+                                                     &batch->workers[i]) == 0);
+    }
+
+    kmnd_batch_work(&batch->workers[0]);
+
+    for (i = 1; i < jobs; i ++) {
+        if (started != NULL && started[i])
+            pthread_join(batch->workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < jobs; i ++)
+        pthread_mutex_destroy(&batch->workers[i].lock);
+
+    kmnd_release(allocator, started);
+    kmnd_release(allocator, batch->workers);
+
+    return 0;
+}
+
+/*
+ * This function stores the exit codes of the lines of the batch in the
+ * command. Lines that were never run (because memory could not be allocated)
+ * failed. It returns the number of lines that failed.
+ */
+static int kmnd_batch_codes(kmnd_batch_t *batch) {
+    kmnd_command_t *command = batch->command;
+    const kmnd_allocator_t *allocator = command->core.allocator;
+
+    kmnd_release(allocator, command->batch_codes);
+    command->num_batch_codes = 0;
+    command->batch_codes = kmnd_allocate(allocator, batch->num_lines *
+                                                    sizeof(int));
+
+    if (command->batch_codes != NULL)
+        command->num_batch_codes = batch->num_lines;
+
+    size_t i, num_failures = 0;
+    for (i = 0; i < batch->num_lines; i ++) {
+        const kmnd_batch_line_t *line = &batch->lines[i];
+        const int code = line->done ? line->code : -1;
+
+        if (code != 0)
+            num_failures ++;
+
+        if (command->batch_codes != NULL)
+            command->batch_codes[i] = code;
+
+        kmnd_release(allocator, line->output);
+    }
+
+    return (int) num_failures;
+}
+
+int kmnd_run_batch(kmnd_t *kmnd, const char *path, const size_t jobs,
+                   const int **codes, size_t *num_lines) {
+    kmnd_command_t *command = (kmnd_command_t *) kmnd;
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return -1;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    const size_t size = (size_t) info.st_size;
+    void *data = NULL;
+
+    if (size > 0) {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+
+    close(fd);
+
+    kmnd_batch_t batch;
+    memset(&batch, 0, sizeof(kmnd_batch_t));
+    batch.command = command;
+    batch.allocator.allocate = kmnd_batch_allocate;
+    batch.allocator.release = kmnd_batch_release;
+    batch.allocator.context = &batch;
+
+    pthread_mutex_init(&batch.allocator_lock, NULL);
+    pthread_mutex_init(&batch.lock, NULL);
+
+    size_t num_threads = jobs;
+
+    if (num_threads == 0) {
+        long num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = (num_processors > 0) ? (size_t) num_processors : 1;
+    }
+
+    int res = kmnd_batch_split(&batch, data, size);
+
+    if (num_threads > batch.num_lines)
+        num_threads = batch.num_lines;
+
+    /* Lines of a batch are not treated as batches themselves. */
+    const unsigned char batching = command->batching;
+    command->batching = 1;
+
+    if (res == 0 && num_threads > 0)
+        res = kmnd_batch_workers(&batch, num_threads);
+
+    command->batching = batching;
+
+    const int num_failures = kmnd_batch_codes(&batch);
+
+    kmnd_release(command->core.allocator, batch.lines);
+
+    pthread_mutex_destroy(&batch.lock);
+    pthread_mutex_destroy(&batch.allocator_lock);
+
+    if (data != NULL)
+        munmap(data, size);
+
+    if (codes != NULL)
+        *codes = command->batch_codes;
+
+    if (num_lines != NULL)
+        *num_lines = command->num_batch_codes;
+
+    if (res != 0)
+        return -1;
+
+    return num_failures;
+}
+
+int kmnd_batch_arguments(kmnd_command_t *command, const int argc,
+                         const char **argv, int *res) {
+    const char *path = NULL, *jobs = NULL;
+
+    int i;
+    for (i = 1; i < argc; i ++) {
+        if (strncmp(argv[i], "--batch=", 8) == 0)
+            path = argv[i] + 8;
+        else if (strncmp(argv[i], "--jobs=", 7) == 0)
+            jobs = argv[i] + 7;
+        else if (argv[i][0] != '\0')
+            return 0;
+    }
+
+    if (path == NULL)
+        return 0;
+
+    kmnd_error_t error;
+    uint64_t num_jobs = 1;
+
+    if (jobs != NULL &&
+        kmnd_number_parse_unsigned(jobs, strlen(jobs), SIZE_MAX,
+                                   &num_jobs) != 0) {
+        kmnd_error_init_invalid_value(&error, "jobs", jobs);
+    }else {
+        int num_failures = kmnd_run_batch((kmnd_t *) command, path,
+                                          (size_t) num_jobs, NULL, NULL);
+
+        if (num_failures >= 0) {
+            *res = (num_failures == 0) ? 0 : -1;
+            return 1;
+        }
+
+        kmnd_error_init_invalid_value(&error, "batch", path);
+    }
+
+    kmnd_error_print(&error, (kmnd_t *) command);
+
+    if (command->usage != NULL)
+        kmnd_usage_print(command->usage, command);
+
+    *res = -1;
+
+    return 1;
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <link.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+
+#define KMND_CACHE_MAGIC "kmnd\0\0\0\1"
+
+/*
+ * Every cache file starts with this header. It is used to make sure that the
+ * file belongs to the same key and has not been truncated.
+ */
+typedef struct kmnd_cache_header_s {
+    char magic[8];
+    kmnd_cache_key_t key;
+    uint64_t length;
+} kmnd_cache_header_t;
+
+uint64_t kmnd_cache_hash_init(void) {
+    return 14695981039346656037ULL;
+}
+
+uint64_t kmnd_cache_hash(uint64_t hash, const char *string) {
+    /* The terminating \0 is included to separate consecutive strings. */
+    do {
+        hash ^= (unsigned char) *string;
+        hash *= 1099511628211ULL;
+    } while (*string ++ != '\0');
+
+    return hash;
+}
+
+#ifdef __linux__
+
+static int kmnd_cache_build_id_callback(struct dl_phdr_info *info,
+                                        size_t size, void *data) {
+    char *build_id = (char *) data;
+
+    int i;
+    for (i = 0; i < info->dlpi_phnum; i ++) {
+        const ElfW(Phdr) *header = &info->dlpi_phdr[i];
+
+        if (header->p_type != PT_NOTE)
+            continue;
+
+        const char *note = (const char *) (info->dlpi_addr + header->p_vaddr);
+        const char *end = note + header->p_memsz;
+
+        while (note + sizeof(ElfW(Nhdr)) <= end) {
+            const ElfW(Nhdr) *entry = (const ElfW(Nhdr) *) note;
+            const char *name = note + sizeof(ElfW(Nhdr));
+            const char *desc = name + ((entry->n_namesz + 3) & ~3u);
+
+            if (entry->n_type == NT_GNU_BUILD_ID && entry->n_namesz == 4 &&
+                memcmp(name, "GNU", 4) == 0 && entry->n_descsz <= 64) {
+                static const char digits[] = "0123456789abcdef";
+
+                size_t j;
+                for (j = 0; j < entry->n_descsz; j ++) {
+                    const unsigned char byte = (unsigned char) desc[j];
+                    build_id[j * 2] = digits[byte >> 4];
+                    build_id[j * 2 + 1] = digits[byte & 15];
+                }
+
+                build_id[j * 2] = '\0';
+
+                return 1;
+            }
+
+            note = desc + ((entry->n_descsz + 3) & ~3u);
+        }
+    }
+
+    /* The first object is the binary itself, so we stop here. */
+    return 1;
+}
+
+#endif /* __linux__ */
+
+static char kmnd_cache_build_id_string[129];
+
+static void kmnd_cache_read_build_id(void) {
+#ifdef __linux__
+    dl_iterate_phdr(kmnd_cache_build_id_callback, kmnd_cache_build_id_string);
+#endif
+}
+
+/*
+ * This function returns the build-id of the binary as a hexadecimal string or
+ * NULL if it has none.
+ */
+static const char *kmnd_cache_build_id(void) {
+    /* Usage text may be printed on several threads at once, which must not
+     * see the build-id before it is complete. */
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+    pthread_once(&once, kmnd_cache_read_build_id);
+
+    return kmnd_cache_build_id_string[0] != '\0' ?
+           kmnd_cache_build_id_string : NULL;
+}
+
+/*
+ * This function writes the cache directory to `path`. If `create` is true,
+ * the directories are created if they do not exist yet.
+ */
+static int kmnd_cache_directory(char *path, const size_t size,
+                                const unsigned char create) {
+    const char *build_id = kmnd_cache_build_id();
+
+    if (build_id == NULL)
+        return -1;
+
+    const char *base = getenv("XDG_CACHE_HOME");
+    int res;
+
+    if (base != NULL && base[0] == '/')
+        res = snprintf(path, size, "%s", base);
+    else if ((base = getenv("HOME")) != NULL && base[0] == '/')
+        res = snprintf(path, size, "%s/.cache", base);
+    else
+        return -1;
+
+    const char *components[] = { "kmnd", build_id };
+    size_t length = 0;
+
+    size_t i;
+    for (i = 0; i <= 2; i ++) {
+        if (res < 0 || (size_t) res >= size - length)
+            return -1;
+
+        length += (size_t) res;
+
+        if (create && mkdir(path, 0700) != 0 && errno != EEXIST)
+            return -1;
+
+        if (i < 2)
+            res = snprintf(path + length, size - length, "/%s",
+                           components[i]);
+    }
+
+    return 0;
+}
+
+int kmnd_cache_path(const kmnd_cache_key_t *key, char *path,
+                    const size_t size) {
+    if (kmnd_cache_directory(path, size, 0) != 0)
+        return -1;
+
+    const size_t length = strlen(path);
+
+    const int res = snprintf(path + length, size - length, "/%016llx-%u-%u",
+                             (unsigned long long) key->hash,
+                             (unsigned int) key->num_columns,
+                             (unsigned int) key->formatting);
+
+    if (res < 0 || (size_t) res >= size - length)
+        return -1;
+
+    return 0;
+}
+
+int kmnd_cache_load(const char *path, const kmnd_cache_key_t *key,
+                    kmnd_terminal_t *terminal) {
+    const int fd = open(path, O_RDONLY);
+
+    if (fd == -1)
+        return -1;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 ||
+        (size_t) info.st_size <= sizeof(kmnd_cache_header_t)) {
+        close(fd);
+        return -1;
+    }
+
+    const size_t size = (size_t) info.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return -1;
+
+    const kmnd_cache_header_t *header = (const kmnd_cache_header_t *) map;
+
+    int res = -1;
+
+    if (memcmp(header->magic, KMND_CACHE_MAGIC, 8) == 0 &&
+        header->key.hash == key->hash &&
+        header->key.num_columns == key->num_columns &&
+        header->key.formatting == key->formatting &&
+        header->length == size - sizeof(kmnd_cache_header_t)) {
+        kmnd_terminal_raw(terminal, (const char *) (header + 1),
+                          (size_t) header->length);
+        kmnd_terminal_flush(terminal);
+
+        res = 0;
+    }
+
+    munmap(map, size);
+
+    return res;
+}
+
+void kmnd_cache_store(const char *path, const kmnd_cache_key_t *key,
+                      const char *data, const size_t length) {
+    char directory[4096];
+
+    if (kmnd_cache_directory(directory, sizeof(directory), 1) != 0)
+        return;
+
+    /* We write to a temporary file first and then atomically move it into
+     * place, so that readers never see a partially written file. The name of
+     * the temporary file is unique, since several threads (or processes) may
+     * store the same usage text at once. */
+    char temporary[4096 + 32];
+    snprintf(temporary, sizeof(temporary), "%s.XXXXXX", path);
+
+    const int fd = mkstemp(temporary);
+
+    if (fd == -1)
+        return;
+
+    kmnd_cache_header_t header;
+    memset(&header, 0, sizeof(kmnd_cache_header_t));
+
+    memcpy(header.magic, KMND_CACHE_MAGIC, 8);
+    header.key = *key;
+    header.length = length;
+
+    const char *parts[2] = { (const char *) &header, data };
+    const size_t sizes[2] = { sizeof(kmnd_cache_header_t), length };
+
+    int failed = 0;
+
+    size_t i;
+    for (i = 0; i < 2 && !failed; i ++) {
+        size_t written = 0;
+
+        while (written < sizes[i]) {
+            const ssize_t res = write(fd, parts[i] + written,
+                                      sizes[i] - written);
+
+            if (res < 0 && errno == EINTR)
+                continue;
+
+            if (res <= 0) {
+                failed = 1;
+                break;
+            }
+
+            written += (size_t) res;
+        }
+    }
+
+    if (close(fd) != 0 || failed || rename(temporary, path) != 0)
+        unlink(temporary);
+}
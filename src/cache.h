@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_cache_h
+#define __kmnd_cache_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "terminal.h"
+
+typedef struct kmnd_cache_key_s kmnd_cache_key_t;
+
+/*
+ * Rendered output is cached per key. The key consists of a hash of the command
+ * path and the properties of the terminal that affect the output.
+ */
+struct kmnd_cache_key_s {
+    uint64_t hash;
+    uint32_t num_columns;
+    uint32_t formatting;
+};
+
+/**
+ * This function returns the initial hash of a cache key.
+ */
+uint64_t kmnd_cache_hash_init(void);
+
+/**
+ * This function adds the given string to the hash of a cache key.
+ */
+uint64_t kmnd_cache_hash(uint64_t hash, const char *string);
+
+/**
+ * This function writes the path of the cache file for the given key to `path`.
+ * Cache files are stored in $XDG_CACHE_HOME/kmnd (or ~/.cache/kmnd), in a
+ * directory named after the build-id of the binary. It returns -1 if no path
+ * can be determined, e.g. because the binary has no build-id.
+ */
+int kmnd_cache_path(const kmnd_cache_key_t *key, char *path, const size_t size);
+
+/**
+ * This function writes the cached output for the given key to the terminal.
+ * It returns 0 on success and -1 if there is no (valid) cached output.
+ */
+int kmnd_cache_load(const char *path, const kmnd_cache_key_t *key,
+                    kmnd_terminal_t *terminal);
+
+/**
+ * This function stores the given output for the given key. Failures are
+ * ignored: the output will simply be rendered again next time.
+ */
+void kmnd_cache_store(const char *path, const kmnd_cache_key_t *key,
+                      const char *data, const size_t length);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_cache_h */
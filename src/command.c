@@ -21,25 +21,42 @@
  */
 
 #include <assert.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <string.h>
 
+#include "allocator.h"
 #include "command.h"
 
+/*
+ * This is the generation of the command that was created last. Commands may be
+ * created on several threads at once.
+ */
+static unsigned long kmnd_command_last_generation = 0;
+static pthread_mutex_t kmnd_command_generation_lock =
+    PTHREAD_MUTEX_INITIALIZER;
+
+unsigned long kmnd_command_generation(void) {
+    pthread_mutex_lock(&kmnd_command_generation_lock);
+    const unsigned long generation = ++ kmnd_command_last_generation;
+    pthread_mutex_unlock(&kmnd_command_generation_lock);
+
+    return generation;
+}
+
 kmnd_t *kmnd_new(const char *name, const char *description, kmnd_run_cb *run,
                  kmnd_t *child, ...) {
-    kmnd_command_t *kmnd = malloc(sizeof(kmnd_command_t));
+    const kmnd_allocator_t *allocator = kmnd_allocator_current();
+    kmnd_command_t *kmnd = kmnd_allocate(allocator, sizeof(kmnd_command_t));
 
     if (kmnd == NULL)
         return NULL;
 
-    memset(kmnd, 0, sizeof(kmnd_command_t));
-
+    kmnd->core.allocator = allocator;
     kmnd->core.name = name;
     kmnd->core.description = description;
     kmnd->run = run;
-
-    kmnd->terminal = kmnd_terminal_new_default();
+    kmnd->generation = kmnd_command_generation();
 
     /*
      * We will iterate over the arguments twice. Once to count the number of
@@ -74,9 +91,25 @@ kmnd_t *kmnd_new(const char *name, const char *description, kmnd_run_cb *run,
     va_end(arguments);
 
     /* We then allocate memory for all subcommands, options and inputs. */
-    kmnd->commands = calloc(kmnd->num_commands, sizeof(kmnd_command_t *));
-    kmnd->options = calloc(kmnd->num_options, sizeof(kmnd_option_t *));
-    kmnd->inputs = calloc(kmnd->num_inputs, sizeof(kmnd_input_t *));
+    kmnd->commands = kmnd_allocate(allocator, kmnd->num_commands *
+                                              sizeof(kmnd_command_t *));
+    kmnd->options = kmnd_allocate(allocator, kmnd->num_options *
+                                             sizeof(kmnd_option_t *));
+    kmnd->inputs = kmnd_allocate(allocator, kmnd->num_inputs *
+                                            sizeof(kmnd_input_t *));
+
+    if ((kmnd->num_commands > 0 && kmnd->commands == NULL) ||
+        (kmnd->num_options > 0 && kmnd->options == NULL) ||
+        (kmnd->num_inputs > 0 && kmnd->inputs == NULL)) {
+        va_end(copy);
+
+        kmnd_release(allocator, kmnd->commands);
+        kmnd_release(allocator, kmnd->options);
+        kmnd_release(allocator, kmnd->inputs);
+        kmnd_release(allocator, kmnd);
+
+        return NULL;
+    }
 
     child_iterator = child;
     size_t i = 0, j = 0, k = 0;
@@ -107,17 +140,183 @@ kmnd_t *kmnd_new(const char *name, const char *description, kmnd_run_cb *run,
     return (kmnd_t *) kmnd;
 }
 
-int kmnd_fd(kmnd_t *kmnd, const int fd) {
-    kmnd_terminal_t *terminal = kmnd_terminal_new(fd);
-
+/*
+ * This function replaces the terminal of the given command. It returns -1 if
+ * the new terminal could not be created.
+ */
+static int kmnd_command_set_terminal(kmnd_t *kmnd,
+                                     kmnd_terminal_t *terminal) {
     if (terminal == NULL)
         return -1;
 
     kmnd_command_t *command = (kmnd_command_t *) kmnd;
 
-    kmnd_terminal_free(command->terminal);
+    if (command->terminal != NULL)
+        kmnd_terminal_free(command->terminal);
 
     command->terminal = terminal;
 
     return 0;
 }
+
+int kmnd_fd(kmnd_t *kmnd, const int fd) {
+    return kmnd_command_set_terminal(kmnd, kmnd_terminal_new(fd));
+}
+
+int kmnd_file(kmnd_t *kmnd, FILE *file) {
+    return kmnd_command_set_terminal(kmnd, kmnd_terminal_new_file(file));
+}
+
+int kmnd_memory(kmnd_t *kmnd) {
+    return kmnd_command_set_terminal(kmnd, kmnd_terminal_new_memory());
+}
+
+int kmnd_callback(kmnd_t *kmnd, kmnd_write_cb *callback, void *context) {
+    return kmnd_command_set_terminal(kmnd,
+                                     kmnd_terminal_new_callback(callback,
+                                                                context));
+}
+
+const char *kmnd_output(kmnd_t *kmnd, size_t *length) {
+    kmnd_terminal_t *terminal =
+        kmnd_command_terminal((kmnd_command_t *) kmnd);
+
+    if (terminal == NULL)
+        return NULL;
+
+    return kmnd_terminal_output(terminal, length);
+}
+
+void kmnd_output_clear(kmnd_t *kmnd) {
+    kmnd_terminal_t *terminal =
+        kmnd_command_terminal((kmnd_command_t *) kmnd);
+
+    if (terminal != NULL)
+        kmnd_terminal_output_clear(terminal);
+}
+
+int kmnd_flush(kmnd_t *kmnd) {
+    kmnd_terminal_t *terminal =
+        kmnd_command_terminal((kmnd_command_t *) kmnd);
+
+    if (terminal == NULL)
+        return -1;
+
+    return kmnd_terminal_flush(terminal);
+}
+
+int kmnd_command_finalize(kmnd_command_t *command) {
+    if (kmnd_command_expand(command) != 0)
+        return -1;
+
+    if (command->trie.nodes == NULL &&
+        kmnd_trie_build(&command->trie, command) != 0)
+        return -1;
+
+    if (command->index.entries == NULL &&
+        kmnd_index_build(&command->index, command) != 0)
+        return -1;
+
+    return 0;
+}
+
+kmnd_command_t *kmnd_command_root(kmnd_command_t *command) {
+    while (command->super != NULL)
+        command = (kmnd_command_t *) command->super;
+
+    return command;
+}
+
+void kmnd_command_reset(kmnd_command_t *command) {
+    while (command->touched_options != NULL) {
+        kmnd_option_t *option = command->touched_options;
+        command->touched_options = option->next_touched;
+
+        kmnd_option_reset(option);
+    }
+
+    while (command->touched_inputs != NULL) {
+        kmnd_input_t *input = command->touched_inputs;
+        command->touched_inputs = input->next_touched;
+
+        kmnd_input_reset(input);
+    }
+
+    /* Nothing borrows the response files of the previous run anymore. */
+    kmnd_args_unmap(command->core.allocator, &command->mappings);
+}
+
+/*
+ * This is the terminal that all output on this thread is written to instead
+ * (see kmnd_command_redirect).
+ */
+static KMND_THREAD_LOCAL kmnd_terminal_t *kmnd_command_thread_terminal = NULL;
+
+kmnd_terminal_t *kmnd_command_redirect(kmnd_terminal_t *terminal) {
+    kmnd_terminal_t *previous = kmnd_command_thread_terminal;
+    kmnd_command_thread_terminal = terminal;
+
+    return previous;
+}
+
+kmnd_terminal_t *kmnd_command_terminal(kmnd_command_t *command) {
+    if (kmnd_command_thread_terminal != NULL)
+        return kmnd_command_thread_terminal;
+
+    while (command->terminal == NULL && command->super != NULL)
+        command = (kmnd_command_t *) command->super;
+
+    if (command->terminal == NULL)
+        command->terminal = kmnd_terminal_new_default();
+
+    return command->terminal;
+}
+
+unsigned char kmnd_command_abbreviates(const kmnd_command_t *command) {
+    while (command != NULL) {
+        if (command->abbreviate)
+            return 1;
+
+        command = (const kmnd_command_t *) command->super;
+    }
+
+    return 0;
+}
+
+void kmnd_abbreviate(kmnd_t *kmnd, const unsigned char enabled) {
+    ((kmnd_command_t *) kmnd)->abbreviate = enabled;
+}
+
+unsigned char kmnd_command_borrows(const kmnd_command_t *command) {
+    while (command != NULL) {
+        if (command->borrow)
+            return 1;
+
+        command = (const kmnd_command_t *) command->super;
+    }
+
+    return 0;
+}
+
+void kmnd_borrow(kmnd_t *kmnd, const unsigned char enabled) {
+    ((kmnd_command_t *) kmnd)->borrow = enabled;
+}
+
+unsigned char kmnd_command_expands(const kmnd_command_t *command) {
+    while (command != NULL) {
+        if (command->response_files)
+            return 1;
+
+        command = (const kmnd_command_t *) command->super;
+    }
+
+    return 0;
+}
+
+void kmnd_response_files(kmnd_t *kmnd, const unsigned char enabled) {
+    ((kmnd_command_t *) kmnd)->response_files = enabled;
+}
+
+void kmnd_batch(kmnd_t *kmnd, const unsigned char enabled) {
+    ((kmnd_command_t *) kmnd)->batch = enabled;
+}
@@ -31,10 +31,15 @@ extern "C" {
 
 typedef struct kmnd_command_s kmnd_command_t;
 
+#include "args.h"
 #include "core.h"
+#include "index.h"
 #include "input.h"
+#include "line.h"
 #include "option.h"
+#include "result.h"
 #include "terminal.h"
+#include "trie.h"
 #include "usage.h"
 
 struct kmnd_command_s {
@@ -60,9 +65,188 @@ struct kmnd_command_s {
 
     kmnd_t *super;
 
+    /**
+     * This number is different for every command that was ever created, even
+     * if it is allocated at the address of a command that was freed. It is
+     * what KMND_HANDLE keeps its handles for.
+     */
+    unsigned long generation;
+
+    /**
+     * This is the terminal that output of this command is written to. It is
+     * NULL unless it is overridden with kmnd_fd or created lazily for the root
+     * command. Use kmnd_command_terminal to retrieve the terminal that applies
+     * to this command.
+     */
     kmnd_terminal_t *terminal;
+
+    /**
+     * This indicates whether the rendered usage text of this command and its
+     * subcommands may be cached on disk (see kmnd_usage_cache).
+     */
+    unsigned char cache_usage;
+
+    /**
+     * This indicates whether the usage text of this command and its
+     * subcommands uses balanced line breaks (see kmnd_usage_balance).
+     */
+    unsigned char balance_usage;
+
+    /**
+     * This is the index of all long and short options that are available to
+     * this command. It is built by kmnd_command_finalize.
+     */
+    kmnd_index_t index;
+
+    /**
+     * This is the trie of the names of the subcommands, options and inputs of
+     * this command. It is built by kmnd_command_finalize.
+     */
+    kmnd_trie_t trie;
+
+    /**
+     * This indicates whether subcommands of this command and its subcommands
+     * may be abbreviated (see kmnd_abbreviate).
+     */
+    unsigned char abbreviate;
+
+    /**
+     * This indicates whether string options and inputs of this command and
+     * its subcommands point into the arguments instead of copying them (see
+     * kmnd_borrow).
+     */
+    unsigned char borrow;
+
+    /**
+     * This indicates whether the root command runs a batch of lines when it is
+     * given `--batch=FILE` (see kmnd_batch), and whether it is running one.
+     */
+    unsigned char batch;
+    unsigned char batching;
+
+    /**
+     * These are the exit codes of the lines of the last batch that was run
+     * with this command (see kmnd_run_batch).
+     */
+    int *batch_codes;
+    size_t num_batch_codes;
+
+    /**
+     * This indicates whether `@path` arguments of this command and its
+     * subcommands are expanded into the arguments in the file at that path
+     * (see kmnd_response_files).
+     */
+    unsigned char response_files;
+
+    /**
+     * These are the response files that remain mapped because values borrow
+     * their arguments. They are only kept by the root command.
+     */
+    kmnd_args_mapping_t *mappings;
+
+    /**
+     * This is the spec that the options, inputs, usage section and subcommands
+     * of this command are created from when they are first needed (see
+     * kmnd_command_expand). It is NULL once they have been created and for
+     * commands that were created with kmnd_new.
+     */
+    const kmnd_spec_t *spec;
+
+    /**
+     * This is the arena that the tree was allocated from if it was created
+     * with kmnd_spec_new (and NULL otherwise). It is freed with the tree.
+     */
+    kmnd_arena_t *arena;
+
+    /**
+     * This indicates whether the tree was frozen with kmnd_freeze, in which
+     * case the root command holds the initial values of all options and
+     * inputs of the tree, which every result starts with.
+     */
+    unsigned char frozen;
+    kmnd_result_slot_t *initial;
+    size_t num_slots;
+
+    /**
+     * This is the buffer that kmnd_run_line splits lines into.
+     */
+    kmnd_line_t line;
+
+    /**
+     * These are the options and inputs of the tree that were changed since
+     * the tree was last reset, linked through their `next_touched` field. They
+     * are only kept by the root command (see kmnd_command_reset).
+     */
+    kmnd_option_t *touched_options;
+    kmnd_input_t *touched_inputs;
 };
 
+/**
+ * This function prepares the given command for parsing arguments, once the
+ * tree is complete. It is called by kmnd_run and does nothing if the command
+ * was already finalized. It returns -1 if memory could not be allocated.
+ */
+int kmnd_command_finalize(kmnd_command_t *command);
+
+/**
+ * This function returns the generation for a command that is being created.
+ */
+unsigned long kmnd_command_generation(void);
+
+/**
+ * This function creates the options, inputs, usage section and subcommands of
+ * the given command from its spec, if it was created by kmnd_spec_new and this
+ * has not happened yet. Subcommands are created without their own children, so
+ * only the commands that are actually used are expanded. It returns -1 if
+ * memory could not be allocated.
+ */
+int kmnd_command_expand(kmnd_command_t *command);
+
+/**
+ * This function returns the root command of the tree of the given command.
+ */
+kmnd_command_t *kmnd_command_root(kmnd_command_t *command);
+
+/**
+ * This function restores the initial values of all options and inputs that
+ * were changed since the tree of the given root command was last reset. It
+ * only visits those options and inputs. Response files that were kept for
+ * borrowed values are unmapped as well.
+ */
+void kmnd_command_reset(kmnd_command_t *command);
+
+/**
+ * This function makes kmnd_command_terminal return the given terminal for any
+ * command on the calling thread (or stop doing so if it is NULL). It returns
+ * the terminal that was used before.
+ */
+kmnd_terminal_t *kmnd_command_redirect(kmnd_terminal_t *terminal);
+
+/**
+ * This function returns the terminal of the given command or of its closest
+ * ancestor that has one. If no command in the chain has a terminal, a terminal
+ * for stdout is created for the root command when it is first needed.
+ */
+kmnd_terminal_t *kmnd_command_terminal(kmnd_command_t *command);
+
+/**
+ * This function returns whether subcommands of the given command may be
+ * abbreviated, which is inherited from its ancestors.
+ */
+unsigned char kmnd_command_abbreviates(const kmnd_command_t *command);
+
+/**
+ * This function returns whether `@path` arguments of the given command are
+ * expanded, which is inherited from its ancestors.
+ */
+unsigned char kmnd_command_expands(const kmnd_command_t *command);
+
+/**
+ * This function returns whether string options and inputs of the given command
+ * borrow the arguments, which is inherited from its ancestors.
+ */
+unsigned char kmnd_command_borrows(const kmnd_command_t *command);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -25,6 +25,16 @@
 
 #include <kmnd.h>
 
+/*
+ * This is the storage class of variables that have a separate instance for
+ * each thread.
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define KMND_THREAD_LOCAL _Thread_local
+#else
+#define KMND_THREAD_LOCAL __thread
+#endif
+
 typedef enum kmnd_type_e {
     KMND_TYPE_COMMAND = 0,
     KMND_TYPE_OPTION  = 1,
@@ -41,6 +51,10 @@ struct kmnd_s {
     /* This is the description of the (sub)command or option, used in the usage
      * text. */
     const char *description;
+
+    /* This is the allocator that this node was allocated with, which is also
+     * used for everything that the node allocates later on. */
+    const kmnd_allocator_t *allocator;
 };
 
 #endif /* __core_h */
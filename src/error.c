@@ -79,8 +79,28 @@ void kmnd_error_init_missing_option(kmnd_error_t *error, const char *string) {
     error->string = string;
 }
 
+void kmnd_error_init_ambiguous_command(kmnd_error_t *error,
+                                       const char *string) {
+    kmnd_error_init(error);
+    error->type = KMND_ERROR_TYPE_AMBIGUOUS_COMMAND;
+    error->string = string;
+}
+
+void kmnd_error_init_unterminated_quote(kmnd_error_t *error) {
+    kmnd_error_init(error);
+    error->type = KMND_ERROR_TYPE_UNTERMINATED_QUOTE;
+}
+
+void kmnd_error_init_nested_response_file(kmnd_error_t *error,
+                                          const char *string) {
+    kmnd_error_init(error);
+    error->type = KMND_ERROR_TYPE_NESTED_RESPONSE_FILE;
+    error->string = string;
+}
+
 void kmnd_error_print(kmnd_error_t *error, kmnd_t *kmnd) {
-    kmnd_terminal_t *terminal = ((kmnd_command_t *) kmnd)->terminal;
+    kmnd_terminal_t *terminal;
+    terminal = kmnd_command_terminal((kmnd_command_t *) kmnd);
 
     if (error->type == KMND_ERROR_TYPE_UNKNOWN_OPTION) {
         kmnd_terminal_text(terminal, "[!] Unknown option: `",
@@ -181,6 +201,65 @@ void kmnd_error_print(kmnd_error_t *error, kmnd_t *kmnd) {
 
         kmnd_terminal_text(terminal, "`", KMND_TERMINAL_FOREGROUND_RED);
 
+        kmnd_terminal_text(terminal, "", KMND_TERMINAL_OPTIONS_NONE);
+    }else if (error->type == KMND_ERROR_TYPE_AMBIGUOUS_COMMAND) {
+        kmnd_terminal_text(terminal, "[!] Ambiguous command: `",
+                           KMND_TERMINAL_FOREGROUND_RED |
+                           KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+        kmnd_terminal_text(terminal, error->string,
+                           KMND_TERMINAL_FOREGROUND_RED |
+                           KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+        kmnd_terminal_text(terminal, "`, which could be:",
+                           KMND_TERMINAL_FOREGROUND_RED |
+                           KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+        /* The candidates are listed in the order of the usage text. */
+        kmnd_command_t *command = (kmnd_command_t *) kmnd;
+        const size_t length = strlen(error->string);
+
+        size_t i;
+        for (i = 0; i < command->num_commands; i ++) {
+            const char *name = command->commands[i]->core.name;
+
+            if (strncmp(name, error->string, length) != 0)
+                continue;
+
+            kmnd_terminal_text(terminal, " `",
+                               KMND_TERMINAL_FOREGROUND_RED |
+                               KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+            kmnd_terminal_text(terminal, name,
+                               KMND_TERMINAL_FOREGROUND_RED |
+                               KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+            kmnd_terminal_text(terminal, "`",
+                               KMND_TERMINAL_FOREGROUND_RED |
+                               KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+        }
+
+        kmnd_terminal_text(terminal, "", KMND_TERMINAL_FOREGROUND_RED);
+
+        kmnd_terminal_text(terminal, "", KMND_TERMINAL_OPTIONS_NONE);
+    }else if (error->type == KMND_ERROR_TYPE_UNTERMINATED_QUOTE) {
+        kmnd_terminal_text(terminal, "[!] Unterminated quote",
+                           KMND_TERMINAL_FOREGROUND_RED);
+
+        kmnd_terminal_text(terminal, "", KMND_TERMINAL_OPTIONS_NONE);
+    }else if (error->type == KMND_ERROR_TYPE_NESTED_RESPONSE_FILE) {
+        kmnd_terminal_text(terminal, "[!] Response files are nested too "
+                           "deeply: `", KMND_TERMINAL_FOREGROUND_RED |
+                                        KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+        kmnd_terminal_text(terminal, error->string,
+                           KMND_TERMINAL_FOREGROUND_RED |
+                           KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+        kmnd_terminal_text(terminal, "`", KMND_TERMINAL_FOREGROUND_RED);
+
         kmnd_terminal_text(terminal, "", KMND_TERMINAL_OPTIONS_NONE);
     }
+
+    kmnd_terminal_flush(terminal);
 }
@@ -69,7 +69,26 @@ typedef enum kmnd_error_type_e {
      * This exception is thrown when no value is provided for an option that is
      * required (see KMND_FLAGS_REQUIRED).
      */
-    KMND_ERROR_TYPE_MISSING_OPTION  = -8
+    KMND_ERROR_TYPE_MISSING_OPTION  = -8,
+
+    /**
+     * This exception is thrown when the provided command is an abbreviation
+     * of more than one subcommand (see kmnd_abbreviate).
+     */
+    KMND_ERROR_TYPE_AMBIGUOUS_COMMAND = -9,
+
+    /**
+     * This exception is thrown when a line that is passed to kmnd_run_line
+     * contains a quote that is not terminated.
+     */
+    KMND_ERROR_TYPE_UNTERMINATED_QUOTE = -10,
+
+    /**
+     * This exception is thrown when response files refer to other response
+     * files more than KMND_ARGS_MAX_DEPTH levels deep (see
+     * kmnd_response_files).
+     */
+    KMND_ERROR_TYPE_NESTED_RESPONSE_FILE = -11
 } kmnd_error_type_t;
 
 struct kmnd_error_s {
@@ -87,6 +106,11 @@ void kmnd_error_init_invalid_input(kmnd_error_t *error, const char *string,
                                    const char *value);
 void kmnd_error_init_missing_input(kmnd_error_t *error, const char *string);
 void kmnd_error_init_missing_option(kmnd_error_t *error, const char *string);
+void kmnd_error_init_ambiguous_command(kmnd_error_t *error,
+                                       const char *string);
+void kmnd_error_init_unterminated_quote(kmnd_error_t *error);
+void kmnd_error_init_nested_response_file(kmnd_error_t *error,
+                                          const char *string);
 
 void kmnd_error_print(kmnd_error_t *error, kmnd_t *kmnd);
 
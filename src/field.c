@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "input.h"
+#include "option.h"
+#include "path.h"
+
+typedef struct kmnd_fields_entry_s {
+    /* This is the option or input whose value is stored in the field. */
+    kmnd_t *node;
+
+    size_t offset;
+    size_t size;
+} kmnd_fields_entry_t;
+
+struct kmnd_fields_s {
+    const kmnd_allocator_t *allocator;
+
+    size_t num_entries;
+    kmnd_fields_entry_t entries[];
+};
+
+kmnd_fields_t *kmnd_fields_compile(kmnd_t *kmnd, const kmnd_field_t *fields,
+                                   const size_t num_fields) {
+    kmnd_fields_t *compiled =
+        kmnd_allocate(kmnd->allocator, sizeof(kmnd_fields_t) +
+                                       num_fields *
+                                       sizeof(kmnd_fields_entry_t));
+
+    if (compiled == NULL)
+        return NULL;
+
+    compiled->allocator = kmnd->allocator;
+    compiled->num_entries = num_fields;
+
+    size_t i;
+    for (i = 0; i < num_fields; i ++) {
+        const kmnd_field_t *field = &fields[i];
+        kmnd_t *result = kmnd_path(kmnd, field->path);
+
+        unsigned char valid = (result != NULL &&
+                               field->size == kmnd_value_size(field->type));
+
+        if (valid && result->type == KMND_TYPE_INPUT)
+            valid = (field->type == KMND_VALUE_STRING);
+        else if (valid && result->type == KMND_TYPE_OPTION)
+            valid = (((kmnd_option_t *) result)->type == field->type);
+        else
+            valid = 0;
+
+        if (!valid) {
+            kmnd_fields_free(compiled);
+            return NULL;
+        }
+
+        compiled->entries[i].node = result;
+        compiled->entries[i].offset = field->offset;
+        compiled->entries[i].size = field->size;
+    }
+
+    return compiled;
+}
+
+void kmnd_fields_free(kmnd_fields_t *fields) {
+    if (fields != NULL)
+        kmnd_release(fields->allocator, fields);
+}
+
+void kmnd_load(const kmnd_fields_t *fields, void *target) {
+    size_t i;
+    for (i = 0; i < fields->num_entries; i ++) {
+        const kmnd_fields_entry_t *entry = &fields->entries[i];
+        char *destination = (char *) target + entry->offset;
+
+        if (entry->node->type == KMND_TYPE_INPUT) {
+            const char *value =
+                kmnd_input_current((kmnd_input_t *) entry->node, NULL);
+            memcpy(destination, &value, sizeof(value));
+        }else
+            memcpy(destination,
+                   kmnd_option_current((kmnd_option_t *) entry->node, NULL),
+                   entry->size);
+    }
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "command.h"
+#include "index.h"
+
+#define KMND_INDEX_FNV_OFFSET 2166136261u
+#define KMND_INDEX_FNV_PRIME  16777619u
+
+/*
+ * This function inserts the option into the index, unless an option with the
+ * same name is already present.
+ */
+static void kmnd_index_insert(kmnd_index_t *index, kmnd_option_t *option) {
+    const char *name = option->core.name;
+    uint32_t hash = KMND_INDEX_FNV_OFFSET;
+
+    size_t length;
+    for (length = 0; name[length] != '\0'; length ++)
+        hash = (hash ^ (unsigned char) name[length]) * KMND_INDEX_FNV_PRIME;
+
+    size_t slot = hash & index->mask;
+
+    while (index->entries[slot].option != NULL) {
+        const kmnd_index_entry_t *entry = &index->entries[slot];
+
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(entry->name, name, length) == 0)
+            return;
+
+        slot = (slot + 1) & index->mask;
+    }
+
+    index->entries[slot].name = name;
+    index->entries[slot].length = length;
+    index->entries[slot].hash = hash;
+    index->entries[slot].option = option;
+}
+
+int kmnd_index_build(kmnd_index_t *index, kmnd_command_t *command) {
+    size_t num_options = 0, num_characters = 0;
+
+    const kmnd_command_t *iterator;
+    for (iterator = command; iterator != NULL;
+         iterator = (const kmnd_command_t *) iterator->super) {
+        num_options += iterator->num_options;
+
+        size_t i;
+        for (i = 0; i < iterator->num_options; i ++)
+            if (iterator->options[i]->character != 0)
+                num_characters ++;
+    }
+
+    size_t size = 8;
+
+    while (size < num_options * 2)
+        size *= 2;
+
+    /* The hash table and the short options share a single allocation. The
+     * table of short names is only needed if there are any. */
+    const size_t entries_size = size * sizeof(kmnd_index_entry_t);
+    const size_t short_options_size = num_characters *
+                                      sizeof(kmnd_option_t *);
+    const size_t shorts_size = (num_characters > 0) ? 256 : 0;
+
+    char *memory = kmnd_allocate(command->core.allocator,
+                                 entries_size + short_options_size +
+                                 shorts_size);
+
+    if (memory == NULL)
+        return -1;
+
+    index->allocator = command->core.allocator;
+    index->entries = (kmnd_index_entry_t *) memory;
+    index->mask = size - 1;
+    index->short_options = (kmnd_option_t **) (memory + entries_size);
+    index->shorts = NULL;
+
+    if (num_characters > 0) {
+        index->shorts = (unsigned char *) (memory + entries_size +
+                                           short_options_size);
+        memset(index->shorts, 0, shorts_size);
+    }
+
+    /* There are at most 255 different short names, so the position of each
+     * short option fits in the table. */
+    unsigned char num_shorts = 0;
+
+    /* Commands closer to this command are inserted first, so that their
+     * options shadow those of their ancestors. */
+    for (iterator = command; iterator != NULL;
+         iterator = (const kmnd_command_t *) iterator->super) {
+        size_t i;
+        for (i = 0; i < iterator->num_options; i ++) {
+            kmnd_option_t *option = iterator->options[i];
+            const unsigned char character = (unsigned char) option->character;
+
+            kmnd_index_insert(index, option);
+
+            if (character == 0 || index->shorts[character] != 0)
+                continue;
+
+            index->short_options[num_shorts ++] = option;
+            index->shorts[character] = num_shorts;
+        }
+    }
+
+    return 0;
+}
+
+void kmnd_index_release(kmnd_index_t *index) {
+    if (index->entries != NULL)
+        kmnd_release(index->allocator, index->entries);
+
+    index->entries = NULL;
+    index->mask = 0;
+    index->short_options = NULL;
+    index->shorts = NULL;
+}
+
+kmnd_option_t *kmnd_index_find_short(const kmnd_index_t *index,
+                                     const char character) {
+    if (index->shorts == NULL)
+        return NULL;
+
+    const unsigned char position = index->shorts[(unsigned char) character];
+
+    if (position == 0)
+        return NULL;
+
+    return index->short_options[position - 1];
+}
+
+kmnd_option_t *kmnd_index_find(const kmnd_index_t *index, const char *string,
+                               size_t *length) {
+    /* The name is hashed while looking for its end. */
+    uint32_t hash = KMND_INDEX_FNV_OFFSET;
+
+    size_t i;
+    for (i = 0; string[i] != '\0' && string[i] != '='; i ++)
+        hash = (hash ^ (unsigned char) string[i]) * KMND_INDEX_FNV_PRIME;
+
+    *length = i;
+
+    if (index->entries == NULL)
+        return NULL;
+
+    size_t slot = hash & index->mask;
+
+    while (index->entries[slot].option != NULL) {
+        const kmnd_index_entry_t *entry = &index->entries[slot];
+
+        if (entry->hash == hash && entry->length == i &&
+            memcmp(entry->name, string, i) == 0)
+            return entry->option;
+
+        slot = (slot + 1) & index->mask;
+    }
+
+    return NULL;
+}
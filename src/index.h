@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_index_h
+#define __kmnd_index_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct kmnd_index_s kmnd_index_t;
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "option.h"
+
+struct kmnd_command_s;
+
+typedef struct kmnd_index_entry_s {
+    const char *name;
+    size_t length;
+    uint32_t hash;
+
+    /* This is NULL for empty slots. */
+    kmnd_option_t *option;
+} kmnd_index_entry_t;
+
+/*
+ * An index maps the long names of all options that are available to a command
+ * (its own options and the options it inherits from its ancestors) to the
+ * options themselves. It is an open-addressed hash table with linear probing
+ * that is at most half full.
+ *
+ * Short names are mapped through a table with an entry for each character,
+ * which holds the position (plus one) of the option in `short_options`, or 0
+ * if there is no option with that short name. The table is NULL if none of the
+ * options has a short name, which is common for leaf subcommands.
+ */
+struct kmnd_index_s {
+    kmnd_index_entry_t *entries;
+    size_t mask;
+
+    unsigned char *shorts;
+    kmnd_option_t **short_options;
+
+    /* This is the allocator of the command that the index belongs to. */
+    const kmnd_allocator_t *allocator;
+};
+
+/**
+ * This function builds the index of the given command. Options of the command
+ * itself take precedence over inherited options with the same name. It
+ * returns -1 if memory could not be allocated.
+ */
+int kmnd_index_build(kmnd_index_t *index, struct kmnd_command_s *command);
+
+/**
+ * This function frees the memory allocated by the index (but not the index
+ * itself).
+ */
+void kmnd_index_release(kmnd_index_t *index);
+
+/**
+ * This function looks up the option whose long name is at the start of the
+ * given string, which ends at the first `=` or at the end of the string. The
+ * length of the name is stored in `length`. It returns NULL if there is no
+ * such option.
+ */
+kmnd_option_t *kmnd_index_find(const kmnd_index_t *index, const char *string,
+                               size_t *length);
+
+/**
+ * This function returns the option with the given short name, or NULL if there
+ * is no such option.
+ */
+kmnd_option_t *kmnd_index_find_short(const kmnd_index_t *index,
+                                     const char character);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_index_h */
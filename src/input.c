@@ -24,18 +24,21 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocator.h"
+#include "command.h"
 #include "input.h"
 #include "path.h"
+#include "result.h"
 
 kmnd_t *kmnd_input_new(const char *name, const char *description,
                        const kmnd_flags_t flags, kmnd_validator_cb *validator) {
-    kmnd_input_t *input = malloc(sizeof(kmnd_input_t));
+    const kmnd_allocator_t *allocator = kmnd_allocator_current();
+    kmnd_input_t *input = kmnd_allocate(allocator, sizeof(kmnd_input_t));
 
     if (input == NULL)
         return NULL;
 
-    memset(input, 0, sizeof(kmnd_input_t));
-
+    input->core.allocator = allocator;
     input->core.type = KMND_TYPE_INPUT;
     input->core.name = name;
     input->core.description = description;
@@ -53,23 +56,77 @@ int kmnd_input_activate(kmnd_input_t *input, kmnd_t *kmnd, const char *string) {
 
     assert(input->value == NULL);
     assert(string != NULL);
-    input->value = strdup(string);
+
+    if (kmnd->type == KMND_TYPE_COMMAND &&
+        kmnd_command_borrows((kmnd_command_t *) kmnd))
+        input->value = string;
+    else {
+        input->copy = kmnd_duplicate(input->core.allocator, string);
+        input->value = input->copy;
+
+        if (input->value == NULL)
+            return -1;
+    }
+
+    input->length = strlen(string);
+
+    if (kmnd->type == KMND_TYPE_COMMAND) {
+        kmnd_command_t *root = kmnd_command_root((kmnd_command_t *) kmnd);
+
+        input->next_touched = root->touched_inputs;
+        root->touched_inputs = input;
+    }
 
     return 0;
 }
 
+void kmnd_input_reset(kmnd_input_t *input) {
+    kmnd_release(input->core.allocator, input->copy);
+
+    input->copy = NULL;
+    input->value = NULL;
+    input->length = 0;
+    input->next_touched = NULL;
+}
+
 unsigned char kmnd_input_required(const kmnd_input_t *input) {
     return (unsigned char) ((input->flags & KMND_FLAGS_REQUIRED) != 0);
 }
 
 unsigned char kmnd_input_activated(const kmnd_input_t *input) {
+    const kmnd_result_slot_t *slot = kmnd_result_slot(input->root,
+                                                      input->slot);
+
+    if (slot != NULL)
+        return slot->activated;
+
     return (unsigned char) (input->value != NULL);
 }
 
 void kmnd_input_free(kmnd_input_t *input) {
-    free(input->value); input->value = NULL;
+    const kmnd_allocator_t *allocator = input->core.allocator;
+
+    kmnd_release(allocator, input->copy);
+
     memset(input, 0, sizeof(kmnd_input_t));
-    free(input);
+    kmnd_release(allocator, input);
+}
+
+const char *kmnd_input_current(const kmnd_input_t *input, size_t *length) {
+    const kmnd_result_slot_t *slot = kmnd_result_slot(input->root,
+                                                      input->slot);
+
+    if (slot != NULL) {
+        if (length != NULL)
+            *length = slot->length;
+
+        return slot->value.string;
+    }
+
+    if (length != NULL)
+        *length = input->length;
+
+    return input->value;
 }
 
 const char *kmnd_input_get(kmnd_t *kmnd, const char *path) {
@@ -78,5 +135,34 @@ const char *kmnd_input_get(kmnd_t *kmnd, const char *path) {
     if (input == NULL)
         return NULL;
 
-    return input->value;
+    return kmnd_input_current(input, NULL);
+}
+
+const char *kmnd_input_value(kmnd_handle_t handle) {
+    kmnd_input_t *input = (kmnd_input_t *) handle;
+    assert(input != NULL && input->core.type == KMND_TYPE_INPUT);
+
+    return kmnd_input_current(input, NULL);
+}
+
+const char *kmnd_input_view(kmnd_t *kmnd, const char *path, size_t *length) {
+    kmnd_input_t *input = kmnd_input_path(kmnd, path);
+
+    if (input == NULL)
+        return NULL;
+
+    return kmnd_input_current(input, length);
+}
+
+const char *kmnd_view(kmnd_handle_t handle, size_t *length) {
+    kmnd_t *kmnd = (kmnd_t *) handle;
+    assert(kmnd != NULL);
+
+    if (kmnd->type == KMND_TYPE_INPUT)
+        return kmnd_input_current((kmnd_input_t *) kmnd, length);
+
+    kmnd_option_t *option = (kmnd_option_t *) kmnd;
+    assert(option->type == KMND_VALUE_STRING);
+
+    return *((const char *const *) kmnd_option_current(option, length));
 }
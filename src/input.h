@@ -39,17 +39,44 @@ struct kmnd_input_s {
     kmnd_flags_t flags;
     kmnd_validator_cb *validator;
 
-    char *value;
+    /* This is the value of the input and its length. It points into the
+     * arguments if the input borrows them (see kmnd_borrow) and to `copy`
+     * otherwise. */
+    const char *value;
+    size_t length;
+
+    char *copy;
+
+    /* This is the root of the frozen tree that the input belongs to and the
+     * position of its value in a result (see kmnd_freeze). */
+    const kmnd_t *root;
+    size_t slot;
+
+    /* This is the next input in the list of activated inputs of the root
+     * command (see kmnd_command_reset). */
+    kmnd_input_t *next_touched;
 };
 
 int kmnd_input_activate(kmnd_input_t *input, kmnd_t *kmnd, const char *string);
 
+/*
+ * This function deactivates the input (see kmnd_command_reset).
+ */
+void kmnd_input_reset(kmnd_input_t *input);
+
 unsigned char kmnd_input_required(const kmnd_input_t *input);
 
 unsigned char kmnd_input_activated(const kmnd_input_t *input);
 
 void kmnd_input_free(kmnd_input_t *input);
 
+/*
+ * This function returns the current value of the input, which is the value in
+ * the result that is being run on this thread if there is one (see
+ * kmnd_result_run). Its length is stored in `length` if it is not NULL.
+ */
+const char *kmnd_input_current(const kmnd_input_t *input, size_t *length);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
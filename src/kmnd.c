@@ -25,6 +25,8 @@
 #include <string.h>
 #include <stdio.h>
 
+#include "allocator.h"
+#include "batch.h"
 #include "command.h"
 #include "error.h"
 
@@ -38,72 +40,86 @@ void kmnd_free(kmnd_t *kmnd) {
     else if (kmnd->type == KMND_TYPE_COMMAND) {
         kmnd_command_t *command = (kmnd_command_t *) kmnd;
 
+        const kmnd_allocator_t *allocator = command->core.allocator;
+        kmnd_arena_t *arena = command->arena;
+
         size_t i;
         for (i = 0; i < command->num_options; i ++)
             kmnd_option_free(command->options[i]);
 
+        for (i = 0; i < command->num_inputs; i ++)
+            kmnd_input_free(command->inputs[i]);
+
         for (i = 0; i < command->num_commands; i ++)
             kmnd_free((kmnd_t *) command->commands[i]);
 
-        kmnd_terminal_free(command->terminal);
-        free(command);
+        if (command->usage != NULL)
+            kmnd_usage_free(command->usage);
+
+        if (command->terminal != NULL)
+            kmnd_terminal_free(command->terminal);
+
+        kmnd_index_release(&command->index);
+        kmnd_trie_release(&command->trie);
+        kmnd_line_release(&command->line);
+        kmnd_args_unmap(command->core.allocator, &command->mappings);
+
+        kmnd_release(allocator, command->commands);
+        kmnd_release(allocator, command->options);
+        kmnd_release(allocator, command->inputs);
+        kmnd_release(allocator, command->initial);
+        kmnd_release(allocator, command->batch_codes);
+        kmnd_release(allocator, command);
+
+        if (arena != NULL)
+            kmnd_arena_free(arena);
     }
 }
 
 static int kmnd_process_option(kmnd_t *kmnd, const char *string) {
-    assert(strlen(string) > 0);
+    assert(string[0] == '-');
 
     kmnd_command_t *command = (kmnd_command_t *) kmnd;
 
-    /* Note that this is perfectly safe because if arg = "-" then arg[1]
-     * will be \0. */
-    char twice = (string[1] == '-');
+    kmnd_error_t error;
 
-    size_t setter;
-    for (setter = 0; setter < strlen(string); setter ++) {
-        if (string[setter] == '=')
-            break;
-    }
+    if (string[1] == '-') {
+        size_t length;
+        kmnd_option_t *option = kmnd_index_find(&command->index, string + 2,
+                                                &length);
 
-    size_t j, k = 1;
-    while (command != NULL) {
-        for (j = 0; j < command->num_options; j ++) {
-            kmnd_option_t *option = (kmnd_option_t *) command->options[j];
+        if (option != NULL) {
+            if (string[2 + length] == '\0')
+                return kmnd_option_flag(kmnd, option);
 
-            if (twice &&
-                strncmp(option->core.name, string + 2, setter - 2) != 0)
-                continue;
+            return kmnd_option_activate(kmnd, option, string + 2 + length + 1);
+        }
 
-            if (twice == 0 && option->character != string[k])
-                continue;
+        kmnd_error_init_unknown_option(&error, string);
+    }else {
+        /* Short options can be combined (e.g. -abc) and the last one may be
+         * followed by a value (e.g. -abc=value). Each character is a single
+         * lookup in the index. */
+        size_t k;
+        for (k = 1; string[k] != '\0'; k ++) {
+            kmnd_option_t *option = NULL;
 
-            if ((twice && setter == strlen(string)) ||
-                (!twice && string[k + 1] != '='))
-                kmnd_option_flag(kmnd, option);
-            else {
-                return kmnd_option_activate(kmnd, option, string + setter + 1);
-            }
+            if (string[k] != '=')
+                option = kmnd_index_find_short(&command->index, string[k]);
 
-            if (twice == 1)
-                return 0;
-            else if (++ k == strlen(string))
-                return 0;
-            else {
-                j = (size_t) -1;
-                command = (kmnd_command_t *) kmnd;
-            }
-        }
+            if (option == NULL)
+                break;
 
-        command = (kmnd_command_t *) command->super;
-    }
+            if (string[k + 1] == '=')
+                return kmnd_option_activate(kmnd, option, string + k + 2);
 
-    command = (kmnd_command_t *) kmnd;
+            if (kmnd_option_flag(kmnd, option) != 0)
+                return -1;
+        }
 
-    kmnd_error_t error;
+        if (k > 1 && string[k] == '\0')
+            return 0;
 
-    if (twice)
-        kmnd_error_init_unknown_option(&error, string);
-    else {
         char option[3] = { '-', '\0', '\0' };
         option[1] = string[k];
         kmnd_error_init_unknown_option(&error, option);
@@ -117,18 +133,24 @@ static int kmnd_process_option(kmnd_t *kmnd, const char *string) {
     return -1;
 }
 
-int kmnd_run(kmnd_t *kmnd, const int argc, const char **argv) {
+/*
+ * This function runs the given command with the remaining arguments of the
+ * given iterator. Subcommands continue with the same iterator.
+ */
+static int kmnd_run_args(kmnd_t *kmnd, kmnd_args_t *args) {
     kmnd_command_t *command = (kmnd_command_t *) kmnd;
 
+    if (kmnd_command_finalize(command) != 0)
+        return -1;
+
     /** Three stages: commands, options and inputs. */
     size_t stage = 0, input = 0;
 
-    int i;
-    for (i = 1; i < argc; i ++) {
-        const char *arg = argv[i];
+    const char *arg;
+    while ((arg = kmnd_args_next(args, command)) != NULL) {
 
         /* Skip empty arguments. */
-        if (strlen(arg) == 0)
+        if (arg[0] == '\0')
             continue;
 
         /**
@@ -153,13 +175,24 @@ int kmnd_run(kmnd_t *kmnd, const int argc, const char **argv) {
                 stage = 2;
 
             if (stage == 0) {
-                size_t j;
-                for (j = 0; j < command->num_commands; j++) {
-                    if (strcmp(command->commands[j]->core.name, arg) != 0)
-                        continue;
+                kmnd_t *subcommand = NULL;
 
-                    return kmnd_run((kmnd_t *) command->commands[j], argc - i,
-                                    argv + i);
+                int res = kmnd_trie_find_command(
+                    &command->trie, arg, kmnd_command_abbreviates(command),
+                    &subcommand);
+
+                if (res == 0)
+                    return kmnd_run_args(subcommand, args);
+
+                if (res == -2) {
+                    kmnd_error_t error;
+                    kmnd_error_init_ambiguous_command(&error, arg);
+                    kmnd_error_print(&error, kmnd);
+
+                    if (command->usage != NULL)
+                        kmnd_usage_print(command->usage, command);
+
+                    return -1;
                 }
             }
 
@@ -201,6 +234,15 @@ int kmnd_run(kmnd_t *kmnd, const int argc, const char **argv) {
         }
     }
 
+    if (args->error.type != KMND_ERROR_TYPE_NONE) {
+        kmnd_error_print(&args->error, kmnd);
+
+        if (command->usage != NULL)
+            kmnd_usage_print(command->usage, command);
+
+        return -1;
+    }
+
     size_t j;
 
     /**
@@ -250,3 +292,23 @@ int kmnd_run(kmnd_t *kmnd, const int argc, const char **argv) {
     return 0;
 }
 
+int kmnd_run(kmnd_t *kmnd, const int argc, const char **argv) {
+    kmnd_command_t *command = (kmnd_command_t *) kmnd;
+
+    if (command->super == NULL && command->batch && !command->batching) {
+        int res;
+
+        if (kmnd_batch_arguments(command, argc, argv, &res) != 0)
+            return res;
+    }
+
+    kmnd_args_t args;
+    kmnd_command_t *root = kmnd_command_root(command);
+    kmnd_args_init(&args, root->core.allocator, &root->mappings, argc, argv);
+
+    int res = kmnd_run_args(kmnd, &args);
+
+    kmnd_args_release(&args);
+
+    return res;
+}
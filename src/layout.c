@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "layout.h"
+#include "width.h"
+
+/*
+ * This function doubles the capacity of an array that starts out in the
+ * storage of the layout itself.
+ */
+static int kmnd_layout_grow(void **items, size_t *size,
+                            const void *inline_items, const size_t item_size) {
+    void *grown = malloc(*size * 2 * item_size);
+
+    if (grown == NULL)
+        return -1;
+
+    memcpy(grown, *items, *size * item_size);
+
+    if (*items != inline_items)
+        free(*items);
+
+    *items = grown;
+    *size *= 2;
+
+    return 0;
+}
+
+static int kmnd_layout_add_run(kmnd_layout_t *layout, const size_t end,
+                               const kmnd_terminal_options_t options) {
+    /* Merge runs with the same options. */
+    if (layout->num_runs > 0 &&
+        layout->runs[layout->num_runs - 1].options == options) {
+        layout->runs[layout->num_runs - 1].end = end;
+        return 0;
+    }
+
+    if (layout->num_runs == layout->runs_size &&
+        kmnd_layout_grow((void **) &layout->runs, &layout->runs_size,
+                         layout->inline_runs, sizeof(kmnd_layout_run_t)) != 0)
+        return -1;
+
+    layout->runs[layout->num_runs].end = end;
+    layout->runs[layout->num_runs].options = options;
+    layout->num_runs ++;
+
+    return 0;
+}
+
+typedef struct kmnd_layout_markup_s {
+    kmnd_layout_t *layout;
+    int status;
+} kmnd_layout_markup_t;
+
+static void kmnd_layout_markup_span(void *context, const char *text,
+                                    const size_t length,
+                                    const kmnd_terminal_options_t options,
+                                    const int placeholder) {
+    kmnd_layout_markup_t *markup = (kmnd_layout_markup_t *) context;
+    kmnd_layout_t *layout = markup->layout;
+
+    (void) placeholder;
+
+    /* Markup is only ever removed, so the text always fits. */
+    memcpy(layout->owned + layout->length, text, length);
+    layout->length += length;
+
+    if (kmnd_layout_add_run(layout, layout->length, options) != 0)
+        markup->status = -1;
+}
+
+static int kmnd_layout_add_token(kmnd_layout_t *layout,
+                                 const kmnd_layout_token_t *token) {
+    if (layout->num_tokens == layout->tokens_size &&
+        kmnd_layout_grow((void **) &layout->tokens, &layout->tokens_size,
+                         layout->inline_tokens,
+                         sizeof(kmnd_layout_token_t)) != 0)
+        return -1;
+
+    layout->tokens[layout->num_tokens ++] = *token;
+
+    return 0;
+}
+
+/*
+ * This function splits the text into words, measuring each word once.
+ */
+static int kmnd_layout_tokenize(kmnd_layout_t *layout) {
+    const char *text = layout->text;
+    const size_t length = layout->length;
+
+    kmnd_layout_token_t token;
+    memset(&token, 0, sizeof(kmnd_layout_token_t));
+
+    size_t i = 0;
+    while (i < length) {
+        token.start = i;
+
+        while (i < length && text[i] == ' ' && i - token.start < UINT32_MAX)
+            i ++;
+
+        const size_t word = i;
+
+        while (i < length && text[i] != ' ' && text[i] != '\n' &&
+               i - word < UINT32_MAX)
+            i ++;
+
+        token.spaces = (uint32_t) (word - token.start);
+        token.length = (uint32_t) (i - word);
+
+        const size_t width = kmnd_width(text + word, i - word);
+        token.width = (width < UINT32_MAX) ? (uint32_t) width : UINT32_MAX;
+
+        if (kmnd_layout_add_token(layout, &token) != 0)
+            return -1;
+
+        token.newline = 0;
+
+        if (i < length && text[i] == '\n') {
+            token.newline = 1;
+            i ++;
+        }
+    }
+
+    /* Make sure that a trailing newline is written as well. */
+    if (token.newline) {
+        token.start = length;
+        token.spaces = token.length = token.width = 0;
+
+        if (kmnd_layout_add_token(layout, &token) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int kmnd_layout_init(kmnd_layout_t *layout, const char *text,
+                     const size_t length, const unsigned char markup) {
+    memset(layout, 0, sizeof(kmnd_layout_t));
+
+    layout->runs = layout->inline_runs;
+    layout->runs_size = KMND_LAYOUT_INLINE_RUNS;
+    layout->tokens = layout->inline_tokens;
+    layout->tokens_size = KMND_LAYOUT_INLINE_TOKENS;
+
+    if (kmnd_layout_set(layout, text, length, markup) != 0) {
+        kmnd_layout_release(layout);
+        return -1;
+    }
+
+    return 0;
+}
+
+int kmnd_layout_set(kmnd_layout_t *layout, const char *text,
+                    const size_t length, const unsigned char markup) {
+    layout->source = text;
+    layout->length = 0;
+    layout->num_runs = 0;
+    layout->num_tokens = 0;
+    layout->valid = 0;
+
+    if (markup) {
+        if (layout->owned_size < length + 1) {
+            free(layout->owned);
+
+            layout->owned = malloc(length + 1);
+            layout->owned_size = (layout->owned != NULL) ? length + 1 : 0;
+
+            if (layout->owned == NULL)
+                return -1;
+        }
+
+        kmnd_layout_markup_t context = { layout, 0 };
+
+        kmnd_terminal_markup(text, length, 0, kmnd_layout_markup_span,
+                             &context);
+
+        if (context.status != 0)
+            return -1;
+
+        layout->text = layout->owned;
+    }else {
+        layout->text = text;
+        layout->length = length;
+
+        if (kmnd_layout_add_run(layout, length, 0) != 0)
+            return -1;
+    }
+
+    return kmnd_layout_tokenize(layout);
+}
+
+void kmnd_layout_release(kmnd_layout_t *layout) {
+    if (layout->runs != layout->inline_runs)
+        free(layout->runs);
+
+    if (layout->tokens != layout->inline_tokens)
+        free(layout->tokens);
+
+    free(layout->owned);
+
+    memset(layout, 0, sizeof(kmnd_layout_t));
+}
+
+size_t kmnd_layout_piece(const kmnd_layout_t *layout, const size_t start,
+                         const size_t end, const uint16_t column,
+                         const uint16_t max_width,
+                         const uint16_t indent_width, size_t *width) {
+    const size_t remaining = (column < max_width) ? max_width - column : 0;
+
+    size_t run = kmnd_width_fit(layout->text + start, end - start, remaining,
+                                width);
+
+    if (run > 0 || start == end)
+        return run;
+
+    /* Start a new line unless there is nothing but the indent on this line,
+     * in which case wrapping would not make any progress. */
+    if (column > indent_width)
+        return 0;
+
+    run = kmnd_width_fit(layout->text + start, end - start, 1, width);
+
+    if (run == 0)
+        run = kmnd_width_fit(layout->text + start, end - start, 2, width);
+
+    if (run == 0) {
+        run = 1;
+        *width = 1;
+    }
+
+    return run;
+}
+
+/*
+ * This function returns the column after writing the given range, exactly as
+ * the terminal writes it.
+ */
+static uint16_t kmnd_layout_advance(const kmnd_layout_t *layout,
+                                    size_t start, const size_t end,
+                                    uint16_t column, const uint16_t max_width,
+                                    const uint16_t indent_width) {
+    while (start < end) {
+        size_t width;
+        const size_t run = kmnd_layout_piece(layout, start, end, column,
+                                             max_width, indent_width, &width);
+
+        if (run == 0) {
+            column = indent_width;
+            continue;
+        }
+
+        start += run;
+        column += (uint16_t) width;
+    }
+
+    return column;
+}
+
+static void kmnd_layout_break_greedy(kmnd_layout_t *layout) {
+    const uint16_t max_width = layout->max_width;
+    const uint16_t indent_width = layout->indent_width;
+
+    /* This is the widest word that fits on a line after the indent. Wider
+     * words are split anyway, so there is no point in wrapping before them. */
+    const size_t max_word = (max_width > indent_width) ?
+                            max_width - indent_width : 0;
+
+    uint16_t column = layout->first_column;
+
+    size_t i;
+    for (i = 0; i < layout->num_tokens; i ++) {
+        kmnd_layout_token_t *token = &layout->tokens[i];
+
+        const size_t spaces = token->spaces;
+        const size_t end = token->start + token->spaces + token->length;
+
+        if (token->newline)
+            column = indent_width;
+
+        token->wrap = (!token->newline && column > indent_width &&
+                       token->width > 0 && token->width <= max_word &&
+                       column + spaces + token->width > max_width);
+
+        if (token->wrap)
+            column = indent_width;
+
+        const size_t start = token->start + (token->wrap ? spaces : 0);
+        const size_t width = end - start - token->length + token->width;
+
+        /* Only words that do not fit have to be measured again. */
+        if (column + width <= max_width)
+            column += (uint16_t) width;
+        else
+            column = kmnd_layout_advance(layout, start, end, column,
+                                         max_width, indent_width);
+    }
+}
+
+/*
+ * This function breaks the paragraph of tokens [first, last) such that the
+ * sum of the squared space left at the end of each line is minimal. It
+ * returns -1 if memory could not be allocated.
+ */
+static int kmnd_layout_break_paragraph(kmnd_layout_t *layout,
+                                       const size_t first, const size_t last,
+                                       const uint16_t first_column) {
+    const size_t max_width = layout->max_width;
+    const size_t indent_width = layout->indent_width;
+    const size_t count = last - first;
+
+    /* The cost and start of the last line of the best layout of the first k
+     * tokens are stored at index k. */
+    uint64_t *costs = malloc((count + 1) * sizeof(uint64_t));
+    size_t *starts = malloc((count + 1) * sizeof(size_t));
+
+    if (costs == NULL || starts == NULL) {
+        free(costs);
+        free(starts);
+        return -1;
+    }
+
+    costs[0] = 0;
+
+    size_t k;
+    for (k = 1; k <= count; k ++) {
+        costs[k] = UINT64_MAX;
+        starts[k] = k - 1;
+
+        /* Consider all lines that end with token k - 1, from short to
+         * long. */
+        size_t width = 0;
+
+        size_t i;
+        for (i = k; i -- > 0; ) {
+            const kmnd_layout_token_t *token = &layout->tokens[first + i];
+
+            width += token->width;
+
+            size_t line = width;
+
+            if (i == 0)
+                line += first_column + token->spaces;
+            else
+                line += indent_width;
+
+            if (line > max_width && i < k - 1)
+                break;
+
+            /* Lines cannot start with trailing spaces. */
+            if (i > 0 && token->width == 0) {
+                width += token->spaces;
+                continue;
+            }
+
+            if (costs[i] == UINT64_MAX) {
+                width += token->spaces;
+                continue;
+            }
+
+            uint64_t cost = costs[i];
+
+            if (k < count && line < max_width)
+                cost += (uint64_t) (max_width - line) * (max_width - line);
+
+            if (cost < costs[k]) {
+                costs[k] = cost;
+                starts[k] = i;
+            }
+
+            width += token->spaces;
+        }
+    }
+
+    for (k = count; k > 0; k = starts[k]) {
+        if (starts[k] > 0)
+            layout->tokens[first + starts[k]].wrap = 1;
+    }
+
+    free(costs);
+    free(starts);
+
+    return 0;
+}
+
+static int kmnd_layout_break_balanced(kmnd_layout_t *layout) {
+    size_t first = 0;
+
+    while (first < layout->num_tokens) {
+        size_t last = first + 1;
+
+        while (last < layout->num_tokens && !layout->tokens[last].newline)
+            last ++;
+
+        const uint16_t column = (first == 0) ? layout->first_column :
+                                layout->indent_width;
+
+        if (kmnd_layout_break_paragraph(layout, first, last, column) != 0)
+            return -1;
+
+        first = last;
+    }
+
+    return 0;
+}
+
+void kmnd_layout_break(kmnd_layout_t *layout, const uint16_t max_width,
+                       const uint16_t first_column,
+                       const uint16_t indent_width,
+                       const kmnd_layout_mode_t mode) {
+    if (layout->valid && layout->max_width == max_width &&
+        layout->first_column == first_column &&
+        layout->indent_width == indent_width && layout->mode == mode)
+        return;
+
+    layout->valid = 1;
+    layout->max_width = max_width;
+    layout->first_column = first_column;
+    layout->indent_width = indent_width;
+    layout->mode = mode;
+
+    size_t i;
+    for (i = 0; i < layout->num_tokens; i ++)
+        layout->tokens[i].wrap = 0;
+
+    if (mode == KMND_LAYOUT_BALANCED && kmnd_layout_break_balanced(layout) == 0)
+        return;
+
+    kmnd_layout_break_greedy(layout);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_layout_h
+#define __kmnd_layout_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct kmnd_layout_s kmnd_layout_t;
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "terminal.h"
+
+/*
+ * This is the number of tokens and runs that are stored in the layout itself,
+ * which is enough for most texts and avoids allocating memory for them.
+ */
+#define KMND_LAYOUT_INLINE_TOKENS 16
+#define KMND_LAYOUT_INLINE_RUNS   4
+
+typedef enum kmnd_layout_mode_e {
+    /* Fill each line with as many words as possible. */
+    KMND_LAYOUT_GREEDY = 0,
+
+    /* Minimize the sum of the squared space left at the end of each line
+     * (except the last line of a paragraph). */
+    KMND_LAYOUT_BALANCED = 1
+} kmnd_layout_mode_t;
+
+/*
+ * A run is a range of the text with the same formatting options. Runs are
+ * stored by the offset at which they end.
+ */
+typedef struct kmnd_layout_run_s {
+    size_t end;
+    kmnd_terminal_options_t options;
+} kmnd_layout_run_t;
+
+/*
+ * A token is a word together with the spaces that precede it. Either of them
+ * may be empty (e.g. for leading or trailing spaces). Tokens are kept small
+ * because long texts consist of many of them.
+ */
+typedef struct kmnd_layout_token_s {
+    /* This is the offset of the spaces, which are followed by the word. */
+    size_t start;
+    uint32_t spaces;
+    uint32_t length;
+
+    /* This is the number of columns that the word occupies. */
+    uint32_t width;
+
+    /* This is set if the token follows a newline in the text. */
+    unsigned char newline;
+
+    /* This is set if the line is wrapped before this token, in which case its
+     * spaces are not written. It depends on the width that the layout was
+     * last broken for. */
+    unsigned char wrap;
+} kmnd_layout_token_t;
+
+struct kmnd_layout_s {
+    /* This is the text that the layout was created from. For markup it points
+     * to the text with all markup removed, which is owned by the layout. */
+    const char *source;
+    const char *text;
+    size_t length;
+    char *owned;
+    size_t owned_size;
+
+    kmnd_layout_run_t *runs;
+    size_t num_runs;
+    size_t runs_size;
+
+    kmnd_layout_token_t *tokens;
+    size_t num_tokens;
+    size_t tokens_size;
+
+    /* These are the parameters for which the line breaks were computed. */
+    unsigned char valid;
+    uint16_t max_width;
+    uint16_t first_column;
+    uint16_t indent_width;
+    kmnd_layout_mode_t mode;
+
+    kmnd_layout_run_t inline_runs[KMND_LAYOUT_INLINE_RUNS];
+    kmnd_layout_token_t inline_tokens[KMND_LAYOUT_INLINE_TOKENS];
+};
+
+/**
+ * This function initializes a layout for the given text, which must outlive
+ * the layout. If `markup` is set, the text is parsed as markup (see
+ * kmnd_terminal_format). It returns -1 if memory could not be allocated.
+ */
+int kmnd_layout_init(kmnd_layout_t *layout, const char *text,
+                     const size_t length, const unsigned char markup);
+
+/**
+ * This function replaces the text of an initialized layout, reusing the memory
+ * that it has already allocated. It returns -1 if memory could not be
+ * allocated, in which case the layout is empty but can still be released.
+ */
+int kmnd_layout_set(kmnd_layout_t *layout, const char *text,
+                    const size_t length, const unsigned char markup);
+
+/**
+ * This function releases the memory allocated by a layout (but not the layout
+ * itself).
+ */
+void kmnd_layout_release(kmnd_layout_t *layout);
+
+/**
+ * This function determines where lines are wrapped when the layout is written
+ * at the given column of a line that is `max_width` columns wide and
+ * continues after an indent of `indent_width` columns. Nothing is computed if
+ * the layout was already broken for the same parameters.
+ */
+void kmnd_layout_break(kmnd_layout_t *layout, const uint16_t max_width,
+                       const uint16_t first_column,
+                       const uint16_t indent_width,
+                       const kmnd_layout_mode_t mode);
+
+/**
+ * This function returns the number of bytes in the given range of the layout
+ * text that can be written on a line at the given column, and stores the
+ * number of columns they occupy in `width`. It returns 0 if a new line should
+ * be started first. At least one character is returned on an otherwise empty
+ * line, even if it does not fit.
+ */
+size_t kmnd_layout_piece(const kmnd_layout_t *layout, const size_t start,
+                         const size_t end, const uint16_t column,
+                         const uint16_t max_width,
+                         const uint16_t indent_width, size_t *width);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_layout_h */
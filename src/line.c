@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "command.h"
+#include "error.h"
+#include "line.h"
+
+#define KMND_LINE_ORDINARY 0
+#define KMND_LINE_BLANK    1
+#define KMND_LINE_SPECIAL  2
+
+/*
+ * This table holds the class of each character. Runs of ordinary characters
+ * are copied without looking at them any further.
+ */
+static const unsigned char kmnd_line_classes[256] = {
+    ['\0'] = KMND_LINE_BLANK,
+    ['\t'] = KMND_LINE_BLANK,
+    ['\n'] = KMND_LINE_BLANK,
+    ['\r'] = KMND_LINE_BLANK,
+    [' ']  = KMND_LINE_BLANK,
+    ['"']  = KMND_LINE_SPECIAL,
+    ['\''] = KMND_LINE_SPECIAL,
+    ['\\'] = KMND_LINE_SPECIAL
+};
+
+/*
+ * This function makes sure that the buffer and the argument vector of the line
+ * are large enough for any string of the given length.
+ */
+static int kmnd_line_reserve(kmnd_line_t *line, const size_t length) {
+    /* Every argument ends with a NUL byte instead of the blank (or the end of
+     * the string) that follows it, and quotes are only ever removed, so the
+     * arguments never take more than one byte more than the string. Every
+     * argument but the last is followed by at least one blank. */
+    const size_t capacity = length + 1;
+    const size_t num_argv = (length + 1) / 2 + 2;
+
+    if (line->capacity < capacity) {
+        char *buffer = kmnd_allocate(line->allocator, capacity * 2);
+
+        if (buffer == NULL)
+            return -1;
+
+        kmnd_release(line->allocator, line->buffer);
+        line->buffer = buffer;
+        line->capacity = capacity * 2;
+    }
+
+    if (line->num_argv < num_argv) {
+        const char **argv = kmnd_allocate(line->allocator,
+                                          num_argv * 2 * sizeof(char *));
+
+        if (argv == NULL)
+            return -1;
+
+        kmnd_release(line->allocator, line->argv);
+        line->argv = argv;
+        line->num_argv = num_argv * 2;
+    }
+
+    return 0;
+}
+
+int kmnd_line_next(const char *string, const size_t length, size_t *position,
+                   char **argument, size_t *size) {
+    size_t i = *position;
+
+    for (;;) {
+        while (i < length &&
+               kmnd_line_classes[(unsigned char) string[i]] == KMND_LINE_BLANK)
+            i ++;
+
+        /* A word that starts with `#` starts a comment, which ends at the end
+         * of the line. */
+        if (i < length && string[i] == '#') {
+            const char *end = memchr(string + i, '\n', length - i);
+            i = (end != NULL) ? (size_t) (end - string) : length;
+            continue;
+        }
+
+        break;
+    }
+
+    if (i == length) {
+        *position = i;
+        return 1;
+    }
+
+    /* Arguments never take more bytes than they were given in, so they can be
+     * written over themselves. */
+    if (*argument == NULL)
+        *argument = (char *) string + i;
+
+    char *out = *argument;
+
+    while (i < length) {
+        const unsigned char class =
+            kmnd_line_classes[(unsigned char) string[i]];
+
+        if (class == KMND_LINE_ORDINARY) {
+            *(out ++) = string[i ++];
+            continue;
+        }
+
+        if (class == KMND_LINE_BLANK)
+            break;
+
+        const char c = string[i ++];
+
+        if (c == '\\') {
+            /* A backslash preserves the next character, except for a newline,
+             * which is removed along with the backslash. A backslash at the
+             * end of the string is preserved itself. */
+            if (i == length)
+                *(out ++) = c;
+            else if (string[i] == '\n')
+                i ++;
+            else
+                *(out ++) = string[i ++];
+        }else if (c == '\'') {
+            /* Single quotes preserve everything up to the next single
+             * quote. */
+            const char *end = memchr(string + i, '\'', length - i);
+
+            if (end == NULL)
+                return -1;
+
+            memmove(out, string + i, (size_t) (end - string) - i);
+            out += (size_t) (end - string) - i;
+            i = (size_t) (end - string) + 1;
+        }else {
+            /* Double quotes preserve everything up to the next double quote,
+             * except for a backslash that is followed by one of the characters
+             * below. */
+            for (;;) {
+                if (i == length)
+                    return -1;
+
+                const char d = string[i ++];
+
+                if (d == '"')
+                    break;
+
+                if (d == '\\' && i < length &&
+                    (string[i] == '$'  || string[i] == '`' ||
+                     string[i] == '"'  || string[i] == '\\' ||
+                     string[i] == '\n')) {
+                    if (string[i] != '\n')
+                        *(out ++) = string[i];
+
+                    i ++;
+                    continue;
+                }
+
+                *(out ++) = d;
+            }
+        }
+    }
+
+    *position = i;
+    *size = (size_t) (out - *argument);
+
+    return 0;
+}
+
+int kmnd_line_split(kmnd_line_t *line, const char *string, const size_t length,
+                    const char *name, int *argc) {
+    if (kmnd_line_reserve(line, length) != 0)
+        return -1;
+
+    char *out = line->buffer;
+    size_t count = 0, position = 0;
+
+    line->argv[count ++] = name;
+
+    for (;;) {
+        size_t size = 0;
+        char *argument = out;
+
+        int res = kmnd_line_next(string, length, &position, &argument, &size);
+
+        if (res == 1)
+            break;
+
+        if (res == -1)
+            return -2;
+
+        line->argv[count ++] = argument;
+
+        out += size;
+        *(out ++) = '\0';
+    }
+
+    line->argv[count] = NULL;
+    *argc = (int) count;
+
+    return 0;
+}
+
+void kmnd_line_release(kmnd_line_t *line) {
+    kmnd_release(line->allocator, line->buffer);
+    kmnd_release(line->allocator, line->argv);
+
+    memset(line, 0, sizeof(kmnd_line_t));
+}
+
+void kmnd_line_report(struct kmnd_command_s *command) {
+    kmnd_error_t error;
+    kmnd_error_init_unterminated_quote(&error);
+    kmnd_error_print(&error, (kmnd_t *) command);
+
+    if (command->usage != NULL)
+        kmnd_usage_print(command->usage, command);
+}
+
+int kmnd_run_line(kmnd_t *kmnd, const char *string, const size_t length) {
+    kmnd_command_t *command = (kmnd_command_t *) kmnd;
+
+    /* Only the options and inputs that the previous line changed are reset. */
+    kmnd_command_reset(kmnd_command_root(command));
+
+    command->line.allocator = command->core.allocator;
+
+    int argc = 0;
+    int res = kmnd_line_split(&command->line, string, length,
+                              command->core.name, &argc);
+
+    if (res == -1)
+        return -1;
+
+    if (res == -2) {
+        kmnd_line_report(command);
+        return -1;
+    }
+
+    /* The arguments remain in the buffer until the next line, so they do not
+     * need to be copied. */
+    const unsigned char borrow = command->borrow;
+    command->borrow = 1;
+
+    res = kmnd_run(kmnd, argc, command->line.argv);
+
+    command->borrow = borrow;
+
+    return res;
+}
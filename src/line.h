@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_line_h
+#define __kmnd_line_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "allocator.h"
+
+struct kmnd_command_s;
+
+/*
+ * A line holds the arguments of the last line that was split (see
+ * kmnd_run_line). Its memory is reused for every line and only grows when a
+ * line is longer than all lines before it.
+ */
+typedef struct kmnd_line_s {
+    /* These are the arguments, which are separated by NUL bytes. */
+    char *buffer;
+    size_t capacity;
+
+    /* This is the argument vector, which ends with NULL. */
+    const char **argv;
+    size_t num_argv;
+
+    const kmnd_allocator_t *allocator;
+} kmnd_line_t;
+
+/*
+ * This function splits the next argument off the given string, starting at
+ * `*position` (which is moved past it), with the quoting rules of a POSIX
+ * shell. The argument is written to `*argument`, or over itself in the string
+ * if `*argument` is NULL (in which case `*argument` is set to its start). Its
+ * length is stored in `size` and it is not terminated. It returns 1 if there
+ * are no arguments left and -1 if a quote is not terminated.
+ */
+int kmnd_line_next(const char *string, const size_t length, size_t *position,
+                   char **argument, size_t *size);
+
+/*
+ * This function splits the given string into arguments with the quoting rules
+ * of a POSIX shell. The first argument is `name` (like the program name in
+ * argv), the number of arguments is stored in `argc` and the arguments in
+ * `line->argv`. It returns -1 if memory could not be allocated and -2 if a
+ * quote is not terminated.
+ */
+int kmnd_line_split(kmnd_line_t *line, const char *string, const size_t length,
+                    const char *name, int *argc);
+
+/*
+ * This function prints the error for a line with a quote that is not
+ * terminated, followed by the usage of the given command.
+ */
+void kmnd_line_report(struct kmnd_command_s *command);
+
+/*
+ * This function frees the memory allocated by the line (but not the line
+ * itself).
+ */
+void kmnd_line_release(kmnd_line_t *line);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_line_h */
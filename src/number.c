@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "number.h"
+
+/*
+ * Eight decimal digits are converted at once (SWAR) on little-endian targets,
+ * where the first digit ends up in the lowest byte of the word.
+ */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define KMND_NUMBER_SWAR 1
+#endif
+
+#define KMND_NUMBER_ONES ((uint64_t) 0x0101010101010101ULL)
+
+/*
+ * These are the units of the SI (1000^n) and IEC (1024^n) suffixes, in order
+ * of their exponents. IEC suffixes are written with an uppercase `K`.
+ */
+static const char kmnd_number_units[] = "kMGTPE";
+
+static unsigned char kmnd_number_is_space(const char c) {
+    return c == ' ' || (unsigned char) (c - '\t') < 5;
+}
+
+/* This function returns the value of a hexadecimal digit, or 0xFF. */
+static unsigned int kmnd_number_digit(const char c) {
+    const unsigned int decimal = (unsigned char) c - '0';
+
+    if (decimal < 10)
+        return decimal;
+
+    const unsigned int letter = ((unsigned char) c | 0x20) - 'a';
+
+    if (letter < 6)
+        return letter + 10;
+
+    return 0xFF;
+}
+
+#if defined(KMND_NUMBER_SWAR)
+
+/* A byte is a digit if its high nibble is 3 and adding 6 does not carry into
+ * the high nibble. */
+static unsigned char kmnd_number_is_eight_digits(const uint64_t word) {
+    return ((word & KMND_NUMBER_ONES * 0xF0) |
+            (((word + KMND_NUMBER_ONES * 0x06) & KMND_NUMBER_ONES * 0xF0) >>
+             4)) == KMND_NUMBER_ONES * 0x33;
+}
+
+/* Adjacent digits are combined pairwise into 2, 4 and finally 8 digits, with
+ * one multiplication per step. */
+static uint64_t kmnd_number_eight_digits(uint64_t word) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+
+    word -= KMND_NUMBER_ONES * '0';
+    word = word * 10 + (word >> 8);
+
+    return (((word & mask) * (100 + (1000000ULL << 32))) +
+            (((word >> 16) & mask) * (1 + (10000ULL << 32)))) >> 32;
+}
+
+#endif /* KMND_NUMBER_SWAR */
+
+/*
+ * This function parses the magnitude and the sign of a number. It returns -1
+ * if the string is not a number or if the magnitude does not fit 64 bits.
+ */
+static int kmnd_number_parse(const char *string, const size_t length,
+                             unsigned char *negative, uint64_t *magnitude) {
+    size_t i = 0;
+
+    while (i < length && kmnd_number_is_space(string[i]))
+        i ++;
+
+    *negative = 0;
+
+    if (i < length && (string[i] == '+' || string[i] == '-')) {
+        *negative = string[i] == '-';
+        i ++;
+    }
+
+    /* This is the number of bits per digit, or 0 for decimal numbers. */
+    unsigned int shift = 0;
+
+    if (i + 1 < length && string[i] == '0') {
+        switch (string[i + 1] | 0x20) {
+            case 'x': shift = 4; break;
+            case 'o': shift = 3; break;
+            case 'b': shift = 1; break;
+        }
+
+        if (shift != 0)
+            i += 2;
+    }
+
+    uint64_t result = 0;
+    size_t num_digits = 0;
+
+    /* A separator must be preceded and followed by a digit. */
+    unsigned char separator = 0;
+
+    while (i < length) {
+        if (shift == 0) {
+#if defined(KMND_NUMBER_SWAR)
+            if (i + 8 <= length) {
+                uint64_t word;
+                memcpy(&word, string + i, 8);
+
+                if (kmnd_number_is_eight_digits(word)) {
+                    const uint64_t chunk = kmnd_number_eight_digits(word);
+
+                    if (result > (UINT64_MAX - chunk) / 100000000)
+                        return -1;
+
+                    result = result * 100000000 + chunk;
+                    num_digits += 8;
+                    separator = 0;
+                    i += 8;
+
+                    continue;
+                }
+            }
+#endif /* KMND_NUMBER_SWAR */
+
+            const unsigned int digit = (unsigned char) string[i] - '0';
+
+            if (digit < 10) {
+                if (result > (UINT64_MAX - digit) / 10)
+                    return -1;
+
+                result = result * 10 + digit;
+                num_digits ++;
+                separator = 0;
+                i ++;
+
+                continue;
+            }
+        }else {
+            const unsigned int digit = kmnd_number_digit(string[i]);
+
+            if (digit < (1u << shift)) {
+                if ((result >> (64 - shift)) != 0)
+                    return -1;
+
+                result = (result << shift) | digit;
+                num_digits ++;
+                separator = 0;
+                i ++;
+
+                continue;
+            }
+        }
+
+        if (string[i] != '_' || separator || num_digits == 0)
+            break;
+
+        separator = 1;
+        i ++;
+    }
+
+    if (num_digits == 0 || separator)
+        return -1;
+
+    if (i < length) {
+        const unsigned char iec = i + 1 < length && string[i + 1] == 'i';
+        char unit = string[i];
+
+        if (iec && unit == 'k')
+            return -1;
+
+        if (iec && unit == 'K')
+            unit = 'k';
+
+        const char *found = NULL;
+
+        if (unit != '\0')
+            found = strchr(kmnd_number_units, unit);
+
+        if (found == NULL)
+            return -1;
+
+        const uint64_t base = iec ? 1024 : 1000;
+
+        size_t exponent;
+        for (exponent = found - kmnd_number_units + 1; exponent > 0;
+             exponent --) {
+            if (result > UINT64_MAX / base)
+                return -1;
+
+            result *= base;
+        }
+
+        i += 1 + iec;
+    }
+
+    if (i != length)
+        return -1;
+
+    *magnitude = result;
+
+    return 0;
+}
+
+int kmnd_number_parse_unsigned(const char *string, const size_t length,
+                               const uint64_t max, uint64_t *value) {
+    unsigned char negative;
+    uint64_t magnitude;
+
+    if (kmnd_number_parse(string, length, &negative, &magnitude) != 0)
+        return -1;
+
+    if (negative || magnitude > max)
+        return -1;
+
+    *value = magnitude;
+
+    return 0;
+}
+
+int kmnd_number_parse_signed(const char *string, const size_t length,
+                             const int64_t min, const int64_t max,
+                             int64_t *value) {
+    unsigned char negative;
+    uint64_t magnitude;
+
+    if (kmnd_number_parse(string, length, &negative, &magnitude) != 0)
+        return -1;
+
+    if (negative) {
+        /* This is the magnitude of `min`, computed without overflowing. */
+        const uint64_t limit = min < 0 ? (uint64_t) -(min + 1) + 1 : 0;
+
+        if (magnitude > limit)
+            return -1;
+
+        *value = magnitude == 0 ? 0 : -(int64_t) (magnitude - 1) - 1;
+    }else {
+        if (max < 0 || magnitude > (uint64_t) max)
+            return -1;
+
+        *value = (int64_t) magnitude;
+    }
+
+    return 0;
+}
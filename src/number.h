@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_number_h
+#define __kmnd_number_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * This function parses the first `length` bytes of `string` as an unsigned
+ * integer and stores it in `value`. The number may be preceded by whitespace
+ * and a `+`, may start with a `0x`, `0o` or `0b` prefix, may contain `_`
+ * between digits and may end with an SI (`k`, `M`, `G`, `T`, `P`, `E`) or IEC
+ * (`Ki`, `Mi`, `Gi`, `Ti`, `Pi`, `Ei`) suffix. It returns -1 if the string is
+ * not a number or if the number is larger than `max`.
+ */
+int kmnd_number_parse_unsigned(const char *string, const size_t length,
+                               const uint64_t max, uint64_t *value);
+
+/**
+ * This function is similar to kmnd_number_parse_unsigned but also accepts a
+ * `-` sign. It returns -1 if the number is not in the range `[min, max]`.
+ */
+int kmnd_number_parse_signed(const char *string, const size_t length,
+                             const int64_t min, const int64_t max,
+                             int64_t *value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_number_h */
@@ -21,69 +21,156 @@
  */
 
 #include <assert.h>
-#include <ctype.h>
-#include <errno.h>
-#include <inttypes.h>
-#include <locale.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocator.h"
 #include "command.h"
 #include "error.h"
+#include "number.h"
 #include "option.h"
 #include "path.h"
+#include "real.h"
+#include "result.h"
 #include "usage.h"
 
 static kmnd_option_t *kmnd_option_new(const char character, const char *name,
                                       const char *description,
-                                      const kmnd_flags_t flags) {
-    kmnd_option_t *option = malloc(sizeof(kmnd_option_t));
+                                      const kmnd_flags_t flags,
+                                      const kmnd_value_t type) {
+    const kmnd_allocator_t *allocator = kmnd_allocator_current();
+    kmnd_option_t *option = kmnd_allocate(allocator, sizeof(kmnd_option_t));
 
     if (option == NULL)
         return NULL;
 
-    memset(option, 0, sizeof(kmnd_option_t));
-
+    option->core.allocator = allocator;
     option->core.type = KMND_TYPE_OPTION;
     option->character = character;
     option->core.name = name;
     option->core.description = description;
     option->flags = flags;
+    option->type = type;
+    option->value = &option->storage;
 
     return option;
 }
 
 void kmnd_option_free(kmnd_option_t *option) {
-    free(option->value);
+    const kmnd_allocator_t *allocator = option->core.allocator;
+
+    kmnd_release(allocator, option->string);
+    kmnd_release(allocator, option->initial_string);
 
     memset(option, 0, sizeof(kmnd_option_t));
-    free(option);
+    kmnd_release(allocator, option);
+}
+
+size_t kmnd_value_size(const kmnd_value_t type) {
+    switch (type) {
+        case KMND_VALUE_BOOLEAN: return sizeof(unsigned char);
+        case KMND_VALUE_STRING:  return sizeof(const char *);
+        case KMND_VALUE_INT8:    return sizeof(int8_t);
+        case KMND_VALUE_INT16:   return sizeof(int16_t);
+        case KMND_VALUE_INT32:   return sizeof(int32_t);
+        case KMND_VALUE_INT64:   return sizeof(int64_t);
+        case KMND_VALUE_UINT8:   return sizeof(uint8_t);
+        case KMND_VALUE_UINT16:  return sizeof(uint16_t);
+        case KMND_VALUE_UINT32:  return sizeof(uint32_t);
+        case KMND_VALUE_UINT64:  return sizeof(uint64_t);
+        case KMND_VALUE_FLOAT:   return sizeof(float);
+        case KMND_VALUE_DOUBLE:  return sizeof(double);
+    }
+
+    return 0;
 }
 
-void kmnd_option_flag(kmnd_t *kmnd, kmnd_option_t *option) {
+/*
+ * This function returns the option that the given handle refers to.
+ */
+static kmnd_option_t *kmnd_option_handle(kmnd_handle_t handle) {
+    kmnd_option_t *option = (kmnd_option_t *) handle;
+    assert(option != NULL && option->core.type == KMND_TYPE_OPTION);
+
+    return option;
+}
+
+/*
+ * This function keeps the value of the option before it is first changed, so
+ * that kmnd_command_reset can restore it.
+ */
+static void kmnd_option_touch(kmnd_t *kmnd, kmnd_option_t *option) {
+    if (option->touched || kmnd->type != KMND_TYPE_COMMAND)
+        return;
+
+    kmnd_command_t *root = kmnd_command_root((kmnd_command_t *) kmnd);
+
+    memcpy(&option->initial, option->value, kmnd_value_size(option->type));
+    option->initial_length = option->length;
+
+    /* The initial string must outlive the strings that replace it. */
+    option->initial_string = option->string;
+    option->string = NULL;
+
+    option->touched = 1;
+    option->next_touched = root->touched_options;
+    root->touched_options = option;
+}
+
+void kmnd_option_reset(kmnd_option_t *option) {
+    assert(option->touched);
+
+    kmnd_release(option->core.allocator, option->string);
+    option->string = option->initial_string;
+    option->initial_string = NULL;
+
+    memcpy(option->value, &option->initial, kmnd_value_size(option->type));
+    option->length = option->initial_length;
+
+    option->activated = 0;
+    option->touched = 0;
+    option->next_touched = NULL;
+}
+
+int kmnd_option_flag(kmnd_t *kmnd, kmnd_option_t *option) {
     if (option->flag == NULL) {
         kmnd_error_t error;
         kmnd_error_init_not_a_boolean(&error, option->core.name);
         kmnd_error_print(&error, kmnd);
-        exit(1);
-    }else
-        option->flag(option);
+
+        kmnd_command_t *command = (kmnd_command_t *) kmnd;
+
+        if (command->usage)
+            kmnd_usage_print(command->usage, command);
+
+        return -1;
+    }
+
+    kmnd_option_touch(kmnd, option);
+    option->flag(option, option->value);
+
+    return 0;
 }
 
 /** -- boolean -- */
 
-static void kmnd_boolean_flag(kmnd_option_t *option) {
-    ((unsigned char *) option->value)[0] = 1;
+static void kmnd_boolean_flag(const kmnd_option_t *option, void *value) {
+    (void) option;
+
+    ((unsigned char *) value)[0] = 1;
 }
 
-static int kmnd_boolean_parse(kmnd_option_t *option, const char *string) {
+static int kmnd_boolean_parse(const kmnd_option_t *option, const char *string,
+                              void *value) {
+    (void) option;
+
     if (strcmp(string, "1")    == 0 || strcmp(string, "on")  == 0 ||
         strcmp(string, "true") == 0 || strcmp(string, "yes") == 0) {
-        ((unsigned char *) option->value)[0] = 1;
+        ((unsigned char *) value)[0] = 1;
         return 0;
     }else if (strcmp(string, "0")     == 0 || strcmp(string, "off") == 0 ||
               strcmp(string, "false") == 0 || strcmp(string, "no")  == 0) {
-        ((unsigned char *) option->value)[0] = 0;
+        ((unsigned char *) value)[0] = 0;
         return 0;
     }
 
@@ -94,17 +181,13 @@ kmnd_t *kmnd_boolean_new(const char character, const char *name,
                          const char *description, const kmnd_flags_t flags,
                          const unsigned char value) {
     kmnd_option_t *option;
-    option = kmnd_option_new(character, name, description, flags);
+    option = kmnd_option_new(character, name, description, flags,
+                             KMND_VALUE_BOOLEAN);
 
     if (option == NULL)
         return NULL;
 
-    option->value = malloc(1);
-
-    if (option->value == NULL)
-        return NULL;
-
-    ((unsigned char *) option->value)[0] = value;
+    option->storage.boolean = value;
 
     option->flag = kmnd_boolean_flag;
     option->parse = kmnd_boolean_parse;
@@ -112,18 +195,67 @@ kmnd_t *kmnd_boolean_new(const char character, const char *name,
     return (kmnd_t *) option;
 }
 
+kmnd_t *kmnd_boolean_bind(const char character, const char *name,
+                          const char *description, const kmnd_flags_t flags,
+                          unsigned char *variable) {
+    kmnd_option_t *option;
+    option = (kmnd_option_t *) kmnd_boolean_new(character, name, description,
+                                                flags, *variable);
+
+    if (option != NULL)
+        option->value = variable;
+
+    return (kmnd_t *) option;
+}
+
 unsigned char kmnd_boolean_get(kmnd_t *kmnd, const char *path) {
     kmnd_option_t *option = kmnd_option_path(kmnd, path);
     assert(option != NULL);
 
-    return ((unsigned char *) option->value)[0];
+    return ((const unsigned char *) kmnd_option_current(option, NULL))[0];
+}
+
+unsigned char kmnd_boolean_value(kmnd_handle_t handle) {
+    kmnd_option_t *option = kmnd_option_handle(handle);
+
+    return ((const unsigned char *) kmnd_option_current(option, NULL))[0];
 }
 
 /** -- String Options -- */
 
-static int kmnd_string_parse(kmnd_option_t *option, const char *string) {
-    free(option->value);
-    option->value = strdup(string);
+/*
+ * This function stores a string in a result, where it is not copied (see
+ * kmnd_parse).
+ */
+static int kmnd_string_parse(const kmnd_option_t *option, const char *string,
+                             void *value) {
+    (void) option;
+
+    *((const char **) value) = string;
+
+    return 0;
+}
+
+/*
+ * This function stores a string in the option itself, where it is copied
+ * unless the option borrows its arguments (see kmnd_borrow).
+ */
+static int kmnd_string_store(kmnd_option_t *option, const char *string) {
+    const kmnd_allocator_t *allocator = option->core.allocator;
+    char *copy = NULL;
+
+    if (!option->borrow) {
+        copy = kmnd_duplicate(allocator, string);
+
+        if (copy == NULL)
+            return -1;
+    }
+
+    kmnd_release(allocator, option->string);
+    option->string = copy;
+    option->length = strlen(string);
+
+    *((const char **) option->value) = copy != NULL ? copy : string;
 
     return 0;
 }
@@ -132,62 +264,101 @@ kmnd_t *kmnd_string_new(const char character, const char *name,
                         const char *description, const kmnd_flags_t flags,
                         const char *value) {
     kmnd_option_t *option;
-    option = kmnd_option_new(character, name, description, flags);
+    option = kmnd_option_new(character, name, description, flags,
+                             KMND_VALUE_STRING);
 
     if (option == NULL)
         return NULL;
 
-    option->value = value ? strdup(value) : NULL;
+    if (value != NULL) {
+        option->string = kmnd_duplicate(option->core.allocator, value);
+
+        if (option->string == NULL) {
+            kmnd_free((kmnd_t *) option);
+            return NULL;
+        }
+
+        option->length = strlen(value);
+    }
+
+    option->storage.string = option->string;
 
     option->parse = kmnd_string_parse;
 
     return (kmnd_t *) option;
 }
 
+kmnd_t *kmnd_string_bind(const char character, const char *name,
+                         const char *description, const kmnd_flags_t flags,
+                         const char **variable) {
+    kmnd_option_t *option;
+    option = (kmnd_option_t *) kmnd_string_new(character, name, description,
+                                               flags, NULL);
+
+    if (option != NULL) {
+        option->value = (void *) variable;
+        option->length = *variable != NULL ? strlen(*variable) : 0;
+    }
+
+    return (kmnd_t *) option;
+}
+
 const char *kmnd_string_get(kmnd_t *kmnd, const char *path) {
     kmnd_option_t *option = kmnd_option_path(kmnd, path);
     assert(option != NULL);
 
-    return ((const char *) option->value);
+    return *((const char *const *) kmnd_option_current(option, NULL));
 }
 
-/** -- Float Options -- */
+const char *kmnd_string_value(kmnd_handle_t handle) {
+    kmnd_option_t *option = kmnd_option_handle(handle);
+
+    return *((const char *const *) kmnd_option_current(option, NULL));
+}
+
+const char *kmnd_string_view(kmnd_t *kmnd, const char *path,
+                             size_t *length) {
+    kmnd_option_t *option = kmnd_option_path(kmnd, path);
+    assert(option != NULL);
 
-static int kmnd_float_parse(kmnd_option_t *option, const char *string) {
-    errno = 0;
-    char *end = NULL;
+    return *((const char *const *) kmnd_option_current(option, length));
+}
 
-    char *locale = setlocale(LC_NUMERIC,"C");
-    float value = strtof(string, &end);
-    setlocale(LC_NUMERIC, locale);
+/** -- Float Options -- */
 
-    if ((end == NULL || end[0] == 0) && errno == 0) {
-        *((float *) option->value) = value;
-        return 0;
-    }
+static int kmnd_float_parse(const kmnd_option_t *option, const char *string,
+                            void *value) {
+    (void) option;
 
-    return -1;
+    return kmnd_real_parse_float(string, strlen(string), (float *) value);
 }
 
 kmnd_t *kmnd_float_new(const char character, const char *name,
                        const char *description, const kmnd_flags_t flags,
                        const float value) {
     kmnd_option_t *option;
-    option = kmnd_option_new(character, name, description, flags);
+    option = kmnd_option_new(character, name, description, flags,
+                             KMND_VALUE_FLOAT);
 
     if (option == NULL)
         return NULL;
 
-    option->value = malloc(sizeof(float));
+    option->storage.real = value;
 
-    if (option->value == NULL) {
-        kmnd_free((kmnd_t *) option);
-        return NULL;
-    }
+    option->parse = kmnd_float_parse;
 
-    *((float *) option->value) = value;
+    return (kmnd_t *) option;
+}
 
-    option->parse = kmnd_float_parse;
+kmnd_t *kmnd_float_bind(const char character, const char *name,
+                        const char *description, const kmnd_flags_t flags,
+                        float *variable) {
+    kmnd_option_t *option;
+    option = (kmnd_option_t *) kmnd_float_new(character, name, description,
+                                              flags, *variable);
+
+    if (option != NULL)
+        option->value = variable;
 
     return (kmnd_t *) option;
 }
@@ -196,46 +367,50 @@ float kmnd_float_get(kmnd_t *kmnd, const char *path) {
     kmnd_option_t *option = kmnd_option_path(kmnd, path);
     assert(option != NULL);
 
-    return *((float *) option->value);
+    return *((const float *) kmnd_option_current(option, NULL));
 }
 
-/** -- Double Options -- */
+float kmnd_float_value(kmnd_handle_t handle) {
+    kmnd_option_t *option = kmnd_option_handle(handle);
 
-static int kmnd_double_parse(kmnd_option_t *option, const char *string) {
-    errno = 0;
-    char *end = NULL;
+    return *((const float *) kmnd_option_current(option, NULL));
+}
 
-    char *locale = setlocale(LC_NUMERIC,"C");
-    double value = strtod(string, &end);
-    setlocale(LC_NUMERIC, locale);
+/** -- Double Options -- */
 
-    if ((end == NULL || end[0] == 0) && errno == 0) {
-        *((double *) option->value) = value;
-        return 0;
-    }
+static int kmnd_double_parse(const kmnd_option_t *option, const char *string,
+                             void *value) {
+    (void) option;
 
-    return -1;
+    return kmnd_real_parse_double(string, strlen(string), (double *) value);
 }
 
 kmnd_t *kmnd_double_new(const char character, const char *name,
                         const char *description, const kmnd_flags_t flags,
                         const double value) {
     kmnd_option_t *option;
-    option = kmnd_option_new(character, name, description, flags);
+    option = kmnd_option_new(character, name, description, flags,
+                             KMND_VALUE_DOUBLE);
 
     if (option == NULL)
         return NULL;
 
-    option->value = malloc(sizeof(double));
+    option->storage.real64 = value;
 
-    if (option->value == NULL) {
-        kmnd_free((kmnd_t *) option);
-        return NULL;
-    }
+    option->parse = kmnd_double_parse;
+
+    return (kmnd_t *) option;
+}
 
-    *((double *) option->value) = value;
+kmnd_t *kmnd_double_bind(const char character, const char *name,
+                         const char *description, const kmnd_flags_t flags,
+                         double *variable) {
+    kmnd_option_t *option;
+    option = (kmnd_option_t *) kmnd_double_new(character, name, description,
+                                               flags, *variable);
 
-    option->parse = kmnd_double_parse;
+    if (option != NULL)
+        option->value = variable;
 
     return (kmnd_t *) option;
 }
@@ -244,31 +419,45 @@ double kmnd_double_get(kmnd_t *kmnd, const char *path) {
     kmnd_option_t *option = kmnd_option_path(kmnd, path);
     assert(option != NULL);
 
-    return *((double *) option->value);
+    return *((const double *) kmnd_option_current(option, NULL));
+}
+
+double kmnd_double_value(kmnd_handle_t handle) {
+    kmnd_option_t *option = kmnd_option_handle(handle);
+
+    return *((const double *) kmnd_option_current(option, NULL));
 }
 
 /** -- Scalar Options -- */
 
-#define kmnd_scalar_new(N, T) \
+#define kmnd_scalar_new(N, T, V) \
     kmnd_t *kmnd_##N##_new(const char character, const char *name, \
                            const char *description, const kmnd_flags_t flags, \
                            const T value) { \
         kmnd_option_t *option; \
-        option = kmnd_option_new(character, name, description, flags); \
+        option = kmnd_option_new(character, name, description, flags, \
+                                 KMND_VALUE_##V); \
         \
         if (option == NULL) \
             return NULL; \
         \
-        option->value = malloc(sizeof(T)); \
+        option->storage.N = value; \
         \
-        if (option->value == NULL) { \
-            kmnd_free((kmnd_t *) option); \
-            return NULL; \
-        } \
+        option->parse = kmnd_##N##_parse; \
         \
-        *((T *) option->value) = value; \
+        return (kmnd_t *) option; \
+    } \
+    \
+    kmnd_t *kmnd_##N##_bind(const char character, const char *name, \
+                            const char *description, \
+                            const kmnd_flags_t flags, T *variable) { \
+        kmnd_option_t *option; \
+        option = (kmnd_option_t *) kmnd_##N##_new(character, name, \
+                                                  description, flags, \
+                                                  *variable); \
         \
-        option->parse = kmnd_##N##_parse; \
+        if (option != NULL) \
+            option->value = variable; \
         \
         return (kmnd_t *) option; \
     }
@@ -278,62 +467,60 @@ double kmnd_double_get(kmnd_t *kmnd, const char *path) {
         kmnd_option_t *option = kmnd_option_path(kmnd, path); \
         assert(option != NULL); \
         \
-        return *((T *) option->value); \
+        return *((const T *) kmnd_option_current(option, NULL)); \
+    } \
+    \
+    T kmnd_##N##_value(kmnd_handle_t handle) { \
+        kmnd_option_t *option = kmnd_option_handle(handle); \
+        \
+        return *((const T *) kmnd_option_current(option, NULL)); \
     }
 
-static unsigned char kmnd_scalar_is_negative(const char *string) {
-    size_t i, l = strlen(string);
-    for (i = 0; i < l; i ++) {
-        if (string[i] == '-')
-            return 1;
-
-        if (!isspace(string[i]))
-            break;
+#define kmnd_signed_parse(N, T, I, A) \
+    static int kmnd_##N##_parse(const kmnd_option_t *option, \
+                                const char *string, void *value) { \
+        int64_t result; \
+        (void) option; \
+        if (kmnd_number_parse_signed(string, strlen(string), I, A, \
+                                     &result) != 0) \
+            return -1; \
+        \
+        *((T *) value) = (T) result; \
+        \
+        return 0; \
     }
 
-    return 0;
-}
-
-#define kmnd_scalar_parse(N, T, S, F, I, A) \
-    static int kmnd_##N##_parse(kmnd_option_t *option, const char *string) { \
-        if (I == 0 && kmnd_scalar_is_negative(string)) \
+#define kmnd_unsigned_parse(N, T, A) \
+    static int kmnd_##N##_parse(const kmnd_option_t *option, \
+                                const char *string, void *value) { \
+        uint64_t result; \
+        (void) option; \
+        if (kmnd_number_parse_unsigned(string, strlen(string), A, \
+                                       &result) != 0) \
             return -1; \
         \
-        char *end = NULL; \
-        errno = 0; \
-        F value = strto##S##max(string, &end, 10); \
-        if ((end == NULL || end[0] == 0) && errno == 0) { \
-            if (value < I || value > A) \
-                return -1; \
-            \
-            *((T *) option->value) = value; \
-            \
-            return 0; \
-        } \
+        *((T *) value) = (T) result; \
         \
-        return -1; \
+        return 0; \
     }
 
-
-
-
-kmnd_scalar_parse(int8,   int8_t,   i, intmax_t,  INT8_MIN,  INT8_MAX)
-kmnd_scalar_parse(int16,  int16_t,  i, intmax_t,  INT16_MIN, INT16_MAX)
-kmnd_scalar_parse(int32,  int32_t,  i, intmax_t,  INT32_MIN, INT32_MAX)
-kmnd_scalar_parse(int64,  int64_t,  i, intmax_t,  INT64_MIN, INT64_MAX)
-kmnd_scalar_parse(uint8,  uint8_t,  u, uintmax_t, 0,         UINT8_MAX)
-kmnd_scalar_parse(uint16, uint16_t, u, uintmax_t, 0,         UINT16_MAX)
-kmnd_scalar_parse(uint32, uint32_t, u, uintmax_t, 0,         UINT32_MAX)
-kmnd_scalar_parse(uint64, uint64_t, u, uintmax_t, 0,         UINT64_MAX)
-
-kmnd_scalar_new(int8,   int8_t)
-kmnd_scalar_new(int16,  int16_t)
-kmnd_scalar_new(int32,  int32_t)
-kmnd_scalar_new(int64,  int64_t)
-kmnd_scalar_new(uint8,  uint8_t)
-kmnd_scalar_new(uint16, uint16_t)
-kmnd_scalar_new(uint32, uint32_t)
-kmnd_scalar_new(uint64, uint64_t)
+kmnd_signed_parse(int8,     int8_t,   INT8_MIN,  INT8_MAX)
+kmnd_signed_parse(int16,    int16_t,  INT16_MIN, INT16_MAX)
+kmnd_signed_parse(int32,    int32_t,  INT32_MIN, INT32_MAX)
+kmnd_signed_parse(int64,    int64_t,  INT64_MIN, INT64_MAX)
+kmnd_unsigned_parse(uint8,  uint8_t,  UINT8_MAX)
+kmnd_unsigned_parse(uint16, uint16_t, UINT16_MAX)
+kmnd_unsigned_parse(uint32, uint32_t, UINT32_MAX)
+kmnd_unsigned_parse(uint64, uint64_t, UINT64_MAX)
+
+kmnd_scalar_new(int8,   int8_t,   INT8)
+kmnd_scalar_new(int16,  int16_t,  INT16)
+kmnd_scalar_new(int32,  int32_t,  INT32)
+kmnd_scalar_new(int64,  int64_t,  INT64)
+kmnd_scalar_new(uint8,  uint8_t,  UINT8)
+kmnd_scalar_new(uint16, uint16_t, UINT16)
+kmnd_scalar_new(uint32, uint32_t, UINT32)
+kmnd_scalar_new(uint64, uint64_t, UINT64)
 
 kmnd_scalar_get(int8,   int8_t)
 kmnd_scalar_get(int16,  int16_t)
@@ -351,16 +538,51 @@ unsigned char kmnd_option_required(const kmnd_option_t *option) {
 }
 
 unsigned char kmnd_option_activated(const kmnd_option_t *option) {
+    const kmnd_result_slot_t *slot = kmnd_result_slot(option->root,
+                                                      option->slot);
+
+    if (slot != NULL)
+        return slot->activated;
+
     return option->activated;
 }
 
+const void *kmnd_option_current(const kmnd_option_t *option, size_t *length) {
+    const kmnd_result_slot_t *slot = kmnd_result_slot(option->root,
+                                                      option->slot);
+
+    if (slot != NULL) {
+        if (length != NULL)
+            *length = slot->length;
+
+        return &slot->value;
+    }
+
+    if (length != NULL)
+        *length = option->length;
+
+    return option->value;
+}
+
 int kmnd_option_activate(kmnd_t *kmnd, kmnd_option_t *option,
                          const char *string) {
     int res;
 
     assert(option->parse != NULL);
 
-    if ((res = option->parse(option, string)) != 0) {
+    if (kmnd->type == KMND_TYPE_COMMAND)
+        option->borrow = kmnd_command_borrows((kmnd_command_t *) kmnd);
+
+    kmnd_option_touch(kmnd, option);
+
+    /* Strings are copied into the option, whereas the parse callback of a
+     * string option only stores the string itself. */
+    if (option->type == KMND_VALUE_STRING)
+        res = kmnd_string_store(option, string);
+    else
+        res = option->parse(option, string, option->value);
+
+    if (res != 0) {
         kmnd_error_t error;
         kmnd_error_init_invalid_value(&error, option->core.name, string);
         kmnd_error_print(&error, kmnd);
@@ -29,12 +29,41 @@ extern "C" {
 
 typedef struct kmnd_option_s kmnd_option_t;
 
-typedef void (kmnd_option_flag_cb)(kmnd_option_t *option);
+/*
+ * These callbacks write the value of an option that is given without a value
+ * (flag) or with a string (parse) to `value`, which points to a value of the
+ * type of the option (a `const char *` for string options). They do not modify
+ * the option itself.
+ */
+typedef void (kmnd_option_flag_cb)(const kmnd_option_t *option, void *value);
+
+typedef int (kmnd_option_parse_cb)(const kmnd_option_t *option,
+                                   const char *string, void *value);
 
-typedef int (kmnd_option_parse_cb)(kmnd_option_t *option, const char *string);
+#include <stddef.h>
+#include <stdint.h>
 
 #include "core.h"
 
+/*
+ * This is where the value of an option is stored unless it is bound to a
+ * variable of the caller.
+ */
+typedef union kmnd_option_storage_u {
+    unsigned char boolean;
+    const char *string;
+    int8_t int8;
+    int16_t int16;
+    int32_t int32;
+    int64_t int64;
+    uint8_t uint8;
+    uint16_t uint16;
+    uint32_t uint32;
+    uint64_t uint64;
+    float real;
+    double real64;
+} kmnd_option_storage_t;
+
 struct kmnd_option_s {
     kmnd_t core;
 
@@ -42,24 +71,80 @@ struct kmnd_option_s {
 
     kmnd_flags_t flags;
 
+    /* This is the type of the value (see kmnd_load). */
+    kmnd_value_t type;
+
     kmnd_option_flag_cb *flag;
     kmnd_option_parse_cb *parse;
 
+    /* This points to the value, which is either `storage` or the variable that
+     * the option is bound to (see kmnd_X_bind). The value of a string option
+     * is a pointer to the string. */
     void *value;
+    kmnd_option_storage_t storage;
+
+    /* This is the copy of the last string that was parsed by a string option,
+     * which is owned by the option, and the length of the current string. */
+    char *string;
+    size_t length;
+
+    /* This is set if the next string that is parsed is used as-is instead of
+     * copied (see kmnd_borrow). */
+    unsigned char borrow;
 
     unsigned char activated;
+
+    /* This is the root of the frozen tree that the option belongs to and the
+     * position of its value in a result (see kmnd_freeze). */
+    const kmnd_t *root;
+    size_t slot;
+
+    /* This is set once the option is changed after the tree was last reset,
+     * in which case its value before the change is kept in `initial` (and the
+     * copy of its initial string in `initial_string`) and the option is part
+     * of the list of changed options of the root command (see
+     * kmnd_command_reset). */
+    unsigned char touched;
+    kmnd_option_storage_t initial;
+    size_t initial_length;
+    char *initial_string;
+    kmnd_option_t *next_touched;
 };
 
+/*
+ * This function returns the number of bytes of values of the given type.
+ */
+size_t kmnd_value_size(const kmnd_value_t type);
+
 void kmnd_option_free(kmnd_option_t *option);
 
-void kmnd_option_flag(kmnd_t *kmnd, kmnd_option_t *option);
+/**
+ * This function activates the given option without a value, which is only
+ * possible for booleans. Otherwise it prints an error along with the usage
+ * text of the given command and returns -1.
+ */
+int kmnd_option_flag(kmnd_t *kmnd, kmnd_option_t *option);
 
 int kmnd_option_activate(kmnd_t *kmnd, kmnd_option_t *option,
                          const char *string);
 
+/*
+ * This function restores the value that the option had before it was changed
+ * (see kmnd_command_reset).
+ */
+void kmnd_option_reset(kmnd_option_t *option);
+
 unsigned char kmnd_option_required(const kmnd_option_t *option);
 unsigned char kmnd_option_activated(const kmnd_option_t *option);
 
+/*
+ * This function returns a pointer to the current value of the option, which
+ * is the value in the result that is being run on this thread if there is one
+ * (see kmnd_result_run). The length of a string value is stored in `length`
+ * if it is not NULL.
+ */
+const void *kmnd_option_current(const kmnd_option_t *option, size_t *length);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -26,22 +26,39 @@
 #include "command.h"
 #include "path.h"
 
+/*
+ * This function returns whether the given name is exactly equal to the first
+ * `length` bytes of `string`.
+ */
+static unsigned char kmnd_name_equals(const char *name, const char *string,
+                                      const size_t length) {
+    return (unsigned char) (strncmp(name, string, length) == 0 &&
+                            name[length] == '\0');
+}
+
 static kmnd_t *kmnd_find(kmnd_command_t *command, const char *name,
                          const size_t length) {
+    /* The trie is used once the command has been finalized. */
+    if (command->trie.nodes != NULL)
+        return kmnd_trie_find(&command->trie, name, length);
+
+    if (kmnd_command_expand(command) != 0)
+        return NULL;
+
     size_t i;
 
     for (i = 0; i < command->num_commands; i ++) {
-        if (strncmp(command->commands[i]->core.name, name, length) == 0)
+        if (kmnd_name_equals(command->commands[i]->core.name, name, length))
             return (kmnd_t *) command->commands[i];
     }
 
     for (i = 0; i < command->num_options; i ++) {
-        if (strncmp(command->options[i]->core.name, name, length) == 0)
+        if (kmnd_name_equals(command->options[i]->core.name, name, length))
             return (kmnd_t *) command->options[i];
     }
 
     for (i = 0; i < command->num_inputs; i ++) {
-        if (strncmp(command->inputs[i]->core.name, name, length) == 0)
+        if (kmnd_name_equals(command->inputs[i]->core.name, name, length))
             return (kmnd_t *) command->inputs[i];
     }
 
@@ -49,7 +66,7 @@ static kmnd_t *kmnd_find(kmnd_command_t *command, const char *name,
 }
 
 kmnd_t *kmnd_path(kmnd_t *kmnd, const char *path) {
-    if (path == NULL || strlen(path) == 0)
+    if (path == NULL || path[0] == '\0')
         return kmnd;
 
     kmnd_command_t *command = (kmnd_command_t *) kmnd;
@@ -62,7 +79,7 @@ kmnd_t *kmnd_path(kmnd_t *kmnd, const char *path) {
     }
 
     size_t i, j = 0;
-    for (i = 0; i <= strlen(path); i ++) {
+    for (i = 0; ; i ++) {
         if (path[i] == '.') {
             command = (kmnd_command_t *) kmnd_find(command, path + j, i - j);
 
@@ -74,8 +91,6 @@ kmnd_t *kmnd_path(kmnd_t *kmnd, const char *path) {
             return kmnd_find(command, path + j, i - j);
         }
     }
-
-    return NULL;
 }
 
 kmnd_command_t *kmnd_command_path(kmnd_t *kmnd, const char *path) {
@@ -104,3 +119,28 @@ kmnd_input_t *kmnd_input_path(kmnd_t *kmnd, const char *path) {
 
     return (kmnd_input_t *) result;
 }
+
+kmnd_handle_t kmnd_resolve(kmnd_t *kmnd, const char *path) {
+    kmnd_t *result = kmnd_path(kmnd, path);
+
+    if (result == NULL || (result->type != KMND_TYPE_OPTION &&
+                           result->type != KMND_TYPE_INPUT))
+        return NULL;
+
+    return (kmnd_handle_t) result;
+}
+
+kmnd_handle_t kmnd_resolve_cached(kmnd_handle_cache_t *cache, kmnd_t *kmnd,
+                                  const char *path) {
+    if (kmnd->type != KMND_TYPE_COMMAND)
+        return kmnd_resolve(kmnd, path);
+
+    const unsigned long generation = ((kmnd_command_t *) kmnd)->generation;
+
+    if (cache->generation != generation) {
+        cache->handle = kmnd_resolve(kmnd, path);
+        cache->generation = generation;
+    }
+
+    return cache->handle;
+}
@@ -0,0 +1,975 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <float.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "real.h"
+#include "real_table.h"
+
+/*
+ * Small integers that are multiplied or divided by small powers of ten are
+ * computed exactly with native arithmetic (Clinger's fast path), unless the
+ * compiler evaluates with extra precision, which would round twice.
+ */
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define KMND_REAL_CLINGER 1
+#endif
+
+/*
+ * This is the maximum number of significant digits that fit in the 64-bit
+ * mantissa of a decimal.
+ */
+#define KMND_REAL_MANTISSA_DIGITS 19
+
+/*
+ * This is the number of digits that the exact fallback keeps. Digits beyond
+ * it only matter to break ties, for which a flag is kept instead.
+ */
+#define KMND_REAL_MAX_DIGITS 800
+
+/*
+ * This is the largest number of bits by which a decimal is shifted at once,
+ * such that the intermediate products fit in 64 bits.
+ */
+#define KMND_REAL_MAX_SHIFT 60
+
+/*
+ * Exponents beyond this limit overflow or underflow either way, so they are
+ * clamped while they are parsed.
+ */
+#define KMND_REAL_MAX_EXPONENT 100000
+
+typedef struct kmnd_real_format_s {
+    int mantissa_bits;
+    int infinite_power;
+    int minimum_exponent;
+
+    /* These are the smallest and largest powers of ten for which a decimal
+     * with at most 19 digits is neither zero nor infinite. */
+    int smallest_power;
+    int largest_power;
+
+    /* Ties can only occur for powers of ten within this range. */
+    int min_round_to_even;
+    int max_round_to_even;
+} kmnd_real_format_t;
+
+static const kmnd_real_format_t kmnd_real_double = {
+    52, 0x7FF, -1023, -342, 308, -4, 23
+};
+
+static const kmnd_real_format_t kmnd_real_float = {
+    23, 0xFF, -127, -65, 38, -17, 10
+};
+
+#if defined(KMND_REAL_CLINGER)
+
+static const double kmnd_real_exact_double[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const float kmnd_real_exact_float[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+#endif /* KMND_REAL_CLINGER */
+
+typedef enum kmnd_real_type_e {
+    KMND_REAL_TYPE_DECIMAL,
+    KMND_REAL_TYPE_HEXADECIMAL,
+    KMND_REAL_TYPE_INFINITY,
+    KMND_REAL_TYPE_NAN
+} kmnd_real_type_t;
+
+/*
+ * This is the result of scanning a number. A decimal is `mantissa * 10^power`
+ * (which is inexact if `truncated` is set, in which case the digits are
+ * between `digits` and `end`). A hexadecimal number is `mantissa * 2^power`,
+ * where `truncated` indicates that non-zero bits were dropped.
+ */
+typedef struct kmnd_real_number_s {
+    kmnd_real_type_t type;
+    unsigned char negative;
+
+    uint64_t mantissa;
+    int64_t power;
+    unsigned char truncated;
+
+    const char *digits;
+    const char *end;
+    int64_t exponent;
+} kmnd_real_number_t;
+
+/*
+ * This is a decimal with arbitrary precision (up to KMND_REAL_MAX_DIGITS) that
+ * the exact fallback works with. Its value is `0.digits * 10^point`.
+ */
+typedef struct kmnd_real_decimal_s {
+    unsigned char digits[KMND_REAL_MAX_DIGITS];
+    int num_digits;
+    int point;
+    unsigned char truncated;
+} kmnd_real_decimal_t;
+
+typedef struct kmnd_real_u128_s {
+    uint64_t high;
+    uint64_t low;
+} kmnd_real_u128_t;
+
+static kmnd_real_u128_t kmnd_real_multiply(const uint64_t a, const uint64_t b) {
+    kmnd_real_u128_t result;
+
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = (unsigned __int128) a * b;
+
+    result.high = (uint64_t) (product >> 64);
+    result.low = (uint64_t) product;
+#else
+    const uint64_t a_low = (uint32_t) a, a_high = a >> 32;
+    const uint64_t b_low = (uint32_t) b, b_high = b >> 32;
+
+    const uint64_t low = a_low * b_low, middle_low = a_low * b_high,
+                   middle_high = a_high * b_low, high = a_high * b_high;
+
+    const uint64_t middle = (low >> 32) + (uint32_t) middle_low +
+                            (uint32_t) middle_high;
+
+    result.low = (middle << 32) | (uint32_t) low;
+    result.high = high + (middle_low >> 32) + (middle_high >> 32) +
+                  (middle >> 32);
+#endif
+
+    return result;
+}
+
+static int kmnd_real_leading_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+
+    while ((value >> 63) == 0) {
+        value <<= 1;
+        count ++;
+    }
+
+    return count;
+#endif
+}
+
+static unsigned char kmnd_real_is_space(const char c) {
+    return c == ' ' || (unsigned char) (c - '\t') < 5;
+}
+
+/* This function returns the value of a hexadecimal digit, or 0xFF. */
+static unsigned int kmnd_real_digit(const char c) {
+    const unsigned int decimal = (unsigned char) c - '0';
+
+    if (decimal < 10)
+        return decimal;
+
+    const unsigned int letter = ((unsigned char) c | 0x20) - 'a';
+
+    if (letter < 6)
+        return letter + 10;
+
+    return 0xFF;
+}
+
+/* This function compares a prefix of the string case-insensitively with the
+ * given lowercase word and returns its length if it matches (or 0). */
+static size_t kmnd_real_match(const char *string, const size_t length,
+                              const char *word) {
+    size_t i;
+    for (i = 0; word[i] != '\0'; i ++) {
+        if (i >= length || (string[i] | 0x20) != word[i])
+            return 0;
+    }
+
+    return i;
+}
+
+/*
+ * This function parses an exponent (after the `e` or `p`) and adds it to the
+ * given power. It returns the number of bytes that were read, or 0 if there
+ * are no digits.
+ */
+static size_t kmnd_real_scan_exponent(const char *string, const size_t length,
+                                      int64_t *power) {
+    size_t i = 0;
+    unsigned char negative = 0;
+
+    if (i < length && (string[i] == '+' || string[i] == '-')) {
+        negative = string[i] == '-';
+        i ++;
+    }
+
+    const size_t start = i;
+    int64_t exponent = 0;
+
+    for (; i < length && (unsigned char) (string[i] - '0') < 10; i ++) {
+        if (exponent < KMND_REAL_MAX_EXPONENT)
+            exponent = exponent * 10 + (string[i] - '0');
+    }
+
+    if (i == start)
+        return 0;
+
+    *power += negative ? -exponent : exponent;
+
+    return i;
+}
+
+static int kmnd_real_scan_hexadecimal(const char *string, const size_t length,
+                                      kmnd_real_number_t *number) {
+    size_t i = 0;
+
+    unsigned char point = 0, any = 0;
+    int num_digits = 0;
+
+    number->type = KMND_REAL_TYPE_HEXADECIMAL;
+    number->mantissa = 0;
+    number->power = 0;
+    number->truncated = 0;
+
+    for (; i < length; i ++) {
+        if (string[i] == '.' && !point) {
+            point = 1;
+            continue;
+        }
+
+        const unsigned int digit = kmnd_real_digit(string[i]);
+
+        if (digit > 15)
+            break;
+
+        any = 1;
+
+        if (num_digits == 0 && digit == 0) {
+            if (point)
+                number->power -= 4;
+        }else if (num_digits < 16) {
+            number->mantissa = (number->mantissa << 4) | digit;
+            num_digits ++;
+
+            if (point)
+                number->power -= 4;
+        }else {
+            if (digit != 0)
+                number->truncated = 1;
+
+            if (!point)
+                number->power += 4;
+        }
+    }
+
+    if (!any)
+        return -1;
+
+    if (i < length && (string[i] | 0x20) == 'p') {
+        const size_t count = kmnd_real_scan_exponent(string + i + 1,
+                                                     length - i - 1,
+                                                     &number->power);
+
+        if (count == 0)
+            return -1;
+
+        i += 1 + count;
+    }
+
+    return i == length ? 0 : -1;
+}
+
+static int kmnd_real_scan_decimal(const char *string, const size_t length,
+                                  kmnd_real_number_t *number) {
+    size_t i = 0;
+
+    unsigned char any = 0;
+    int num_digits = 0;
+
+    number->type = KMND_REAL_TYPE_DECIMAL;
+    number->mantissa = 0;
+    number->power = 0;
+    number->truncated = 0;
+    number->digits = string;
+
+    for (; i < length && (unsigned char) (string[i] - '0') < 10; i ++) {
+        const unsigned int digit = string[i] - '0';
+        any = 1;
+
+        if (num_digits == 0 && digit == 0)
+            continue;
+
+        if (num_digits < KMND_REAL_MANTISSA_DIGITS) {
+            number->mantissa = number->mantissa * 10 + digit;
+            num_digits ++;
+        }else {
+            if (digit != 0)
+                number->truncated = 1;
+
+            number->power ++;
+        }
+    }
+
+    if (i < length && string[i] == '.') {
+        for (i ++; i < length && (unsigned char) (string[i] - '0') < 10;
+             i ++) {
+            const unsigned int digit = string[i] - '0';
+            any = 1;
+
+            if (num_digits == 0 && digit == 0) {
+                number->power --;
+            }else if (num_digits < KMND_REAL_MANTISSA_DIGITS) {
+                number->mantissa = number->mantissa * 10 + digit;
+                num_digits ++;
+                number->power --;
+            }else if (digit != 0)
+                number->truncated = 1;
+        }
+    }
+
+    if (!any)
+        return -1;
+
+    number->end = string + i;
+    number->exponent = 0;
+
+    if (i < length && (string[i] | 0x20) == 'e') {
+        const size_t count = kmnd_real_scan_exponent(string + i + 1,
+                                                     length - i - 1,
+                                                     &number->exponent);
+
+        if (count == 0)
+            return -1;
+
+        i += 1 + count;
+    }
+
+    number->power += number->exponent;
+
+    return i == length ? 0 : -1;
+}
+
+static int kmnd_real_scan(const char *string, const size_t length,
+                          kmnd_real_number_t *number) {
+    size_t i = 0;
+
+    while (i < length && kmnd_real_is_space(string[i]))
+        i ++;
+
+    number->negative = 0;
+
+    if (i < length && (string[i] == '+' || string[i] == '-')) {
+        number->negative = string[i] == '-';
+        i ++;
+    }
+
+    size_t count;
+
+    if ((count = kmnd_real_match(string + i, length - i, "inf")) != 0) {
+        i += count;
+        i += kmnd_real_match(string + i, length - i, "inity");
+
+        number->type = KMND_REAL_TYPE_INFINITY;
+
+        return i == length ? 0 : -1;
+    }
+
+    if ((count = kmnd_real_match(string + i, length - i, "nan")) != 0) {
+        i += count;
+
+        /* The payload of a NaN is ignored. */
+        if (i < length && string[i] == '(') {
+            for (i ++; i < length && string[i] != ')'; i ++) {
+                const char c = string[i] | 0x20;
+
+                if (!(string[i] == '_' || (c >= 'a' && c <= 'z') ||
+                      (unsigned char) (string[i] - '0') < 10))
+                    return -1;
+            }
+
+            if (i ++ == length)
+                return -1;
+        }
+
+        number->type = KMND_REAL_TYPE_NAN;
+
+        return i == length ? 0 : -1;
+    }
+
+    if (i + 1 < length && string[i] == '0' && (string[i + 1] | 0x20) == 'x')
+        return kmnd_real_scan_hexadecimal(string + i + 2, length - i - 2,
+                                          number);
+
+    return kmnd_real_scan_decimal(string + i, length - i, number);
+}
+
+/*
+ * This function computes the bits of `mantissa * 10^power` with the
+ * Eisel-Lemire algorithm. It returns -1 if the result cannot be determined
+ * with 128-bit precision, in which case the exact fallback is used.
+ */
+static int kmnd_real_lemire(const kmnd_real_format_t *format,
+                            const int64_t power, uint64_t mantissa,
+                            uint64_t *bits) {
+    const int mantissa_bits = format->mantissa_bits;
+
+    if (mantissa == 0 || power < format->smallest_power) {
+        *bits = 0;
+        return 0;
+    }
+
+    if (power > format->largest_power) {
+        *bits = (uint64_t) format->infinite_power << mantissa_bits;
+        return 0;
+    }
+
+    const int leading_zeros = kmnd_real_leading_zeros(mantissa);
+    mantissa <<= leading_zeros;
+
+    /* The product with the truncated power of five only needs to be refined
+     * with its lower half if the bits beyond the mantissa are all set. */
+    const size_t index = 2 * (size_t) (power - KMND_REAL_SMALLEST_POWER);
+    kmnd_real_u128_t product = kmnd_real_multiply(mantissa,
+                                                  kmnd_real_powers[index]);
+
+    const uint64_t precision = UINT64_MAX >> (mantissa_bits + 3);
+
+    if ((product.high & precision) == precision) {
+        const kmnd_real_u128_t lower =
+            kmnd_real_multiply(mantissa, kmnd_real_powers[index + 1]);
+
+        product.low += lower.high;
+
+        if (lower.high > product.low)
+            product.high ++;
+    }
+
+    if (product.low == UINT64_MAX && (power < -27 || power > 55))
+        return -1;
+
+    const int upper = (int) (product.high >> 63);
+    const int shift = upper + 64 - mantissa_bits - 3;
+
+    uint64_t result = product.high >> shift;
+
+    /* This is floor(log2(10^power)) + 63, plus the bias of the exponent. */
+    int64_t exponent = (((152170 + 65536) * power) >> 16) + 63 + upper -
+                       leading_zeros - format->minimum_exponent;
+
+    if (exponent <= 0) {
+        if (-exponent + 1 >= 64) {
+            *bits = 0;
+            return 0;
+        }
+
+        result >>= -exponent + 1;
+        result += result & 1;
+        result >>= 1;
+
+        exponent = result < ((uint64_t) 1 << mantissa_bits) ? 0 : 1;
+
+        *bits = ((uint64_t) exponent << mantissa_bits) | result;
+
+        return 0;
+    }
+
+    /* A product that is exactly halfway between two values is rounded to
+     * even instead of up. */
+    if (product.low <= 1 && power >= format->min_round_to_even &&
+        power <= format->max_round_to_even && (result & 3) == 1 &&
+        (result << shift) == product.high)
+        result &= ~(uint64_t) 1;
+
+    result += result & 1;
+    result >>= 1;
+
+    if (result >= ((uint64_t) 2 << mantissa_bits)) {
+        result = (uint64_t) 1 << mantissa_bits;
+        exponent ++;
+    }
+
+    result &= ~((uint64_t) 1 << mantissa_bits);
+
+    if (exponent >= format->infinite_power) {
+        exponent = format->infinite_power;
+        result = 0;
+    }
+
+    *bits = ((uint64_t) exponent << mantissa_bits) | result;
+
+    return 0;
+}
+
+static void kmnd_real_decimal_trim(kmnd_real_decimal_t *decimal) {
+    while (decimal->num_digits > 0 &&
+           decimal->digits[decimal->num_digits - 1] == 0)
+        decimal->num_digits --;
+
+    if (decimal->num_digits == 0)
+        decimal->point = 0;
+}
+
+static void kmnd_real_decimal_read(kmnd_real_decimal_t *decimal,
+                                   const kmnd_real_number_t *number) {
+    decimal->num_digits = 0;
+    decimal->point = 0;
+    decimal->truncated = 0;
+
+    unsigned char point = 0;
+
+    const char *c;
+    for (c = number->digits; c < number->end; c ++) {
+        if (*c == '.') {
+            point = 1;
+            continue;
+        }
+
+        const unsigned char digit = *c - '0';
+
+        if (decimal->num_digits == 0 && digit == 0) {
+            if (point)
+                decimal->point --;
+
+            continue;
+        }
+
+        if (!point)
+            decimal->point ++;
+
+        if (decimal->num_digits < KMND_REAL_MAX_DIGITS)
+            decimal->digits[decimal->num_digits ++] = digit;
+        else if (digit != 0)
+            decimal->truncated = 1;
+    }
+
+    decimal->point += (int) number->exponent;
+
+    kmnd_real_decimal_trim(decimal);
+}
+
+static void kmnd_real_decimal_left_shift(kmnd_real_decimal_t *decimal,
+                                         const unsigned int shift) {
+    /* The number of new digits is not known in advance, so the digits are
+     * written backwards into a buffer first. */
+    unsigned char buffer[KMND_REAL_MAX_DIGITS + 20];
+    int w = sizeof(buffer);
+
+    uint64_t n = 0;
+
+    int r;
+    for (r = decimal->num_digits - 1; r >= 0; r --) {
+        n += (uint64_t) decimal->digits[r] << shift;
+        buffer[-- w] = n % 10;
+        n /= 10;
+    }
+
+    while (n > 0) {
+        buffer[-- w] = n % 10;
+        n /= 10;
+    }
+
+    const int num_digits = (int) sizeof(buffer) - w;
+    const int count = num_digits < KMND_REAL_MAX_DIGITS ? num_digits :
+                                                          KMND_REAL_MAX_DIGITS;
+
+    for (r = count; r < num_digits; r ++) {
+        if (buffer[w + r] != 0)
+            decimal->truncated = 1;
+    }
+
+    memcpy(decimal->digits, buffer + w, count);
+
+    decimal->point += num_digits - decimal->num_digits;
+    decimal->num_digits = count;
+
+    kmnd_real_decimal_trim(decimal);
+}
+
+static void kmnd_real_decimal_right_shift(kmnd_real_decimal_t *decimal,
+                                          const unsigned int shift) {
+    int r = 0, w = 0;
+    uint64_t n = 0;
+
+    /* Skip the leading digits that become zero. */
+    for (; (n >> shift) == 0; r ++) {
+        if (r >= decimal->num_digits) {
+            if (n == 0) {
+                decimal->num_digits = 0;
+                return;
+            }
+
+            while ((n >> shift) == 0) {
+                n *= 10;
+                r ++;
+            }
+
+            break;
+        }
+
+        n = n * 10 + decimal->digits[r];
+    }
+
+    decimal->point -= r - 1;
+
+    const uint64_t mask = ((uint64_t) 1 << shift) - 1;
+
+    for (; r < decimal->num_digits; r ++) {
+        const unsigned char digit = (unsigned char) (n >> shift);
+        n &= mask;
+
+        decimal->digits[w ++] = digit;
+        n = n * 10 + decimal->digits[r];
+    }
+
+    while (n > 0) {
+        const unsigned char digit = (unsigned char) (n >> shift);
+        n &= mask;
+
+        if (w < KMND_REAL_MAX_DIGITS)
+            decimal->digits[w ++] = digit;
+        else if (digit != 0)
+            decimal->truncated = 1;
+
+        n *= 10;
+    }
+
+    decimal->num_digits = w;
+
+    kmnd_real_decimal_trim(decimal);
+}
+
+static void kmnd_real_decimal_shift(kmnd_real_decimal_t *decimal, int shift) {
+    if (decimal->num_digits == 0)
+        return;
+
+    for (; shift > KMND_REAL_MAX_SHIFT; shift -= KMND_REAL_MAX_SHIFT)
+        kmnd_real_decimal_left_shift(decimal, KMND_REAL_MAX_SHIFT);
+
+    for (; shift < -KMND_REAL_MAX_SHIFT; shift += KMND_REAL_MAX_SHIFT)
+        kmnd_real_decimal_right_shift(decimal, KMND_REAL_MAX_SHIFT);
+
+    if (shift > 0)
+        kmnd_real_decimal_left_shift(decimal, shift);
+    else if (shift < 0)
+        kmnd_real_decimal_right_shift(decimal, -shift);
+}
+
+/* This function returns the integer part of the decimal, rounded to the
+ * nearest integer (and ties to even). */
+static uint64_t kmnd_real_decimal_round(const kmnd_real_decimal_t *decimal) {
+    if (decimal->point > 20)
+        return UINT64_MAX;
+
+    uint64_t result = 0;
+
+    int i;
+    for (i = 0; i < decimal->point && i < decimal->num_digits; i ++)
+        result = result * 10 + decimal->digits[i];
+
+    for (; i < decimal->point; i ++)
+        result *= 10;
+
+    const int point = decimal->point;
+
+    if (point >= 0 && point < decimal->num_digits) {
+        const unsigned char digit = decimal->digits[point];
+
+        if (digit == 5 && point + 1 == decimal->num_digits) {
+            if (decimal->truncated || (point > 0 &&
+                                       decimal->digits[point - 1] % 2 != 0))
+                result ++;
+        }else if (digit >= 5)
+            result ++;
+    }
+
+    return result;
+}
+
+/*
+ * This function computes the bits of a decimal exactly. The decimal is scaled
+ * by powers of two until it is in [1/2, 1), after which the mantissa is
+ * extracted and rounded.
+ */
+static uint64_t kmnd_real_decimal_bits(kmnd_real_decimal_t *decimal,
+                                       const kmnd_real_format_t *format) {
+    static const int shifts[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    static const int num_shifts = sizeof(shifts) / sizeof(shifts[0]);
+
+    const int mantissa_bits = format->mantissa_bits;
+    const int bias = format->minimum_exponent;
+    const uint64_t infinity = (uint64_t) format->infinite_power <<
+                              mantissa_bits;
+
+    if (decimal->num_digits == 0 || decimal->point < -330)
+        return 0;
+
+    if (decimal->point > 310)
+        return infinity;
+
+    int exponent = 0, shift;
+
+    while (decimal->point > 0) {
+        shift = decimal->point >= num_shifts ? 27 : shifts[decimal->point];
+        kmnd_real_decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+
+    while (decimal->point < 0 ||
+           (decimal->point == 0 && decimal->digits[0] < 5)) {
+        shift = -decimal->point >= num_shifts ? 27 : shifts[-decimal->point];
+        kmnd_real_decimal_shift(decimal, shift);
+        exponent -= shift;
+    }
+
+    /* The decimal is in [1/2, 1) but the mantissa is in [1, 2). */
+    exponent --;
+
+    if (exponent < bias + 1) {
+        shift = bias + 1 - exponent;
+        kmnd_real_decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+
+    if (exponent - bias >= format->infinite_power)
+        return infinity;
+
+    kmnd_real_decimal_shift(decimal, 1 + mantissa_bits);
+    uint64_t mantissa = kmnd_real_decimal_round(decimal);
+
+    /* Rounding may have carried into the next power of two. */
+    if (mantissa == (uint64_t) 2 << mantissa_bits) {
+        mantissa >>= 1;
+        exponent ++;
+
+        if (exponent - bias >= format->infinite_power)
+            return infinity;
+    }
+
+    /* Subnormal numbers have no implicit leading bit. */
+    if ((mantissa & ((uint64_t) 1 << mantissa_bits)) == 0)
+        exponent = bias;
+
+    return (mantissa & (((uint64_t) 1 << mantissa_bits) - 1)) |
+           ((uint64_t) (exponent - bias) << mantissa_bits);
+}
+
+/*
+ * This function computes the bits of `mantissa * 2^power`, rounded to the
+ * nearest value (and ties to even), where `truncated` indicates that non-zero
+ * bits below the mantissa were dropped.
+ */
+static uint64_t kmnd_real_binary_bits(uint64_t mantissa, int64_t power,
+                                      const unsigned char truncated,
+                                      const kmnd_real_format_t *format) {
+    const int mantissa_bits = format->mantissa_bits;
+    const uint64_t infinity = (uint64_t) format->infinite_power <<
+                              mantissa_bits;
+
+    if (power > KMND_REAL_MAX_EXPONENT)
+        return infinity;
+
+    if (power < -KMND_REAL_MAX_EXPONENT)
+        return 0;
+
+    const int leading_zeros = kmnd_real_leading_zeros(mantissa);
+    mantissa <<= leading_zeros;
+    power -= leading_zeros;
+
+    /* This is the biased exponent of the most significant bit. */
+    const int64_t exponent = power + 63 - format->minimum_exponent;
+
+    if (exponent >= format->infinite_power)
+        return infinity;
+
+    int64_t shift = 63 - mantissa_bits;
+
+    if (exponent <= 0)
+        shift += 1 - exponent;
+
+    uint64_t result;
+
+    if (shift > 64)
+        return 0;
+
+    if (shift == 64) {
+        result = mantissa > ((uint64_t) 1 << 63) ||
+                 (mantissa == ((uint64_t) 1 << 63) && truncated);
+    }else {
+        const uint64_t rest = mantissa & (((uint64_t) 1 << shift) - 1);
+        const uint64_t half = (uint64_t) 1 << (shift - 1);
+
+        result = mantissa >> shift;
+
+        if (rest > half || (rest == half && (truncated || (result & 1))))
+            result ++;
+    }
+
+    /* A subnormal number that is rounded up may become normal, in which case
+     * the carry sets the exponent to one. */
+    if (exponent <= 0)
+        return result;
+
+    /* The implicit bit (or its carry) is added to the exponent. */
+    result += (uint64_t) (exponent - 1) << mantissa_bits;
+
+    if ((result >> mantissa_bits) >= (uint64_t) format->infinite_power)
+        return infinity;
+
+    return result;
+}
+
+/*
+ * This function computes the bits of the given number (without the sign). It
+ * returns -1 if a finite number is too large or too small to be represented.
+ */
+static int kmnd_real_bits(const kmnd_real_number_t *number,
+                          const kmnd_real_format_t *format, uint64_t *bits) {
+    const int mantissa_bits = format->mantissa_bits;
+    const uint64_t infinity = (uint64_t) format->infinite_power <<
+                              mantissa_bits;
+
+    switch (number->type) {
+        case KMND_REAL_TYPE_INFINITY:
+            *bits = infinity;
+            return 0;
+
+        case KMND_REAL_TYPE_NAN:
+            *bits = infinity | ((uint64_t) 1 << (mantissa_bits - 1));
+            return 0;
+
+        case KMND_REAL_TYPE_HEXADECIMAL:
+            if (number->mantissa == 0) {
+                *bits = 0;
+                return 0;
+            }
+
+            *bits = kmnd_real_binary_bits(number->mantissa, number->power,
+                                          number->truncated, format);
+            break;
+
+        case KMND_REAL_TYPE_DECIMAL:
+            if (number->mantissa == 0) {
+                *bits = 0;
+                return 0;
+            }
+
+            /* If digits were truncated, the result lies between the results
+             * for the truncated mantissa and the next one. It is only exact if
+             * both are equal. */
+            if (kmnd_real_lemire(format, number->power, number->mantissa,
+                                 bits) == 0) {
+                uint64_t upper;
+
+                if (!number->truncated ||
+                    (kmnd_real_lemire(format, number->power,
+                                      number->mantissa + 1, &upper) == 0 &&
+                     upper == *bits))
+                    break;
+            }
+
+            kmnd_real_decimal_t decimal;
+            kmnd_real_decimal_read(&decimal, number);
+
+            *bits = kmnd_real_decimal_bits(&decimal, format);
+            break;
+    }
+
+    if (*bits == 0 || *bits == infinity)
+        return -1;
+
+    return 0;
+}
+
+int kmnd_real_parse_double(const char *string, const size_t length,
+                           double *value) {
+    kmnd_real_number_t number;
+
+    if (kmnd_real_scan(string, length, &number) != 0)
+        return -1;
+
+#if defined(KMND_REAL_CLINGER)
+    if (number.type == KMND_REAL_TYPE_DECIMAL && !number.truncated &&
+        number.mantissa <= ((uint64_t) 1 << 53) && number.power >= -22 &&
+        number.power <= 22) {
+        double result = (double) number.mantissa;
+
+        if (number.power < 0)
+            result /= kmnd_real_exact_double[-number.power];
+        else
+            result *= kmnd_real_exact_double[number.power];
+
+        *value = number.negative ? -result : result;
+
+        return 0;
+    }
+#endif /* KMND_REAL_CLINGER */
+
+    uint64_t bits;
+
+    if (kmnd_real_bits(&number, &kmnd_real_double, &bits) != 0)
+        return -1;
+
+    bits |= (uint64_t) number.negative << 63;
+    memcpy(value, &bits, sizeof(bits));
+
+    return 0;
+}
+
+int kmnd_real_parse_float(const char *string, const size_t length,
+                          float *value) {
+    kmnd_real_number_t number;
+
+    if (kmnd_real_scan(string, length, &number) != 0)
+        return -1;
+
+#if defined(KMND_REAL_CLINGER)
+    if (number.type == KMND_REAL_TYPE_DECIMAL && !number.truncated &&
+        number.mantissa <= ((uint64_t) 1 << 24) && number.power >= -10 &&
+        number.power <= 10) {
+        float result = (float) number.mantissa;
+
+        if (number.power < 0)
+            result /= kmnd_real_exact_float[-number.power];
+        else
+            result *= kmnd_real_exact_float[number.power];
+
+        *value = number.negative ? -result : result;
+
+        return 0;
+    }
+#endif /* KMND_REAL_CLINGER */
+
+    uint64_t bits;
+
+    if (kmnd_real_bits(&number, &kmnd_real_float, &bits) != 0)
+        return -1;
+
+    const uint32_t result = (uint32_t) bits |
+                            ((uint32_t) number.negative << 31);
+    memcpy(value, &result, sizeof(result));
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_real_h
+#define __kmnd_real_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/**
+ * This function parses the first `length` bytes of `string` as a double and
+ * stores the correctly rounded result in `value`. It accepts the same syntax
+ * as strtod in the C locale: decimal and hexadecimal numbers, `inf`,
+ * `infinity` and `nan`, preceded by whitespace and a sign. It does not depend
+ * on the locale. It returns -1 if the string is not a number or if a finite
+ * number is too large or too small (but not zero) to be represented.
+ */
+int kmnd_real_parse_double(const char *string, const size_t length,
+                           double *value);
+
+/**
+ * This function is similar to kmnd_real_parse_double but parses a float.
+ */
+int kmnd_real_parse_float(const char *string, const size_t length,
+                          float *value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_real_h */
@@ -0,0 +1,499 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "command.h"
+#include "error.h"
+#include "result.h"
+
+/*
+ * This is the result whose callback is running on this thread (see
+ * kmnd_result_run).
+ */
+static KMND_THREAD_LOCAL const kmnd_result_t *kmnd_result_thread = NULL;
+
+/*
+ * This function finalizes the given command and its subcommands and numbers
+ * their options and inputs.
+ */
+static int kmnd_freeze_command(kmnd_command_t *command, const kmnd_t *root,
+                               size_t *num_slots) {
+    if (kmnd_command_finalize(command) != 0)
+        return -1;
+
+    size_t i;
+    for (i = 0; i < command->num_options; i ++) {
+        command->options[i]->root = root;
+        command->options[i]->slot = (*num_slots) ++;
+    }
+
+    for (i = 0; i < command->num_inputs; i ++) {
+        command->inputs[i]->root = root;
+        command->inputs[i]->slot = (*num_slots) ++;
+    }
+
+    for (i = 0; i < command->num_commands; i ++) {
+        if (kmnd_freeze_command(command->commands[i], root, num_slots) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * This function stores the current values of the options of the given command
+ * and its subcommands in `initial`.
+ */
+static void kmnd_freeze_values(const kmnd_command_t *command,
+                               kmnd_result_slot_t *initial) {
+    size_t i;
+    for (i = 0; i < command->num_options; i ++) {
+        const kmnd_option_t *option = command->options[i];
+        kmnd_result_slot_t *slot = &initial[option->slot];
+
+        memcpy(&slot->value, option->value, kmnd_value_size(option->type));
+        slot->length = option->length;
+    }
+
+    for (i = 0; i < command->num_commands; i ++)
+        kmnd_freeze_values(command->commands[i], initial);
+}
+
+int kmnd_freeze(kmnd_t *kmnd) {
+    kmnd_command_t *command = (kmnd_command_t *) kmnd;
+    const kmnd_allocator_t *allocator = command->core.allocator;
+
+    size_t num_slots = 0;
+
+    if (kmnd_freeze_command(command, kmnd, &num_slots) != 0)
+        return -1;
+
+    /* The terminal of the root is otherwise created when it is first used,
+     * which may be on several threads at once. */
+    if (kmnd_command_terminal(command) == NULL)
+        return -1;
+
+    kmnd_result_slot_t *initial = kmnd_allocate(allocator, num_slots *
+                                                sizeof(kmnd_result_slot_t));
+
+    if (num_slots > 0 && initial == NULL)
+        return -1;
+
+    kmnd_freeze_values(command, initial);
+
+    kmnd_release(allocator, command->initial);
+    command->initial = initial;
+    command->num_slots = num_slots;
+    command->frozen = 1;
+
+    return 0;
+}
+
+/*
+ * This function resets the result to the initial values of its tree.
+ */
+static void kmnd_result_reset(kmnd_result_t *result) {
+    const kmnd_command_t *root = (const kmnd_command_t *) result->kmnd;
+
+    kmnd_args_unmap(result->allocator, &result->mappings);
+
+    if (result->num_slots > 0)
+        memcpy(result->slots, root->initial,
+               result->num_slots * sizeof(kmnd_result_slot_t));
+
+    result->command = root;
+    result->help = 0;
+
+    memset(&result->error, 0, sizeof(kmnd_error_t));
+}
+
+kmnd_result_t *kmnd_result_new(const kmnd_t *kmnd) {
+    const kmnd_command_t *command = (const kmnd_command_t *) kmnd;
+    assert(command->frozen);
+
+    /* The slots are allocated together with the result. */
+    const kmnd_allocator_t *allocator = kmnd_allocator_current();
+    kmnd_result_t *result = kmnd_allocate(allocator, sizeof(kmnd_result_t) +
+                                          command->num_slots *
+                                          sizeof(kmnd_result_slot_t));
+
+    if (result == NULL)
+        return NULL;
+
+    result->kmnd = kmnd;
+    result->allocator = allocator;
+    result->slots = (kmnd_result_slot_t *) (result + 1);
+    result->num_slots = command->num_slots;
+    result->mappings = NULL;
+
+    kmnd_result_reset(result);
+
+    return result;
+}
+
+void kmnd_result_free(kmnd_result_t *result) {
+    kmnd_args_unmap(result->allocator, &result->mappings);
+    kmnd_release(result->allocator, result);
+}
+
+static int kmnd_parse_flag(const kmnd_option_t *option,
+                           kmnd_result_t *result) {
+    if (option->flag == NULL) {
+        kmnd_error_init_not_a_boolean(&result->error, option->core.name);
+        return -1;
+    }
+
+    kmnd_result_slot_t *slot = &result->slots[option->slot];
+
+    option->flag(option, &slot->value);
+    slot->activated = 1;
+
+    return 0;
+}
+
+static int kmnd_parse_value(const kmnd_option_t *option, const char *string,
+                            kmnd_result_t *result) {
+    kmnd_result_slot_t *slot = &result->slots[option->slot];
+
+    if (option->parse(option, string, &slot->value) != 0) {
+        kmnd_error_init_invalid_value(&result->error, option->core.name,
+                                      string);
+        return -1;
+    }
+
+    if (option->type == KMND_VALUE_STRING)
+        slot->length = strlen(string);
+
+    slot->activated = 1;
+
+    return 0;
+}
+
+static int kmnd_parse_option(const kmnd_command_t *command,
+                             const char *string, kmnd_result_t *result) {
+    assert(string[0] == '-');
+
+    if (string[1] == '-') {
+        size_t length;
+        const kmnd_option_t *option = kmnd_index_find(&command->index,
+                                                      string + 2, &length);
+
+        if (option == NULL) {
+            kmnd_error_init_unknown_option(&result->error, string);
+            return -1;
+        }
+
+        if (string[2 + length] == '\0')
+            return kmnd_parse_flag(option, result);
+
+        return kmnd_parse_value(option, string + 2 + length + 1, result);
+    }
+
+    size_t k;
+    for (k = 1; string[k] != '\0'; k ++) {
+        const kmnd_option_t *option = NULL;
+
+        if (string[k] != '=')
+            option = kmnd_index_find_short(&command->index, string[k]);
+
+        if (option == NULL)
+            break;
+
+        if (string[k + 1] == '=')
+            return kmnd_parse_value(option, string + k + 2, result);
+
+        if (kmnd_parse_flag(option, result) != 0)
+            return -1;
+    }
+
+    if (k > 1 && string[k] == '\0')
+        return 0;
+
+    result->option[0] = '-';
+    result->option[1] = string[k];
+    result->option[2] = '\0';
+
+    kmnd_error_init_unknown_option(&result->error, result->option);
+
+    return -1;
+}
+
+/*
+ * This function parses the arguments of the given iterator into the result.
+ */
+static int kmnd_parse_args(const kmnd_command_t *command, kmnd_args_t *args,
+                           kmnd_result_t *result) {
+    /* This follows kmnd_run, except that subcommands are entered in the same
+     * loop instead of recursively. */
+    size_t stage = 0, input = 0;
+
+    const char *arg;
+    while ((arg = kmnd_args_next(args, command)) != NULL) {
+        if (arg[0] == '\0')
+            continue;
+
+        if (arg[0] == '-') {
+            stage = 1;
+
+            if (command->usage != NULL &&
+                (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0)) {
+                result->command = command;
+                result->help = 1;
+                return 0;
+            }
+
+            if (kmnd_parse_option(command, arg, result) != 0) {
+                result->command = command;
+                return -1;
+            }
+
+            continue;
+        }
+
+        if (stage == 1)
+            stage = 2;
+
+        if (stage == 0) {
+            kmnd_t *subcommand = NULL;
+
+            int res = kmnd_trie_find_command(&command->trie, arg,
+                                             kmnd_command_abbreviates(command),
+                                             &subcommand);
+
+            if (res == 0) {
+                command = (const kmnd_command_t *) subcommand;
+                input = 0;
+                continue;
+            }
+
+            if (res == -2) {
+                kmnd_error_init_ambiguous_command(&result->error, arg);
+                result->command = command;
+                return -1;
+            }
+        }
+
+        unsigned char is_input = 0;
+
+        for (; input < command->num_inputs; input ++) {
+            const kmnd_input_t *inp = command->inputs[input];
+
+            int res = 0;
+
+            if (inp->validator != NULL)
+                res = inp->validator((kmnd_t *) command, arg);
+
+            if (res == 0) {
+                kmnd_result_slot_t *slot = &result->slots[inp->slot];
+
+                slot->value.string = arg;
+                slot->length = strlen(arg);
+                slot->activated = 1;
+
+                is_input = 1;
+                input ++;
+                break;
+            }else if (res == -1 && kmnd_input_required(inp) == 1) {
+                kmnd_error_init_invalid_input(&result->error, inp->core.name,
+                                              arg);
+                result->command = command;
+                return -1;
+            }
+        }
+
+        if (is_input)
+            continue;
+
+        kmnd_error_init_unknown_command(&result->error, arg);
+        result->command = command;
+        return -1;
+    }
+
+    result->command = command;
+
+    if (args->error.type != KMND_ERROR_TYPE_NONE) {
+        result->error = args->error;
+        return -1;
+    }
+
+    size_t j;
+    for (j = 0; j < command->num_options; j ++) {
+        const kmnd_option_t *option = command->options[j];
+
+        if (kmnd_option_required(option) == 0 ||
+            result->slots[option->slot].activated)
+            continue;
+
+        kmnd_error_init_missing_option(&result->error, option->core.name);
+        return -1;
+    }
+
+    for (j = 0; j < command->num_inputs; j ++) {
+        const kmnd_input_t *inp = command->inputs[j];
+
+        if (kmnd_input_required(inp) == 0 ||
+            result->slots[inp->slot].activated)
+            continue;
+
+        kmnd_error_init_missing_input(&result->error, inp->core.name);
+        return -1;
+    }
+
+    return 0;
+}
+
+int kmnd_parse(const kmnd_t *kmnd, const int argc, const char **argv,
+               kmnd_result_t *result) {
+    assert(result->kmnd == kmnd);
+
+    kmnd_result_reset(result);
+
+    /* Strings in the result point into the response files, so all of them
+     * remain mapped until the result is reset or freed. */
+    kmnd_args_t args;
+    kmnd_args_init(&args, result->allocator, &result->mappings, argc, argv);
+    args.borrow = 1;
+
+    int res = kmnd_parse_args((const kmnd_command_t *) kmnd, &args, result);
+
+    kmnd_args_release(&args);
+
+    return res;
+}
+
+kmnd_t *kmnd_result_command(const kmnd_result_t *result) {
+    return (kmnd_t *) result->command;
+}
+
+int kmnd_result_run(kmnd_result_t *result) {
+    kmnd_command_t *command = (kmnd_command_t *) result->command;
+
+    if (result->error.type != KMND_ERROR_TYPE_NONE)
+        return -1;
+
+    if (result->help || command->run == NULL) {
+        if (command->usage != NULL)
+            kmnd_usage_print(command->usage, command);
+
+        return 0;
+    }
+
+    const kmnd_result_t *previous = kmnd_result_thread;
+    kmnd_result_thread = result;
+
+    int res = command->run((kmnd_t *) command);
+
+    kmnd_result_thread = previous;
+
+    return res;
+}
+
+void kmnd_result_report(const kmnd_result_t *result) {
+    kmnd_command_t *command = (kmnd_command_t *) result->command;
+
+    if (result->error.type == KMND_ERROR_TYPE_NONE && !result->help)
+        return;
+
+    if (result->error.type != KMND_ERROR_TYPE_NONE) {
+        kmnd_error_t error = result->error;
+        kmnd_error_print(&error, (kmnd_t *) command);
+    }
+
+    if (command->usage != NULL)
+        kmnd_usage_print(command->usage, command);
+}
+
+const kmnd_result_slot_t *kmnd_result_slot(const kmnd_t *root,
+                                           const size_t slot) {
+    const kmnd_result_t *result = kmnd_result_thread;
+
+    if (result == NULL || root == NULL || result->kmnd != root)
+        return NULL;
+
+    return &result->slots[slot];
+}
+
+/*
+ * This function returns the slot of the option or input that the given handle
+ * refers to.
+ */
+static const kmnd_result_slot_t *
+kmnd_result_handle(const kmnd_result_t *result, kmnd_handle_t handle) {
+    const kmnd_t *kmnd = (const kmnd_t *) handle;
+    assert(kmnd != NULL);
+
+    if (kmnd->type == KMND_TYPE_INPUT) {
+        const kmnd_input_t *input = (const kmnd_input_t *) kmnd;
+        assert(input->root == result->kmnd);
+
+        return &result->slots[input->slot];
+    }
+
+    const kmnd_option_t *option = (const kmnd_option_t *) kmnd;
+    assert(kmnd->type == KMND_TYPE_OPTION && option->root == result->kmnd);
+
+    return &result->slots[option->slot];
+}
+
+unsigned char kmnd_result_activated(const kmnd_result_t *result,
+                                    kmnd_handle_t handle) {
+    return kmnd_result_handle(result, handle)->activated;
+}
+
+#define kmnd_result_get(N, T, V, M) \
+    T kmnd_result_##N(const kmnd_result_t *result, kmnd_handle_t handle) { \
+        assert(((const kmnd_option_t *) handle)->type == KMND_VALUE_##V); \
+        \
+        return kmnd_result_handle(result, handle)->value.M; \
+    }
+
+kmnd_result_get(boolean, unsigned char, BOOLEAN, boolean)
+kmnd_result_get(string,  const char *,  STRING,  string)
+kmnd_result_get(int8,    int8_t,        INT8,    int8)
+kmnd_result_get(int16,   int16_t,       INT16,   int16)
+kmnd_result_get(int32,   int32_t,       INT32,   int32)
+kmnd_result_get(int64,   int64_t,       INT64,   int64)
+kmnd_result_get(uint8,   uint8_t,       UINT8,   uint8)
+kmnd_result_get(uint16,  uint16_t,      UINT16,  uint16)
+kmnd_result_get(uint32,  uint32_t,      UINT32,  uint32)
+kmnd_result_get(uint64,  uint64_t,      UINT64,  uint64)
+kmnd_result_get(float,   float,         FLOAT,   real)
+kmnd_result_get(double,  double,        DOUBLE,  real64)
+
+const char *kmnd_result_input(const kmnd_result_t *result,
+                              kmnd_handle_t handle) {
+    assert(((const kmnd_t *) handle)->type == KMND_TYPE_INPUT);
+
+    return kmnd_result_handle(result, handle)->value.string;
+}
+
+const char *kmnd_result_view(const kmnd_result_t *result, kmnd_handle_t handle,
+                             size_t *length) {
+    const kmnd_result_slot_t *slot = kmnd_result_handle(result, handle);
+
+    *length = slot->length;
+
+    return slot->value.string;
+}
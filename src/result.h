@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_result_h
+#define __kmnd_result_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "args.h"
+#include "core.h"
+#include "error.h"
+#include "option.h"
+
+struct kmnd_command_s;
+
+/*
+ * This is the value of a single option or input in a result. Inputs and string
+ * options store a string.
+ */
+typedef struct kmnd_result_slot_s {
+    kmnd_option_storage_t value;
+    size_t length;
+    unsigned char activated;
+} kmnd_result_slot_t;
+
+struct kmnd_result_s {
+    /* This is the root of the frozen tree that the result belongs to. */
+    const kmnd_t *kmnd;
+
+    const kmnd_allocator_t *allocator;
+
+    /* This is the command that was selected by the arguments, or the command
+     * at which an error occurred. */
+    const struct kmnd_command_s *command;
+
+    /* This is set if the usage text was asked for (with -h or --help). */
+    unsigned char help;
+
+    /* This is the error that the arguments were rejected with. The name of an
+     * unknown short option is stored in `option`. */
+    kmnd_error_t error;
+    char option[3];
+
+    kmnd_result_slot_t *slots;
+    size_t num_slots;
+
+    /* These are the response files that the strings in the result point
+     * into. */
+    kmnd_args_mapping_t *mappings;
+};
+
+/*
+ * This function returns the slot of the given position in the result that is
+ * being run on this thread (see kmnd_result_run), or NULL if there is no such
+ * result or it belongs to a different tree than `root`.
+ */
+const kmnd_result_slot_t *kmnd_result_slot(const kmnd_t *root,
+                                           const size_t slot);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_result_h */
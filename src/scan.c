@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define KMND_SCAN_AVX2 1
+#endif
+
+#include "scan.h"
+
+#define KMND_SCAN_ONES  ((uint64_t) 0x0101010101010101ULL)
+#define KMND_SCAN_HIGHS ((uint64_t) 0x8080808080808080ULL)
+
+size_t kmnd_scan_any_portable(const char *text, const size_t length,
+                              const char *needles, const size_t num_needles) {
+    uint64_t patterns[KMND_SCAN_MAX_NEEDLES];
+
+    size_t j;
+    for (j = 0; j < num_needles; j ++)
+        patterns[j] = KMND_SCAN_ONES * (unsigned char) needles[j];
+
+    size_t i = 0;
+
+    /* Each word is checked for a byte that is equal to one of the needles,
+     * i.e. a zero byte after xor-ing with the pattern of that needle. */
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, text + i, 8);
+
+        uint64_t found = 0;
+
+        for (j = 0; j < num_needles; j ++) {
+            const uint64_t value = word ^ patterns[j];
+            found |= (value - KMND_SCAN_ONES) & ~value & KMND_SCAN_HIGHS;
+        }
+
+        if (found != 0)
+            break;
+    }
+
+    for (; i < length; i ++) {
+        for (j = 0; j < num_needles; j ++) {
+            if (text[i] == needles[j])
+                return i;
+        }
+    }
+
+    return length;
+}
+
+size_t kmnd_scan_ascii_portable(const char *text, const size_t length) {
+    size_t i = 0;
+
+    /* A byte is printable ASCII if its high bit is clear and adding 0x60 to
+     * its lower seven bits sets the high bit (i.e. it is at least 0x20). */
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, text + i, 8);
+
+        const uint64_t low = (word & ~KMND_SCAN_HIGHS) + KMND_SCAN_ONES * 0x60;
+
+        if (((word | ~low) & KMND_SCAN_HIGHS) != 0)
+            break;
+    }
+
+    for (; i < length; i ++) {
+        const unsigned char c = (unsigned char) text[i];
+
+        if (c < 0x20 || c >= 0x80)
+            return i;
+    }
+
+    return length;
+}
+
+#if defined(__SSE2__)
+
+static size_t kmnd_scan_any_sse2(const char *text, const size_t length,
+                                 const char *needles,
+                                 const size_t num_needles) {
+    __m128i patterns[KMND_SCAN_MAX_NEEDLES];
+
+    size_t j;
+    for (j = 0; j < num_needles; j ++)
+        patterns[j] = _mm_set1_epi8(needles[j]);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) (text + i));
+        __m128i found = _mm_setzero_si128();
+
+        for (j = 0; j < num_needles; j ++)
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(block, patterns[j]));
+
+        const int mask = _mm_movemask_epi8(found);
+
+        if (mask != 0)
+            return i + (size_t) __builtin_ctz((unsigned int) mask);
+    }
+
+    return i + kmnd_scan_any_portable(text + i, length - i, needles,
+                                      num_needles);
+}
+
+static size_t kmnd_scan_ascii_sse2(const char *text, const size_t length) {
+    /* Bytes with the high bit set are negative when compared as signed
+     * bytes, so a single comparison finds both them and control bytes. */
+    const __m128i space = _mm_set1_epi8(0x20);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) (text + i));
+        const int mask = _mm_movemask_epi8(_mm_cmplt_epi8(block, space));
+
+        if (mask != 0)
+            return i + (size_t) __builtin_ctz((unsigned int) mask);
+    }
+
+    return i + kmnd_scan_ascii_portable(text + i, length - i);
+}
+
+#endif /* __SSE2__ */
+
+#if defined(KMND_SCAN_AVX2)
+
+__attribute__((target("avx2")))
+static size_t kmnd_scan_any_avx2(const char *text, const size_t length,
+                                 const char *needles,
+                                 const size_t num_needles) {
+    __m256i patterns[KMND_SCAN_MAX_NEEDLES];
+
+    size_t j;
+    for (j = 0; j < num_needles; j ++)
+        patterns[j] = _mm256_set1_epi8(needles[j]);
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        const __m256i block = _mm256_loadu_si256((const __m256i *) (text + i));
+        __m256i found = _mm256_setzero_si256();
+
+        for (j = 0; j < num_needles; j ++)
+            found = _mm256_or_si256(found,
+                                    _mm256_cmpeq_epi8(block, patterns[j]));
+
+        const unsigned int mask = (unsigned int) _mm256_movemask_epi8(found);
+
+        if (mask != 0)
+            return i + (size_t) __builtin_ctz(mask);
+    }
+
+    return i + kmnd_scan_any_sse2(text + i, length - i, needles, num_needles);
+}
+
+__attribute__((target("avx2")))
+static size_t kmnd_scan_ascii_avx2(const char *text, const size_t length) {
+    const __m256i space = _mm256_set1_epi8(0x20);
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        const __m256i block = _mm256_loadu_si256((const __m256i *) (text + i));
+        const unsigned int mask =
+            (unsigned int) _mm256_movemask_epi8(_mm256_cmpgt_epi8(space,
+                                                                  block));
+
+        if (mask != 0)
+            return i + (size_t) __builtin_ctz(mask);
+    }
+
+    return i + kmnd_scan_ascii_sse2(text + i, length - i);
+}
+
+#endif /* KMND_SCAN_AVX2 */
+
+typedef size_t (kmnd_scan_any_cb)(const char *text, const size_t length,
+                                  const char *needles,
+                                  const size_t num_needles);
+
+/*
+ * This function returns the best implementation for this CPU. It is only
+ * determined once.
+ */
+static kmnd_scan_any_cb *kmnd_scan_any_implementation(void) {
+    static kmnd_scan_any_cb *implementation = NULL;
+
+    if (implementation != NULL)
+        return implementation;
+
+#if defined(KMND_SCAN_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+        implementation = kmnd_scan_any_avx2;
+    else
+        implementation = kmnd_scan_any_sse2;
+#elif defined(__SSE2__)
+    implementation = kmnd_scan_any_sse2;
+#else
+    implementation = kmnd_scan_any_portable;
+#endif
+
+    return implementation;
+}
+
+size_t kmnd_scan_any(const char *text, const size_t length,
+                     const char *needles, const size_t num_needles) {
+    /* Short texts, such as option names, are not worth the setup. */
+    if (length < 16)
+        return kmnd_scan_any_portable(text, length, needles, num_needles);
+
+    return kmnd_scan_any_implementation()(text, length, needles, num_needles);
+}
+
+typedef size_t (kmnd_scan_ascii_cb)(const char *text, const size_t length);
+
+/*
+ * This function returns the best implementation for this CPU. It is only
+ * determined once.
+ */
+static kmnd_scan_ascii_cb *kmnd_scan_ascii_implementation(void) {
+    static kmnd_scan_ascii_cb *implementation = NULL;
+
+    if (implementation != NULL)
+        return implementation;
+
+#if defined(KMND_SCAN_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+        implementation = kmnd_scan_ascii_avx2;
+    else
+        implementation = kmnd_scan_ascii_sse2;
+#elif defined(__SSE2__)
+    implementation = kmnd_scan_ascii_sse2;
+#else
+    implementation = kmnd_scan_ascii_portable;
+#endif
+
+    return implementation;
+}
+
+size_t kmnd_scan_ascii(const char *text, const size_t length) {
+    if (length < 16)
+        return kmnd_scan_ascii_portable(text, length);
+
+    return kmnd_scan_ascii_implementation()(text, length);
+}
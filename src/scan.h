@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_scan_h
+#define __kmnd_scan_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/*
+ * This is the maximum number of different bytes that can be searched for at
+ * once.
+ */
+#define KMND_SCAN_MAX_NEEDLES 4
+
+/**
+ * This function returns the index of the first byte in `text` that equals any
+ * of the given needles, or `length` if there is none. It uses AVX2 or SSE2
+ * when available and falls back to a portable implementation that processes
+ * eight bytes at a time.
+ */
+size_t kmnd_scan_any(const char *text, const size_t length,
+                     const char *needles, const size_t num_needles);
+
+/**
+ * This function is the portable implementation of kmnd_scan_any. It is
+ * exposed for testing and benchmarking.
+ */
+size_t kmnd_scan_any_portable(const char *text, const size_t length,
+                              const char *needles, const size_t num_needles);
+
+/**
+ * This function returns the index of the first byte in `text` that is not
+ * printable ASCII (i.e. a control byte or part of a multi-byte UTF-8
+ * sequence), or `length` if all bytes are printable ASCII.
+ */
+size_t kmnd_scan_ascii(const char *text, const size_t length);
+
+/**
+ * This function is the portable implementation of kmnd_scan_ascii. It is
+ * exposed for testing and benchmarking.
+ */
+size_t kmnd_scan_ascii_portable(const char *text, const size_t length);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_scan_h */
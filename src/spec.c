@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "allocator.h"
+#include "command.h"
+
+/*
+ * This function returns the number of bytes that the tree for the given spec
+ * takes up in an arena.
+ */
+static size_t kmnd_spec_size(const kmnd_spec_t *spec) {
+    size_t size = KMND_ARENA_ALIGN(sizeof(kmnd_command_t)) +
+                  KMND_ARENA_ALIGN(spec->num_commands * sizeof(void *)) +
+                  KMND_ARENA_ALIGN(spec->num_options * sizeof(void *)) +
+                  KMND_ARENA_ALIGN(spec->num_inputs * sizeof(void *));
+
+    if (spec->usage != NULL)
+        size += KMND_ARENA_ALIGN(sizeof(kmnd_usage_t));
+
+    size_t i;
+    for (i = 0; i < spec->num_options; i ++) {
+        const kmnd_option_spec_t *option = &spec->options[i];
+
+        size += KMND_ARENA_ALIGN(sizeof(kmnd_option_t));
+
+        /* The default value of a string option is copied. */
+        if (option->type == KMND_VALUE_STRING && option->variable == NULL &&
+            option->string != NULL)
+            size += KMND_ARENA_ALIGN(strlen(option->string) + 1);
+    }
+
+    size += spec->num_inputs * KMND_ARENA_ALIGN(sizeof(kmnd_input_t));
+
+    for (i = 0; i < spec->num_commands; i ++)
+        size += kmnd_spec_size(&spec->commands[i]);
+
+    return size;
+}
+
+#define kmnd_spec_case(V, N, T, F) \
+    case KMND_VALUE_##V: \
+        if (spec->variable != NULL) \
+            return kmnd_##N##_bind(spec->character, spec->name, \
+                                   spec->description, spec->flags, \
+                                   (T *) spec->variable); \
+        \
+        return kmnd_##N##_new(spec->character, spec->name, \
+                              spec->description, spec->flags, (T) spec->F);
+
+/*
+ * This function returns a new option for the given spec.
+ */
+static kmnd_t *kmnd_spec_option(const kmnd_option_spec_t *spec) {
+    switch (spec->type) {
+        kmnd_spec_case(BOOLEAN, boolean, unsigned char, integer)
+        kmnd_spec_case(STRING,  string,  const char *,  string)
+        kmnd_spec_case(INT8,    int8,    int8_t,        integer)
+        kmnd_spec_case(INT16,   int16,   int16_t,       integer)
+        kmnd_spec_case(INT32,   int32,   int32_t,       integer)
+        kmnd_spec_case(INT64,   int64,   int64_t,       integer)
+        kmnd_spec_case(UINT8,   uint8,   uint8_t,       unsigned_integer)
+        kmnd_spec_case(UINT16,  uint16,  uint16_t,      unsigned_integer)
+        kmnd_spec_case(UINT32,  uint32,  uint32_t,      unsigned_integer)
+        kmnd_spec_case(UINT64,  uint64,  uint64_t,      unsigned_integer)
+        kmnd_spec_case(FLOAT,   float,   float,         real)
+        kmnd_spec_case(DOUBLE,  double,  double,        real)
+    }
+
+    return NULL;
+}
+
+/*
+ * This function returns a new command for the given spec, which is allocated
+ * with the current allocator, or NULL if it could not be allocated. Only its
+ * name, description and callback are set. Everything else is created from the
+ * spec when it is first needed (see kmnd_command_expand).
+ */
+static kmnd_command_t *kmnd_spec_command(const kmnd_spec_t *spec) {
+    const kmnd_allocator_t *allocator = kmnd_allocator_current();
+    kmnd_command_t *command = kmnd_allocate(allocator, sizeof(kmnd_command_t));
+
+    if (command == NULL)
+        return NULL;
+
+    command->core.type = KMND_TYPE_COMMAND;
+    command->core.allocator = allocator;
+    command->core.name = spec->name;
+    command->core.description = spec->description;
+    command->run = spec->run;
+    command->generation = kmnd_command_generation();
+    command->spec = spec;
+
+    return command;
+}
+
+/*
+ * This function creates the options, inputs and usage section of the given
+ * command and the (unexpanded) commands of its subcommands, with the allocator
+ * of the command. It returns -1 if memory could not be allocated, in which case
+ * the nodes that were allocated already are left to the arena.
+ */
+static int kmnd_spec_expand(kmnd_command_t *command) {
+    const kmnd_spec_t *spec = command->spec;
+    const kmnd_allocator_t *allocator = command->core.allocator;
+
+    kmnd_command_t **commands = kmnd_allocate(allocator, spec->num_commands *
+                                              sizeof(kmnd_command_t *));
+    kmnd_option_t **options = kmnd_allocate(allocator, spec->num_options *
+                                            sizeof(kmnd_option_t *));
+    kmnd_input_t **inputs = kmnd_allocate(allocator, spec->num_inputs *
+                                          sizeof(kmnd_input_t *));
+
+    if ((spec->num_commands > 0 && commands == NULL) ||
+        (spec->num_options > 0 && options == NULL) ||
+        (spec->num_inputs > 0 && inputs == NULL))
+        return -1;
+
+    kmnd_usage_t *usage = NULL;
+
+    if (spec->usage != NULL) {
+        usage = (kmnd_usage_t *) kmnd_usage_new(spec->usage,
+                                                spec->description);
+
+        if (usage == NULL)
+            return -1;
+    }
+
+    size_t i;
+    for (i = 0; i < spec->num_options; i ++) {
+        options[i] = (kmnd_option_t *) kmnd_spec_option(&spec->options[i]);
+
+        if (options[i] == NULL)
+            return -1;
+    }
+
+    for (i = 0; i < spec->num_inputs; i ++) {
+        const kmnd_input_spec_t *input = &spec->inputs[i];
+        inputs[i] = (kmnd_input_t *) kmnd_input_new(input->name,
+                                                    input->description,
+                                                    input->flags,
+                                                    input->validator);
+
+        if (inputs[i] == NULL)
+            return -1;
+    }
+
+    for (i = 0; i < spec->num_commands; i ++) {
+        commands[i] = kmnd_spec_command(&spec->commands[i]);
+
+        if (commands[i] == NULL)
+            return -1;
+
+        commands[i]->super = (kmnd_t *) command;
+    }
+
+    /* The command only changes once everything has been created. */
+    command->commands = commands;
+    command->num_commands = spec->num_commands;
+    command->options = options;
+    command->num_options = spec->num_options;
+    command->inputs = inputs;
+    command->num_inputs = spec->num_inputs;
+    command->usage = usage;
+    command->spec = NULL;
+
+    return 0;
+}
+
+int kmnd_command_expand(kmnd_command_t *command) {
+    if (command->spec == NULL)
+        return 0;
+
+    const kmnd_allocator_t *previous;
+    previous = kmnd_allocator_use(command->core.allocator);
+
+    const int res = kmnd_spec_expand(command);
+
+    kmnd_allocator_use(previous);
+
+    return res;
+}
+
+kmnd_t *kmnd_spec_new(const kmnd_spec_t *spec) {
+    kmnd_arena_t *arena = kmnd_arena_new(kmnd_spec_size(spec));
+
+    if (arena == NULL)
+        return NULL;
+
+    const kmnd_allocator_t *previous;
+    previous = kmnd_allocator_use(kmnd_arena_allocator(arena));
+
+    kmnd_command_t *command = kmnd_spec_command(spec);
+
+    kmnd_allocator_use(previous);
+
+    if (command == NULL) {
+        kmnd_arena_free(arena);
+        return NULL;
+    }
+
+    command->arena = arena;
+
+    return (kmnd_t *) command;
+}
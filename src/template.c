@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "command.h"
+#include "template.h"
+#include "width.h"
+
+static void kmnd_template_count(void *context, const char *text,
+                                const size_t length,
+                                const kmnd_terminal_options_t options,
+                                const int placeholder) {
+    ((kmnd_template_t *) context)->num_spans ++;
+}
+
+static void kmnd_template_add(void *context, const char *text,
+                              const size_t length,
+                              const kmnd_terminal_options_t options,
+                              const int placeholder) {
+    kmnd_template_t *tmpl = (kmnd_template_t *) context;
+    kmnd_template_span_t *span = &tmpl->spans[tmpl->num_spans ++];
+
+    span->text = text;
+    span->length = length;
+    span->placeholder = placeholder;
+    span->options = options;
+
+    /* The width is computed once here, so that text that fits on the line is
+     * only copied when the template is rendered. */
+    if (text == NULL || memchr(text, '\n', length) != NULL)
+        span->width = KMND_TEMPLATE_NO_WIDTH;
+    else
+        span->width = kmnd_width(text, length);
+}
+
+kmnd_template_t *kmnd_template_new(const char *format) {
+    const size_t length = strlen(format);
+
+    /*
+     * We parse the format twice. Once to count the number of spans and one
+     * more time to store them. The template, its spans and the copy of the
+     * format are stored in a single allocation.
+     */
+    kmnd_template_t counter = { NULL, 0, NULL };
+    kmnd_terminal_markup(format, length, 1, kmnd_template_count, &counter);
+
+    const size_t spans_size = counter.num_spans * sizeof(kmnd_template_span_t);
+
+    kmnd_template_t *tmpl = malloc(sizeof(kmnd_template_t) + spans_size +
+                                       length + 1);
+
+    if (tmpl == NULL)
+        return NULL;
+
+    tmpl->spans = (kmnd_template_span_t *) (tmpl + 1);
+    tmpl->num_spans = 0;
+    tmpl->format = (char *) tmpl->spans + spans_size;
+
+    memcpy(tmpl->format, format, length + 1);
+
+    kmnd_terminal_markup(tmpl->format, length, 1, kmnd_template_add,
+                         tmpl);
+
+    return tmpl;
+}
+
+void kmnd_template_free(kmnd_template_t *tmpl) {
+    free(tmpl);
+}
+
+/*
+ * This function writes text of the given width (see kmnd_template_span_t).
+ */
+static void kmnd_template_write(kmnd_terminal_t *terminal, const char *text,
+                                const size_t length, const size_t width,
+                                const kmnd_terminal_options_t options) {
+    if (width == KMND_TEMPLATE_NO_WIDTH)
+        kmnd_terminal_span(terminal, text, length, options);
+    else
+        kmnd_terminal_span_width(terminal, text, length, width, options);
+}
+
+void kmnd_template_render(const kmnd_template_t *tmpl,
+                          kmnd_terminal_t *terminal,
+                          const char *const *values, const size_t num_values,
+                          const kmnd_terminal_options_t options) {
+    size_t i;
+    for (i = 0; i < tmpl->num_spans; i ++) {
+        const kmnd_template_span_t *span = &tmpl->spans[i];
+        const kmnd_terminal_options_t span_options = options | span->options |
+            KMND_TERMINAL_OPTIONS_NO_NEWLINE;
+
+        if (span->text != NULL) {
+            kmnd_template_write(terminal, span->text, span->length,
+                                span->width, span_options);
+        }else if ((size_t) span->placeholder < num_values &&
+                  values[span->placeholder] != NULL) {
+            const char *value = values[span->placeholder];
+            const size_t length = strlen(value);
+
+            kmnd_template_write(terminal, value, length,
+                                memchr(value, '\n', length) == NULL ?
+                                kmnd_width(value, length) :
+                                KMND_TEMPLATE_NO_WIDTH,
+                                span_options);
+        }
+    }
+
+    if (!(options & KMND_TERMINAL_OPTIONS_NO_NEWLINE))
+        kmnd_terminal_span_width(terminal, "", 0, 0, options);
+}
+
+int kmnd_template_print(kmnd_t *kmnd, const kmnd_template_t *tmpl,
+                        const char *const *values, const size_t num_values) {
+    kmnd_terminal_t *terminal;
+    terminal = kmnd_command_terminal((kmnd_command_t *) kmnd);
+
+    kmnd_template_render(tmpl, terminal, values, num_values,
+                         KMND_TERMINAL_OPTIONS_NONE);
+
+    return kmnd_terminal_flush(terminal);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_template_h
+#define __kmnd_template_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <kmnd.h>
+#include <stdint.h>
+
+#include "terminal.h"
+
+#define KMND_TEMPLATE_NO_WIDTH SIZE_MAX
+
+typedef struct kmnd_template_span_s kmnd_template_span_t;
+
+struct kmnd_template_span_s {
+    /* This is the text of the span, or NULL if the span is a placeholder. */
+    const char *text;
+    size_t length;
+
+    /* This is the number of columns that the text occupies, or
+     * KMND_TEMPLATE_NO_WIDTH if it contains a newline and must be laid out
+     * when it is written. */
+    size_t width;
+
+    /* This is the index of the value that replaces the placeholder. */
+    int placeholder;
+
+    kmnd_terminal_options_t options;
+};
+
+struct kmnd_template_s {
+    kmnd_template_span_t *spans;
+    size_t num_spans;
+
+    /* This is a copy of the format that the spans point into. */
+    char *format;
+};
+
+/**
+ * This function writes the template to the terminal and substitutes each
+ * placeholder with the value at its index. Placeholders without a value are
+ * left empty.
+ */
+void kmnd_template_render(const kmnd_template_t *tmpl,
+                          kmnd_terminal_t *terminal,
+                          const char *const *values, const size_t num_values,
+                          const kmnd_terminal_options_t options);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_template_h */
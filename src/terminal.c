@@ -22,9 +22,12 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #ifdef __linux__
@@ -34,13 +37,90 @@
 #include <sys/ioctl.h>
 #endif
 
+#include "layout.h"
+#include "scan.h"
 #include "terminal.h"
+#include "width.h"
 
-kmnd_terminal_t *kmnd_terminal_new(const int fd) {
-    /* Make sure we stop immediately when passed an invalid file descriptor. */
-    if (fcntl(fd, F_GETFD) == -1)
-        return NULL;
+#define KMND_TERMINAL_DEFAULT_COLUMNS 80
+
+/*
+ * This counter is incremented each time the window of the controlling terminal
+ * is resized. Terminals compare it to their own generation to find out if their
+ * number of columns is out of date.
+ */
+static volatile sig_atomic_t kmnd_terminal_generation = 0;
+
+static struct sigaction kmnd_terminal_previous_action;
+
+static void kmnd_terminal_resized(int signal, siginfo_t *info, void *context) {
+    kmnd_terminal_generation ++;
+
+    /* Make sure that the handler of the application still gets called. */
+    const struct sigaction *previous = &kmnd_terminal_previous_action;
 
+    if (previous->sa_flags & SA_SIGINFO) {
+        if (previous->sa_sigaction != NULL)
+            previous->sa_sigaction(signal, info, context);
+    }else if (previous->sa_handler != SIG_DFL &&
+              previous->sa_handler != SIG_IGN)
+        previous->sa_handler(signal);
+}
+
+static void kmnd_terminal_install_resize(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(struct sigaction));
+
+    action.sa_sigaction = kmnd_terminal_resized;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    struct sigaction previous;
+
+    if (sigaction(SIGWINCH, &action, &previous) != 0)
+        return;
+
+    /* Calling our own handler as the previous one would recurse forever. */
+    if ((previous.sa_flags & SA_SIGINFO) &&
+        previous.sa_sigaction == kmnd_terminal_resized)
+        return;
+
+    kmnd_terminal_previous_action = previous;
+}
+
+static void kmnd_terminal_watch_resize(void) {
+    /* Terminals of different trees may be created on several threads at
+     * once, but the handler must only be installed once. */
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+    pthread_once(&once, kmnd_terminal_install_resize);
+}
+
+static void kmnd_terminal_update_columns(kmnd_terminal_t *terminal) {
+    terminal->generation = (unsigned int) kmnd_terminal_generation;
+
+    struct winsize size = {0};
+
+    if (ioctl(terminal->fd, TIOCGWINSZ, &size) == 0 && size.ws_col != 0)
+        terminal->num_columns = size.ws_col;
+    else
+        terminal->num_columns = KMND_TERMINAL_DEFAULT_COLUMNS;
+}
+
+uint16_t kmnd_terminal_columns(kmnd_terminal_t *terminal) {
+    if (terminal->is_tty &&
+        terminal->generation != (unsigned int) kmnd_terminal_generation)
+        kmnd_terminal_update_columns(terminal);
+
+    return terminal->num_columns;
+}
+
+/*
+ * This function allocates a terminal that writes to the given sink. The file
+ * descriptor is only used to determine whether the output is a TTY.
+ */
+static kmnd_terminal_t *kmnd_terminal_alloc(const kmnd_terminal_sink_t sink,
+                                            const int fd) {
     kmnd_terminal_t *terminal = malloc(sizeof(kmnd_terminal_t));
 
     if (terminal == NULL)
@@ -48,7 +128,61 @@ kmnd_terminal_t *kmnd_terminal_new(const int fd) {
 
     memset(terminal, 0, sizeof(kmnd_terminal_t));
 
+    terminal->sink = sink;
     terminal->fd = fd;
+    terminal->num_columns = KMND_TERMINAL_DEFAULT_COLUMNS;
+
+    if (fd >= 0 && isatty(fd) == 1) {
+        const char *term = getenv("TERM");
+
+        terminal->is_tty = 1;
+        terminal->supports_formatting = (term == NULL ||
+                                         strcmp(term, "dumb") != 0);
+
+        kmnd_terminal_watch_resize();
+        kmnd_terminal_update_columns(terminal);
+    }
+
+    return terminal;
+}
+
+kmnd_terminal_t *kmnd_terminal_new(const int fd) {
+    /* Make sure we stop immediately when passed an invalid file descriptor. */
+    if (fcntl(fd, F_GETFD) == -1)
+        return NULL;
+
+    return kmnd_terminal_alloc(KMND_TERMINAL_SINK_FD, fd);
+}
+
+kmnd_terminal_t *kmnd_terminal_new_file(FILE *file) {
+    if (file == NULL)
+        return NULL;
+
+    kmnd_terminal_t *terminal = kmnd_terminal_alloc(KMND_TERMINAL_SINK_FILE,
+                                                    fileno(file));
+
+    if (terminal != NULL)
+        terminal->file = file;
+
+    return terminal;
+}
+
+kmnd_terminal_t *kmnd_terminal_new_memory(void) {
+    return kmnd_terminal_alloc(KMND_TERMINAL_SINK_MEMORY, -1);
+}
+
+kmnd_terminal_t *kmnd_terminal_new_callback(kmnd_write_cb *callback,
+                                            void *context) {
+    if (callback == NULL)
+        return NULL;
+
+    kmnd_terminal_t *terminal =
+        kmnd_terminal_alloc(KMND_TERMINAL_SINK_CALLBACK, -1);
+
+    if (terminal != NULL) {
+        terminal->callback = callback;
+        terminal->context = context;
+    }
 
     return terminal;
 }
@@ -58,6 +192,20 @@ kmnd_terminal_t *kmnd_terminal_new_default(void) {
 }
 
 void kmnd_terminal_free(kmnd_terminal_t *terminal) {
+    kmnd_terminal_flush(terminal);
+
+    free(terminal->capture);
+    terminal->capture = NULL;
+
+    free(terminal->output);
+    terminal->output = NULL;
+
+    if (terminal->layout != NULL) {
+        kmnd_layout_release(terminal->layout);
+        free(terminal->layout);
+        terminal->layout = NULL;
+    }
+
     if (terminal->is_default)
         return;
 
@@ -76,222 +224,765 @@ kmnd_terminal_t *kmnd_terminal_default(void) {
     return terminal;
 }
 
-unsigned char
-kmnd_terminal_supports_formatting(const kmnd_terminal_t *terminal) {
-    return (unsigned char) (isatty(terminal->fd) == 1);
+/*
+ * This function writes all given vectors to the file descriptor. It retries
+ * when it is interrupted by a signal and continues where it left off after a
+ * partial write.
+ */
+static int kmnd_terminal_writev(const int fd, struct iovec *vectors,
+                                int num_vectors) {
+    while (num_vectors > 0) {
+        ssize_t res = writev(fd, vectors, num_vectors);
+
+        if (res < 0) {
+            if (errno == EINTR)
+                continue;
+
+            return -1;
+        }
+
+        size_t written = (size_t) res;
+
+        while (num_vectors > 0 && written >= vectors->iov_len) {
+            written -= vectors->iov_len;
+            vectors ++;
+            num_vectors --;
+        }
+
+        if (num_vectors > 0) {
+            vectors->iov_base = (char *) vectors->iov_base + written;
+            vectors->iov_len -= written;
+        }
+    }
+
+    return 0;
 }
 
-static uint8_t kmnd_terminal_pop_count(kmnd_terminal_options_t options) {
-    uint8_t count = 0;
+/*
+ * This function appends the given bytes to a growable block of memory, which
+ * is kept terminated. It returns -1 if the memory cannot grow.
+ */
+static int kmnd_terminal_append(char **memory, size_t *length, size_t *size,
+                                const char *data, const size_t count) {
+    if (*length + count + 1 > *size) {
+        size_t grown = *size ? *size : KMND_TERMINAL_BUFFER_SIZE;
+
+        while (grown < *length + count + 1)
+            grown *= 2;
+
+        char *resized = realloc(*memory, grown);
 
-    while (options > 0) {
-        if ((options & 1) == 1)
-            count += 1;
+        if (resized == NULL)
+            return -1;
 
-        options >>= 1;
+        *memory = resized;
+        *size = grown;
     }
 
-    return count;
+    memcpy(*memory + *length, data, count);
+    *length += count;
+    (*memory)[*length] = '\0';
+
+    return 0;
+}
+
+/*
+ * This function appends the given bytes to the capture if the terminal is
+ * capturing. Capturing stops if the capture cannot grow.
+ */
+static void kmnd_terminal_record(kmnd_terminal_t *terminal, const char *data,
+                                 const size_t length) {
+    if (!terminal->capturing || length == 0)
+        return;
+
+    if (kmnd_terminal_append(&terminal->capture, &terminal->capture_length,
+                             &terminal->capture_size, data, length) != 0) {
+        free(terminal->capture);
+        terminal->capture = NULL;
+        terminal->capture_length = 0;
+        terminal->capture_size = 0;
+        terminal->capturing = 0;
+    }
 }
 
+/*
+ * This function passes the given vectors to the sink of the terminal.
+ */
+static int kmnd_terminal_emit(kmnd_terminal_t *terminal,
+                              struct iovec *vectors, const int num_vectors) {
+    if (terminal->sink == KMND_TERMINAL_SINK_FD)
+        return kmnd_terminal_writev(terminal->fd, vectors, num_vectors);
+
+    int i;
+    for (i = 0; i < num_vectors; i ++) {
+        const char *data = vectors[i].iov_base;
+        const size_t length = vectors[i].iov_len;
+
+        if (length == 0)
+            continue;
+
+        int res = 0;
+
+        switch (terminal->sink) {
+        case KMND_TERMINAL_SINK_MEMORY:
+            res = kmnd_terminal_append(&terminal->output,
+                                       &terminal->output_length,
+                                       &terminal->output_size, data, length);
+            break;
+
+        case KMND_TERMINAL_SINK_FILE:
+            res = (fwrite(data, 1, length, terminal->file) == length) ? 0 : -1;
+            break;
+
+        case KMND_TERMINAL_SINK_CALLBACK:
+            res = terminal->callback(terminal->context, data, length);
+            break;
+
+        default:
+            break;
+        }
+
+        if (res != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * This function writes the buffer to the sink of the terminal.
+ */
+static int kmnd_terminal_drain(kmnd_terminal_t *terminal) {
+    if (terminal->buffer_length == 0)
+        return 0;
+
+    kmnd_terminal_record(terminal, terminal->buffer, terminal->buffer_length);
+
+    struct iovec vector = { terminal->buffer, terminal->buffer_length };
+
+    terminal->buffer_length = 0;
+
+    return kmnd_terminal_emit(terminal, &vector, 1);
+}
+
+/*
+ * This function appends the given bytes to the buffer of the terminal. If they
+ * do not fit, the buffer and the bytes are written together in a single call.
+ */
+static void kmnd_terminal_write(kmnd_terminal_t *terminal, const char *data,
+                                const size_t length) {
+    if (terminal->buffer_length + length <= KMND_TERMINAL_BUFFER_SIZE) {
+        memcpy(terminal->buffer + terminal->buffer_length, data, length);
+        terminal->buffer_length += length;
+        return;
+    }
+
+    if (length < KMND_TERMINAL_BUFFER_SIZE) {
+        kmnd_terminal_drain(terminal);
+
+        memcpy(terminal->buffer, data, length);
+        terminal->buffer_length = length;
+        return;
+    }
+
+    kmnd_terminal_record(terminal, terminal->buffer, terminal->buffer_length);
+    kmnd_terminal_record(terminal, data, length);
+
+    struct iovec vectors[2] = {
+        { terminal->buffer, terminal->buffer_length },
+        { (char *) data, length }
+    };
+
+    terminal->buffer_length = 0;
+
+    kmnd_terminal_emit(terminal, vectors, 2);
+}
+
+unsigned char
+kmnd_terminal_supports_formatting(const kmnd_terminal_t *terminal) {
+    return terminal->supports_formatting;
+}
+
+/* These are the options that translate into SGR escape codes. */
+#define KMND_TERMINAL_STYLES      ((kmnd_terminal_options_t) 0xFFFFFC)
+#define KMND_TERMINAL_FOREGROUNDS ((kmnd_terminal_options_t) 0x00FF00)
+#define KMND_TERMINAL_BACKGROUNDS ((kmnd_terminal_options_t) 0xFF0000)
+
+/*
+ * This table contains the SGR codes (including the separator) that turn each
+ * option on and off. It is indexed by the bit number of the option.
+ */
 static const struct {
-    kmnd_terminal_options_t option;
-    const char *code;
-} kmnd_terminal_codes[] = {
-    { KMND_TERMINAL_STYLE_BOLD,         "1;" },
-    { KMND_TERMINAL_STYLE_ITALIC,       "3;" },
-    { KMND_TERMINAL_STYLE_UNDERLINE,    "4;" },
-
-    { KMND_TERMINAL_EFFECT_BLINK,       "5;" },
-    { KMND_TERMINAL_EFFECT_REVERSED,    "7;" },
-    { KMND_TERMINAL_EFFECT_CONCEALED,   "8;" },
-
-    { KMND_TERMINAL_FOREGROUND_BLACK,   "30;" },
-    { KMND_TERMINAL_FOREGROUND_RED,     "31;" },
-    { KMND_TERMINAL_FOREGROUND_GREEN,   "32;" },
-    { KMND_TERMINAL_FOREGROUND_YELLOW,  "33;" },
-    { KMND_TERMINAL_FOREGROUND_BLUE,    "34;" },
-    { KMND_TERMINAL_FOREGROUND_MAGENTA, "35;" },
-    { KMND_TERMINAL_FOREGROUND_CYAN,    "36;" },
-    { KMND_TERMINAL_FOREGROUND_WHITE,   "37;" },
-
-    { KMND_TERMINAL_BACKGROUND_BLACK,   "40;" },
-    { KMND_TERMINAL_BACKGROUND_RED,     "41;" },
-    { KMND_TERMINAL_BACKGROUND_GREEN,   "42;" },
-    { KMND_TERMINAL_BACKGROUND_YELLOW,  "43;" },
-    { KMND_TERMINAL_BACKGROUND_BLUE,    "44;" },
-    { KMND_TERMINAL_BACKGROUND_MAGENTA, "45;" },
-    { KMND_TERMINAL_BACKGROUND_CYAN,    "46;" },
-    { KMND_TERMINAL_BACKGROUND_WHITE,   "47;" },
+    const char *on;
+    const char *off;
+} kmnd_terminal_codes[24] = {
+    [2]  = { "1;",  "22;" }, /* KMND_TERMINAL_STYLE_BOLD */
+    [3]  = { "3;",  "23;" }, /* KMND_TERMINAL_STYLE_ITALIC */
+    [4]  = { "4;",  "24;" }, /* KMND_TERMINAL_STYLE_UNDERLINE */
+
+    [5]  = { "5;",  "25;" }, /* KMND_TERMINAL_EFFECT_BLINK */
+    [6]  = { "7;",  "27;" }, /* KMND_TERMINAL_EFFECT_REVERSED */
+    [7]  = { "8;",  "28;" }, /* KMND_TERMINAL_EFFECT_CONCEALED */
+
+    [8]  = { "30;", "39;" }, /* KMND_TERMINAL_FOREGROUND_BLACK */
+    [9]  = { "31;", "39;" }, /* KMND_TERMINAL_FOREGROUND_RED */
+    [10] = { "32;", "39;" }, /* KMND_TERMINAL_FOREGROUND_GREEN */
+    [11] = { "33;", "39;" }, /* KMND_TERMINAL_FOREGROUND_YELLOW */
+    [12] = { "34;", "39;" }, /* KMND_TERMINAL_FOREGROUND_BLUE */
+    [13] = { "35;", "39;" }, /* KMND_TERMINAL_FOREGROUND_MAGENTA */
+    [14] = { "36;", "39;" }, /* KMND_TERMINAL_FOREGROUND_CYAN */
+    [15] = { "37;", "39;" }, /* KMND_TERMINAL_FOREGROUND_WHITE */
+
+    [16] = { "40;", "49;" }, /* KMND_TERMINAL_BACKGROUND_BLACK */
+    [17] = { "41;", "49;" }, /* KMND_TERMINAL_BACKGROUND_RED */
+    [18] = { "42;", "49;" }, /* KMND_TERMINAL_BACKGROUND_GREEN */
+    [19] = { "43;", "49;" }, /* KMND_TERMINAL_BACKGROUND_YELLOW */
+    [20] = { "44;", "49;" }, /* KMND_TERMINAL_BACKGROUND_BLUE */
+    [21] = { "45;", "49;" }, /* KMND_TERMINAL_BACKGROUND_MAGENTA */
+    [22] = { "46;", "49;" }, /* KMND_TERMINAL_BACKGROUND_CYAN */
+    [23] = { "47;", "49;" }, /* KMND_TERMINAL_BACKGROUND_WHITE */
 };
 
-static void kmnd_terminal_start_options(kmnd_terminal_t *terminal,
-                                        const kmnd_terminal_options_t options) {
-    if (kmnd_terminal_supports_formatting(terminal) == 0)
+static size_t kmnd_terminal_append_code(char *string, size_t length,
+                                        const char *code) {
+    while (*code != '\0')
+        string[length ++] = *code ++;
+
+    return length;
+}
+
+static size_t kmnd_terminal_append_codes(char *string, size_t length,
+                                         kmnd_terminal_options_t options,
+                                         const unsigned char on) {
+    while (options != 0) {
+        const int bit = __builtin_ctz((unsigned int) options);
+
+        length = kmnd_terminal_append_code(string, length,
+                                           on ? kmnd_terminal_codes[bit].on :
+                                                kmnd_terminal_codes[bit].off);
+
+        options &= options - 1;
+    }
+
+    return length;
+}
+
+/*
+ * This function makes sure that the style of the output matches the style
+ * requested for the next text. Only the difference between both styles is
+ * written.
+ */
+static void kmnd_terminal_apply_style(kmnd_terminal_t *terminal) {
+    const kmnd_terminal_options_t current = terminal->style;
+    const kmnd_terminal_options_t target = terminal->next_style;
+
+    if (current == target)
         return;
 
-    const uint8_t count = kmnd_terminal_pop_count(options);
+    terminal->style = target;
 
-    if (count == 0)
+    if (kmnd_terminal_supports_formatting(terminal) == 0)
         return;
 
-    char string[2 + count * 2];
-    strcpy(string, "\x1B[");
+    if (target == 0) {
+        kmnd_terminal_write(terminal, "\x1B[0m", 4);
+        return;
+    }
+
+    const kmnd_terminal_options_t groups[2] = {
+        KMND_TERMINAL_FOREGROUNDS, KMND_TERMINAL_BACKGROUNDS
+    };
+
+    const kmnd_terminal_options_t attributes = KMND_TERMINAL_STYLES &
+                                               ~KMND_TERMINAL_FOREGROUNDS &
+                                               ~KMND_TERMINAL_BACKGROUNDS;
+
+    char string[2 + 24 * 3];
+    size_t length = 0;
 
-    const size_t num_codes = sizeof(kmnd_terminal_codes) /
-                             sizeof(*kmnd_terminal_codes);
+    string[length ++] = '\x1B';
+    string[length ++] = '[';
 
+    /* Attributes are turned on and off individually. */
+    length = kmnd_terminal_append_codes(string, length,
+                                        current & ~target & attributes, 0);
+    length = kmnd_terminal_append_codes(string, length,
+                                        target & ~current & attributes, 1);
+
+    /* Colors replace each other, so a changed color is written in full. */
     size_t i;
-    for (i = 0; i < num_codes; i ++) {
-        if ((options & kmnd_terminal_codes[i].option) ==
-            kmnd_terminal_codes[i].option) {
-            strcat(string, kmnd_terminal_codes[i].code);
+    for (i = 0; i < 2; i ++) {
+        if ((current & groups[i]) == (target & groups[i]))
+            continue;
+
+        if ((target & groups[i]) == 0) {
+            const int bit = __builtin_ctz((unsigned int) groups[i]);
+
+            length = kmnd_terminal_append_code(string, length,
+                                               kmnd_terminal_codes[bit].off);
         }
+
+        length = kmnd_terminal_append_codes(string, length,
+                                            target & groups[i], 1);
     }
 
     /* Replace the last semicolon with the `m`. */
-    string[strlen(string) - 1] = 'm';
+    string[length - 1] = 'm';
 
-    write(terminal->fd, string, strlen(string));
+    kmnd_terminal_write(terminal, string, length);
+}
+
+static void kmnd_terminal_start_options(kmnd_terminal_t *terminal,
+                                        const kmnd_terminal_options_t options) {
+    terminal->next_style = options & KMND_TERMINAL_STYLES;
 }
 
 static void kmnd_terminal_end_options(kmnd_terminal_t *terminal) {
-    if (kmnd_terminal_supports_formatting(terminal) == 0)
+    terminal->next_style = 0;
+}
+
+int kmnd_terminal_flush(kmnd_terminal_t *terminal) {
+    /* Make sure that the style does not leak into output that follows. */
+    kmnd_terminal_end_options(terminal);
+    kmnd_terminal_apply_style(terminal);
+
+    const int res = kmnd_terminal_drain(terminal);
+
+    if (terminal->sink == KMND_TERMINAL_SINK_FILE &&
+        fflush(terminal->file) != 0)
+        return -1;
+
+    return res;
+}
+
+const char *kmnd_terminal_output(kmnd_terminal_t *terminal, size_t *length) {
+    if (terminal->sink != KMND_TERMINAL_SINK_MEMORY)
+        return NULL;
+
+    kmnd_terminal_flush(terminal);
+
+    *length = terminal->output_length;
+
+    return (terminal->output != NULL) ? terminal->output : "";
+}
+
+void kmnd_terminal_output_clear(kmnd_terminal_t *terminal) {
+    if (terminal->sink != KMND_TERMINAL_SINK_MEMORY)
         return;
 
-    write(terminal->fd, "\x1B[0m", 4);
+    kmnd_terminal_flush(terminal);
+
+    terminal->output_length = 0;
+
+    if (terminal->output != NULL)
+        terminal->output[0] = '\0';
 }
 
-static void kmnd_terminal_size(kmnd_terminal_t *terminal, uint16_t *num_columns,
-                               uint16_t *num_rows) {
-    if (num_columns == NULL && num_rows == NULL)
+/*
+ * This function writes text that is visible to the user, in the style that is
+ * requested for it.
+ */
+static void kmnd_terminal_write_text(kmnd_terminal_t *terminal,
+                                     const char *text, const size_t length) {
+    if (length == 0)
         return;
 
-    struct winsize size = {0};
-    ioctl(terminal-> fd, TIOCGWINSZ, &size);
+    kmnd_terminal_apply_style(terminal);
+    kmnd_terminal_write(terminal, text, length);
+}
 
-    if (num_columns != NULL)
-        *num_columns = size.ws_col;
+/*
+ * This function starts a new line and writes the indent (if any), after which
+ * the given options are restored.
+ */
+static void kmnd_terminal_newline(kmnd_terminal_t *terminal,
+                                  const kmnd_terminal_options_t options) {
+    terminal->line_chars = 0;
 
-    if (num_rows != NULL)
-        *num_rows = size.ws_row;
+    kmnd_terminal_write(terminal, "\n", 1);
+
+    if (terminal->indent == NULL)
+        return;
+
+    kmnd_terminal_end_options(terminal);
+    kmnd_terminal_start_options(terminal, terminal->indent_options);
+
+    kmnd_terminal_write_text(terminal, terminal->indent,
+                             strlen(terminal->indent));
+
+    terminal->line_chars += terminal->indent_width;
+
+    kmnd_terminal_end_options(terminal);
+    kmnd_terminal_start_options(terminal, options);
 }
 
-void kmnd_terminal_text(kmnd_terminal_t *terminal, const char *text,
-                        const kmnd_terminal_options_t options) {
+/*
+ * This function writes the given range of the layout text, in the formatting
+ * options of the runs it overlaps.
+ */
+static void kmnd_terminal_write_runs(kmnd_terminal_t *terminal,
+                                     const kmnd_layout_t *layout, size_t *run,
+                                     size_t start, const size_t end,
+                                     const kmnd_terminal_options_t options) {
+    while (start < end) {
+        while (*run + 1 < layout->num_runs &&
+               layout->runs[*run].end <= start)
+            (*run) ++;
+
+        size_t stop = end;
+
+        if (layout->runs[*run].end > start && layout->runs[*run].end < stop)
+            stop = layout->runs[*run].end;
+
+        kmnd_terminal_start_options(terminal,
+                                    options | layout->runs[*run].options);
+        kmnd_terminal_write_text(terminal, layout->text + start,
+                                 stop - start);
+
+        start = stop;
+    }
+}
+
+/*
+ * This function writes the given range of the layout text, wrapping it by
+ * character if it does not fit on the line (e.g. a very long word).
+ */
+static void kmnd_terminal_write_range(kmnd_terminal_t *terminal,
+                                      const kmnd_layout_t *layout,
+                                      size_t *run, size_t start,
+                                      const size_t end,
+                                      const kmnd_terminal_options_t options) {
+    while (start < end) {
+        size_t width;
+        const size_t length = kmnd_layout_piece(layout, start, end,
+                                                terminal->line_chars,
+                                                layout->max_width,
+                                                layout->indent_width, &width);
+
+        if (length == 0) {
+            kmnd_terminal_newline(terminal, options);
+            continue;
+        }
+
+        kmnd_terminal_write_runs(terminal, layout, run, start, start + length,
+                                 options);
+
+        terminal->line_chars += width;
+        start += length;
+    }
+}
+
+void kmnd_terminal_layout(kmnd_terminal_t *terminal, kmnd_layout_t *layout,
+                          const kmnd_terminal_options_t options) {
     kmnd_terminal_start_options(terminal, options);
 
-    uint16_t max_chars;
-    kmnd_terminal_size(terminal, &max_chars, NULL);
+    kmnd_layout_break(layout, kmnd_terminal_columns(terminal),
+                      terminal->line_chars, terminal->indent_width,
+                      terminal->balanced ? KMND_LAYOUT_BALANCED :
+                                           KMND_LAYOUT_GREEDY);
 
-    if (max_chars == 0)
-        max_chars = 80;
+    size_t run = 0;
+
+    /* Tokens that fit on the current line are collected and written at
+     * once. */
+    size_t pending = 0;
+    size_t pending_end = 0;
 
     size_t i;
-    for (i = 0; i < strlen(text); i ++) {
-        if (text[i] == '\n' ||
-            terminal->line_chars == max_chars) {
-            terminal->line_chars = 0;
+    for (i = 0; i < layout->num_tokens; i ++) {
+        const kmnd_layout_token_t *token = &layout->tokens[i];
 
-            write(terminal->fd, "\n", 1);
+        /* The spaces at which a line is wrapped are not written. */
+        const size_t end = token->start + token->spaces + token->length;
+        const size_t start = token->start + (token->wrap ? token->spaces : 0);
+        const size_t width = end - start - token->length + token->width;
 
-            if (terminal->indent != NULL) {
-                kmnd_terminal_end_options(terminal);
-                kmnd_terminal_start_options(terminal, terminal->indent_options);
+        if (token->newline || token->wrap) {
+            kmnd_terminal_write_runs(terminal, layout, &run, pending,
+                                     pending_end, options);
+            kmnd_terminal_newline(terminal, options);
 
-                write(terminal->fd, terminal->indent, strlen(terminal->indent));
+            pending = start;
+        }
 
-                terminal->line_chars += strlen(terminal->indent);
+        if (terminal->line_chars + width <= layout->max_width) {
+            terminal->line_chars += (uint16_t) width;
+        }else {
+            kmnd_terminal_write_runs(terminal, layout, &run, pending,
+                                     pending_end, options);
+            kmnd_terminal_write_range(terminal, layout, &run, start,
+                                      end, options);
 
-                kmnd_terminal_end_options(terminal);
-                kmnd_terminal_start_options(terminal, options);
-            }
+            pending = end;
+        }
 
-            if (text[i] == '\n')
-                continue;
+        pending_end = end;
+    }
+
+    kmnd_terminal_write_runs(terminal, layout, &run, pending, pending_end,
+                             options);
+
+    kmnd_terminal_end_options(terminal);
+
+    if ((options & KMND_TERMINAL_OPTIONS_NO_NEWLINE) == 0) {
+        kmnd_terminal_write(terminal, "\n", 1);
+        terminal->line_chars = 0;
+    }
+}
+
+/*
+ * This function replaces the text of the layout of the terminal, which is
+ * created the first time it is used. It returns NULL if memory could not be
+ * allocated.
+ */
+static kmnd_layout_t *kmnd_terminal_set_layout(kmnd_terminal_t *terminal,
+                                               const char *text,
+                                               const size_t length,
+                                               const unsigned char markup) {
+    if (terminal->layout == NULL) {
+        terminal->layout = malloc(sizeof(kmnd_layout_t));
+
+        if (terminal->layout == NULL)
+            return NULL;
+
+        if (kmnd_layout_init(terminal->layout, text, length, markup) != 0) {
+            free(terminal->layout);
+            terminal->layout = NULL;
+            return NULL;
         }
 
-        write(terminal->fd, text + i, 1);
+        return terminal->layout;
+    }
+
+    if (kmnd_layout_set(terminal->layout, text, length, markup) != 0)
+        return NULL;
+
+    return terminal->layout;
+}
+
+void kmnd_terminal_span(kmnd_terminal_t *terminal, const char *text,
+                        const size_t length,
+                        const kmnd_terminal_options_t options) {
+    kmnd_layout_t *layout = kmnd_terminal_set_layout(terminal, text, length,
+                                                     0);
+
+    if (layout != NULL) {
+        kmnd_terminal_layout(terminal, layout, options);
+        return;
+    }
+
+    /* Without memory for the layout, the text is written without wrapping
+     * rather than not at all. */
+    kmnd_terminal_start_options(terminal, options);
+
+    size_t start = 0;
 
-        terminal->line_chars ++;
+    while (start < length) {
+        const char *newline = memchr(text + start, '\n', length - start);
+        const size_t end = (newline != NULL) ? (size_t) (newline - text) :
+                                               length;
+
+        kmnd_terminal_write_text(terminal, text + start, end - start);
+        terminal->line_chars += (uint16_t) kmnd_width(text + start,
+                                                    end - start);
+
+        if (newline == NULL)
+            break;
+
+        kmnd_terminal_newline(terminal, options);
+        start = end + 1;
     }
 
     kmnd_terminal_end_options(terminal);
 
     if ((options & KMND_TERMINAL_OPTIONS_NO_NEWLINE) == 0) {
-        write(terminal->fd, "\n", 1);
+        kmnd_terminal_write(terminal, "\n", 1);
         terminal->line_chars = 0;
     }
 }
 
+void kmnd_terminal_span_width(kmnd_terminal_t *terminal, const char *text,
+                              const size_t length, const size_t width,
+                              const kmnd_terminal_options_t options) {
+    /* Text that fits is not wrapped by the layout either. */
+    if (terminal->line_chars + width > kmnd_terminal_columns(terminal)) {
+        kmnd_terminal_span(terminal, text, length, options);
+        return;
+    }
+
+    kmnd_terminal_start_options(terminal, options);
+    kmnd_terminal_write_text(terminal, text, length);
+    kmnd_terminal_end_options(terminal);
+
+    terminal->line_chars += (uint16_t) width;
+
+    if ((options & KMND_TERMINAL_OPTIONS_NO_NEWLINE) == 0) {
+        kmnd_terminal_write(terminal, "\n", 1);
+        terminal->line_chars = 0;
+    }
+}
+
+void kmnd_terminal_text(kmnd_terminal_t *terminal, const char *text,
+                        const kmnd_terminal_options_t options) {
+    kmnd_terminal_span(terminal, text, strlen(text), options);
+}
+
 #define CODE_OPTIONS KMND_TERMINAL_FOREGROUND_MAGENTA
 
-void kmnd_terminal_format(kmnd_terminal_t *terminal, const char *text,
-                          const kmnd_terminal_options_t options) {
-    char buffer[strlen(text) + 1];
-    buffer[0] = '\0';
+void kmnd_terminal_markup(const char *text, const size_t length,
+                          const unsigned char placeholders,
+                          kmnd_terminal_markup_cb *callback, void *context) {
+    kmnd_terminal_options_t extra = 0;
+
+    /* This is the start of the text that has not been passed on yet. */
+    size_t start = 0;
 
-    kmnd_terminal_options_t extra = KMND_TERMINAL_OPTIONS_NO_NEWLINE;
+    const size_t num_needles = placeholders ? 4 : 3;
 
     size_t i;
-    for (i = 0; i < strlen(text); i ++) {
-        if (text[i] == '`') {
-            /* Check if double `. */
-            const char twice = (i + 1 < strlen(text) &&
-                                text[i + 1] == text[i]);
+    for (i = 0; i < length; i ++) {
+        /* Skip over plain text in bulk. */
+        i += kmnd_scan_any(text + i, length - i, "`*_{", num_needles);
 
-            if (twice)
-                i ++;
+        if (i == length)
+            break;
 
-            if (twice && (extra & CODE_OPTIONS))
-                strncat(buffer, text + i, 1);
+        const char c = text[i];
 
-            kmnd_terminal_text(terminal, buffer, options | extra);
-            buffer[0] = '\0';
+        if (c == '`') {
+            /* Check if double `. A double ` is written as a single ` but only
+             * within the code. */
+            const char twice = (i + 1 < length && text[i + 1] == c);
+            const char code = (extra & CODE_OPTIONS) != 0;
 
-            if (extra & CODE_OPTIONS)
-                extra &= ~CODE_OPTIONS;
-            else
-                extra |= CODE_OPTIONS;
+            const size_t end = (twice && code) ? i + 1 : i;
 
-            if (twice && (extra & CODE_OPTIONS))
-                strncat(buffer, text + i, 1);
+            if (end > start)
+                callback(context, text + start, end - start, extra, -1);
 
-            continue;
-        }else if (text[i] == '*' || text[i] == '_') {
+            if (twice)
+                i ++;
+
+            extra ^= CODE_OPTIONS;
+
+            start = (twice && !code) ? i : i + 1;
+        }else if (c == '*' || c == '_') {
             /* Check if twice. */
-            const char twice = (i + 1 < strlen(text) &&
-                                text[i + 1] == text[i]);
+            const char twice = (i + 1 < length && text[i + 1] == c);
 
-            kmnd_terminal_text(terminal, buffer, options | extra);
-            buffer[0] = '\0';
+            if (i > start)
+                callback(context, text + start, i - start, extra, -1);
 
             if (twice) {
-                if (extra & KMND_TERMINAL_STYLE_BOLD)
-                    extra &= ~KMND_TERMINAL_STYLE_BOLD;
-                else
-                    extra |= KMND_TERMINAL_STYLE_BOLD;
-            }else {
-                if (extra & KMND_TERMINAL_STYLE_UNDERLINE)
-                    extra &= ~KMND_TERMINAL_STYLE_UNDERLINE;
-                else
-                    extra |= KMND_TERMINAL_STYLE_UNDERLINE;
-            }
+                extra ^= KMND_TERMINAL_STYLE_BOLD;
+                i ++;
+            }else
+                extra ^= KMND_TERMINAL_STYLE_UNDERLINE;
 
-            continue;
+            start = i + 1;
+        }else if (c == '{' && placeholders) {
+            /* Find the closing brace of the placeholder, e.g. {0}. A double
+             * brace is written as a single brace. */
+            size_t j = i + 1;
+            int index = 0;
+
+            while (j < length && text[j] >= '0' && text[j] <= '9' &&
+                   index < 10000)
+                index = index * 10 + (text[j ++] - '0');
+
+            const char escaped = (j == i + 1 && j < length && text[j] == '{');
+            const char valid = (j > i + 1 && j < length && text[j] == '}');
+
+            if (!escaped && !valid)
+                continue;
+
+            if (i + escaped > start)
+                callback(context, text + start, i + escaped - start, extra,
+                         -1);
+
+            if (valid)
+                callback(context, NULL, 0, extra, index);
+
+            i = j;
+            start = i + 1;
         }
+    }
+
+    if (length > start)
+        callback(context, text + start, length - start, extra, -1);
+}
+
+typedef struct kmnd_terminal_format_s {
+    kmnd_terminal_t *terminal;
+    kmnd_terminal_options_t options;
+} kmnd_terminal_format_t;
+
+static void kmnd_terminal_format_span(void *context, const char *text,
+                                      const size_t length,
+                                      const kmnd_terminal_options_t options,
+                                      const int placeholder) {
+    kmnd_terminal_format_t *format = (kmnd_terminal_format_t *) context;
 
-        strncat(buffer, text + i, 1);
+    kmnd_terminal_span(format->terminal, text, length,
+                       format->options | options |
+                       KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+}
+
+void kmnd_terminal_format(kmnd_terminal_t *terminal, const char *text,
+                          const kmnd_terminal_options_t options) {
+    kmnd_layout_t *layout = kmnd_terminal_set_layout(terminal, text,
+                                                     strlen(text), 1);
+
+    if (layout != NULL) {
+        kmnd_terminal_layout(terminal, layout, options);
+        return;
     }
 
-    kmnd_terminal_text(terminal, buffer, options | extra);
+    /* Without memory for the layout, write each span on its own. */
+    kmnd_terminal_format_t format = { terminal, options };
+
+    kmnd_terminal_markup(text, strlen(text), 0, kmnd_terminal_format_span,
+                         &format);
 
     if (!(options & KMND_TERMINAL_OPTIONS_NO_NEWLINE))
-        kmnd_terminal_text(terminal, "", options);
+        kmnd_terminal_span(terminal, "", 0, options);
+}
+
+void kmnd_terminal_balance(kmnd_terminal_t *terminal,
+                           const unsigned char enabled) {
+    terminal->balanced = enabled;
+}
+
+void kmnd_terminal_raw(kmnd_terminal_t *terminal, const char *data,
+                       const size_t length) {
+    kmnd_terminal_write(terminal, data, length);
+}
+
+void kmnd_terminal_capture_start(kmnd_terminal_t *terminal) {
+    kmnd_terminal_flush(terminal);
+
+    terminal->capturing = 1;
+    terminal->capture_length = 0;
+}
+
+char *kmnd_terminal_capture_end(kmnd_terminal_t *terminal, size_t *length) {
+    kmnd_terminal_flush(terminal);
+
+    char *capture = terminal->capture;
+    *length = terminal->capture_length;
+
+    terminal->capturing = 0;
+    terminal->capture = NULL;
+    terminal->capture_length = 0;
+    terminal->capture_size = 0;
+
+    return capture;
 }
 
 void kmnd_terminal_indent(kmnd_terminal_t *terminal, const char *indent,
                           const kmnd_terminal_options_t options) {
     terminal->indent = indent;
     terminal->indent_options = options;
+    terminal->indent_width = (indent != NULL) ?
+                             (uint16_t) kmnd_width(indent, strlen(indent)) : 0;
 }
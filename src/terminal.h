@@ -27,10 +27,31 @@
 extern "C" {
 #endif /* __cplusplus */
 
+#include <kmnd.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+
+/*
+ * This is the number of bytes a terminal collects before it writes them to its
+ * file descriptor.
+ */
+#define KMND_TERMINAL_BUFFER_SIZE 4096
 
 typedef struct kmnd_terminal_s kmnd_terminal_t;
 
+struct kmnd_layout_s;
+
+/*
+ * This is where a terminal writes its output to.
+ */
+typedef enum kmnd_terminal_sink_e {
+    KMND_TERMINAL_SINK_FD       = 0,
+    KMND_TERMINAL_SINK_MEMORY   = 1,
+    KMND_TERMINAL_SINK_FILE     = 2,
+    KMND_TERMINAL_SINK_CALLBACK = 3
+} kmnd_terminal_sink_t;
+
 typedef enum kmnd_terminal_options_e {
     KMND_TERMINAL_OPTIONS_NONE = (1 << 0),
 
@@ -64,13 +85,65 @@ typedef enum kmnd_terminal_options_e {
 } kmnd_terminal_options_t;
 
 struct kmnd_terminal_s {
+    kmnd_terminal_sink_t sink;
+
+    /* This is the file descriptor of a fd sink and of the stream of a FILE
+     * sink (or -1 if it has none). */
     int fd;
+    FILE *file;
+
+    kmnd_write_cb *callback;
+    void *context;
+
+    /* This is the output of a memory sink, which is always terminated. */
+    char *output;
+    size_t output_length;
+    size_t output_size;
+
     unsigned char is_default;
 
+    /* These are determined once when the terminal is created. */
+    unsigned char is_tty;
+    unsigned char supports_formatting;
+
+    /* This is the number of columns of the terminal window. It is determined
+     * again when the window has been resized since (i.e. when `generation` no
+     * longer matches the number of SIGWINCH signals received). */
+    uint16_t num_columns;
+    unsigned int generation;
+
     const char *indent;
     kmnd_terminal_options_t indent_options;
+    uint16_t indent_width;
 
+    /* This is the number of columns (not bytes) written to the current
+     * line. */
     uint16_t line_chars;
+
+    /* This is set if lines are broken with the balanced (minimum raggedness)
+     * layout instead of the greedy layout. */
+    unsigned char balanced;
+
+    /* This layout is reused for all text that is written, so that its memory
+     * is only allocated once. */
+    struct kmnd_layout_s *layout;
+
+    /* This is the style of the output written so far and the style that is
+     * requested for the next text. Escape codes are only written when the
+     * next text is written and both styles differ. */
+    kmnd_terminal_options_t style;
+    kmnd_terminal_options_t next_style;
+
+    /* Text, escape codes and indents are collected in this buffer and written
+     * at once when the buffer fills up or when the terminal is flushed. */
+    char buffer[KMND_TERMINAL_BUFFER_SIZE];
+    size_t buffer_length;
+
+    /* While capturing, a copy of everything that is written is kept here. */
+    unsigned char capturing;
+    char *capture;
+    size_t capture_length;
+    size_t capture_size;
 };
 
 /**
@@ -80,6 +153,39 @@ struct kmnd_terminal_s {
  */
 kmnd_terminal_t *kmnd_terminal_new(const int fd);
 
+/**
+ * This function returns a new terminal that writes to the given stream. It is
+ * treated like a file descriptor terminal if the stream has one.
+ */
+kmnd_terminal_t *kmnd_terminal_new_file(FILE *file);
+
+/**
+ * This function returns a new terminal that collects its output in memory,
+ * without any system calls. Use kmnd_terminal_output to retrieve it.
+ */
+kmnd_terminal_t *kmnd_terminal_new_memory(void);
+
+/**
+ * This function returns a new terminal that passes its output to the given
+ * callback, in chunks of at most KMND_TERMINAL_BUFFER_SIZE bytes (unless a
+ * single write is larger).
+ */
+kmnd_terminal_t *kmnd_terminal_new_callback(kmnd_write_cb *callback,
+                                            void *context);
+
+/**
+ * This function returns the output of a memory terminal so far, after
+ * flushing it, and stores its length in `length`. The output remains owned by
+ * the terminal. NULL is returned for other terminals.
+ */
+const char *kmnd_terminal_output(kmnd_terminal_t *terminal, size_t *length);
+
+/**
+ * This function discards the output of a memory terminal, keeping the memory
+ * for output that follows.
+ */
+void kmnd_terminal_output_clear(kmnd_terminal_t *terminal);
+
 /**
  * This function returns a singleton of the default terminal for stdout. Note
  * that calling this function twice will return the same pointer. Also note that
@@ -93,7 +199,8 @@ kmnd_terminal_t *kmnd_terminal_default(void);
 kmnd_terminal_t *kmnd_terminal_new_default(void);
 
 /**
- * This function frees up memory and other resources used by this terminal.
+ * This function frees up memory and other resources used by this terminal. Any
+ * output that is still buffered is flushed first.
  */
 void kmnd_terminal_free(kmnd_terminal_t *terminal);
 
@@ -108,11 +215,29 @@ kmnd_terminal_supports_formatting(const kmnd_terminal_t *terminal);
 
 /**
  * This function writes the given string to the terminal with the given text
- * formatting options.
+ * formatting options. Lines are wrapped between words where possible.
  */
 void kmnd_terminal_text(kmnd_terminal_t *terminal, const char *text,
                         const kmnd_terminal_options_t options);
 
+/**
+ * This function is very similar to _text except that it writes exactly
+ * `length` bytes of the given text, which does not have to be terminated. If
+ * memory for wrapping the text cannot be allocated, it is written unwrapped.
+ */
+void kmnd_terminal_span(kmnd_terminal_t *terminal, const char *text,
+                        const size_t length,
+                        const kmnd_terminal_options_t options);
+
+/**
+ * This function is very similar to _span but for text without newlines whose
+ * width (see kmnd_width) is already known. If it fits on the current line, it
+ * is written as-is without laying it out first.
+ */
+void kmnd_terminal_span_width(kmnd_terminal_t *terminal, const char *text,
+                              const size_t length, const size_t width,
+                              const kmnd_terminal_options_t options);
+
 /**
  * This function is very similar to _text except that it does additional
  * formatting.
@@ -124,6 +249,77 @@ void kmnd_terminal_text(kmnd_terminal_t *terminal, const char *text,
 void kmnd_terminal_format(kmnd_terminal_t *terminal, const char *text,
                           const kmnd_terminal_options_t options);
 
+/**
+ * This function writes a layout (see layout.h) to the terminal. The line
+ * breaks are computed for the current width, column and indent unless the
+ * layout was already broken for them, so that a layout can be reused.
+ */
+void kmnd_terminal_layout(kmnd_terminal_t *terminal,
+                          struct kmnd_layout_s *layout,
+                          const kmnd_terminal_options_t options);
+
+/**
+ * This function makes the terminal break lines such that their lengths are as
+ * even as possible, rather than filling each line with as many words as
+ * possible.
+ */
+void kmnd_terminal_balance(kmnd_terminal_t *terminal,
+                           const unsigned char enabled);
+
+/**
+ * This callback receives the spans of text that kmnd_terminal_markup finds,
+ * together with the formatting options that apply to them. For placeholders,
+ * `text` is NULL and `placeholder` is the number between the braces. For all
+ * other spans, `placeholder` is -1.
+ */
+typedef void (kmnd_terminal_markup_cb)(void *context, const char *text,
+                                       const size_t length,
+                                       const kmnd_terminal_options_t options,
+                                       const int placeholder);
+
+/**
+ * This function parses the markup that is described at _format in a single
+ * pass and passes each span to the callback. The spans point into the given
+ * text. If `placeholders` is true, {0}, {1}, etc. are recognized as
+ * placeholders and {{ is written as a single brace.
+ */
+void kmnd_terminal_markup(const char *text, const size_t length,
+                          const unsigned char placeholders,
+                          kmnd_terminal_markup_cb *callback, void *context);
+
+/**
+ * This function writes all buffered output to the file descriptor of the
+ * terminal, after resetting the text style. It returns 0 on success and -1 if
+ * the output could not be written. Note that buffered output is also written
+ * automatically when the buffer is full.
+ */
+int kmnd_terminal_flush(kmnd_terminal_t *terminal);
+
+/**
+ * This function writes the given bytes to the terminal as-is. They are not
+ * line-wrapped, indented or styled.
+ */
+void kmnd_terminal_raw(kmnd_terminal_t *terminal, const char *data,
+                       const size_t length);
+
+/**
+ * This function returns the number of columns of the terminal.
+ */
+uint16_t kmnd_terminal_columns(kmnd_terminal_t *terminal);
+
+/**
+ * This function starts keeping a copy of all output that is written to the
+ * terminal from now on. Output that is still buffered is flushed first.
+ */
+void kmnd_terminal_capture_start(kmnd_terminal_t *terminal);
+
+/**
+ * This function flushes the terminal, stops capturing and returns the captured
+ * output. The caller is responsible for freeing it. NULL is returned if nothing
+ * was captured or the copy could not be allocated.
+ */
+char *kmnd_terminal_capture_end(kmnd_terminal_t *terminal, size_t *length);
+
 /**
  * This function sets the indent of the terminal. Use indent=NULL to turn off
  * all indentation (note that line-wrapping is still active though).
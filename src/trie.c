@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "command.h"
+#include "trie.h"
+
+typedef struct kmnd_trie_name_s {
+    const char *name;
+    size_t length;
+    kmnd_t *child;
+
+    /* This is the position of the child in order of precedence. */
+    size_t order;
+} kmnd_trie_name_t;
+
+static int kmnd_trie_compare(const void *a, const void *b) {
+    const kmnd_trie_name_t *x = a, *y = b;
+    const int res = strcmp(x->name, y->name);
+
+    if (res != 0)
+        return res;
+
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+/*
+ * This function fills the node at the given index with the given names, which
+ * are sorted and all share their first `depth` bytes, and then its children.
+ */
+static void kmnd_trie_fill(kmnd_trie_t *trie, const size_t index,
+                           const kmnd_trie_name_t *names,
+                           const size_t num_names, const size_t depth) {
+    kmnd_trie_node_t *node = &trie->nodes[index];
+
+    size_t i = 0;
+    if (num_names > 0 && names[0].length == depth) {
+        node->value = names[0].child;
+        i = 1;
+
+        if (node->value->type == KMND_TYPE_COMMAND) {
+            node->num_commands = 1;
+            node->command = node->value;
+        }
+    }
+
+    /* The children are reserved before any of them is filled, so that they
+     * are stored next to each other. */
+    size_t j;
+    for (j = i; j < num_names; j ++) {
+        if (j == i || names[j].name[depth] != names[j - 1].name[depth])
+            node->num_children ++;
+    }
+
+    node->first_child = (uint32_t) trie->num_nodes;
+    trie->num_nodes += node->num_children;
+
+    size_t child = node->first_child;
+
+    while (i < num_names) {
+        size_t end = i + 1;
+        while (end < num_names &&
+               names[end].name[depth] == names[i].name[depth])
+            end ++;
+
+        /* Since the names are sorted, the prefix that is shared by all names
+         * in this group is the prefix of its first and last name. */
+        size_t common = depth + 1;
+        while (names[i].name[common] != '\0' &&
+               names[i].name[common] == names[end - 1].name[common])
+            common ++;
+
+        kmnd_trie_node_t *next = &trie->nodes[child];
+        next->label = names[i].name + depth;
+        next->label_length = (uint32_t) (common - depth);
+
+        kmnd_trie_fill(trie, child, names + i, end - i, common);
+
+        node->num_commands += next->num_commands;
+
+        if (node->command == NULL)
+            node->command = next->command;
+
+        child ++;
+        i = end;
+    }
+}
+
+int kmnd_trie_build(kmnd_trie_t *trie, kmnd_command_t *command) {
+    const size_t num_children = command->num_commands + command->num_options +
+                                command->num_inputs;
+
+    kmnd_trie_name_t *names = malloc((num_children + 1) *
+                                     sizeof(kmnd_trie_name_t));
+
+    if (names == NULL)
+        return -1;
+
+    size_t i, num_names = 0;
+
+    for (i = 0; i < command->num_commands; i ++)
+        names[num_names ++].child = (kmnd_t *) command->commands[i];
+
+    for (i = 0; i < command->num_options; i ++)
+        names[num_names ++].child = (kmnd_t *) command->options[i];
+
+    for (i = 0; i < command->num_inputs; i ++)
+        names[num_names ++].child = (kmnd_t *) command->inputs[i];
+
+    for (i = 0; i < num_names; i ++) {
+        names[i].name = names[i].child->name;
+        names[i].length = strlen(names[i].name);
+        names[i].order = i;
+    }
+
+    qsort(names, num_names, sizeof(kmnd_trie_name_t), kmnd_trie_compare);
+
+    /* Only the first child with each name is kept. */
+    size_t num_unique = 0;
+    for (i = 0; i < num_names; i ++) {
+        if (num_unique > 0 &&
+            strcmp(names[num_unique - 1].name, names[i].name) == 0)
+            continue;
+
+        names[num_unique ++] = names[i];
+    }
+
+    /* Every node other than the root either ends a name or has at least two
+     * children, so there are at most two nodes per name. */
+    trie->nodes = kmnd_allocate(command->core.allocator,
+                                (2 * num_unique + 1) *
+                                sizeof(kmnd_trie_node_t));
+
+    if (trie->nodes == NULL) {
+        free(names);
+        return -1;
+    }
+
+    trie->allocator = command->core.allocator;
+    trie->num_nodes = 1;
+
+    kmnd_trie_fill(trie, 0, names, num_unique, 0);
+
+    free(names);
+
+    return 0;
+}
+
+void kmnd_trie_release(kmnd_trie_t *trie) {
+    if (trie->nodes != NULL)
+        kmnd_release(trie->allocator, trie->nodes);
+
+    trie->nodes = NULL;
+    trie->num_nodes = 0;
+}
+
+/*
+ * This function returns the child of the given node whose label starts with
+ * the given byte, or NULL if there is none.
+ */
+static const kmnd_trie_node_t *kmnd_trie_child(const kmnd_trie_t *trie,
+                                               const kmnd_trie_node_t *node,
+                                               const unsigned char c) {
+    size_t low = node->first_child,
+           high = node->first_child + node->num_children;
+
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        const unsigned char label =
+            (unsigned char) trie->nodes[middle].label[0];
+
+        if (label == c)
+            return &trie->nodes[middle];
+        else if (label < c)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return NULL;
+}
+
+/*
+ * This function returns the node at which the given name ends, or NULL if no
+ * name starts with it. `exact` is set if the name ends at the end of the label
+ * of that node rather than within it.
+ */
+static const kmnd_trie_node_t *kmnd_trie_walk(const kmnd_trie_t *trie,
+                                              const char *name,
+                                              const size_t length,
+                                              unsigned char *exact) {
+    const kmnd_trie_node_t *node = &trie->nodes[0];
+
+    size_t i = 0;
+    while (i < length) {
+        node = kmnd_trie_child(trie, node, (unsigned char) name[i]);
+
+        if (node == NULL)
+            return NULL;
+
+        size_t n = node->label_length;
+
+        if (n > length - i)
+            n = length - i;
+
+        if (memcmp(node->label, name + i, n) != 0)
+            return NULL;
+
+        i += n;
+
+        if (n < node->label_length) {
+            *exact = 0;
+            return node;
+        }
+    }
+
+    *exact = 1;
+    return node;
+}
+
+kmnd_t *kmnd_trie_find(const kmnd_trie_t *trie, const char *name,
+                       const size_t length) {
+    unsigned char exact;
+    const kmnd_trie_node_t *node = kmnd_trie_walk(trie, name, length, &exact);
+
+    if (node == NULL || !exact)
+        return NULL;
+
+    return node->value;
+}
+
+int kmnd_trie_find_command(const kmnd_trie_t *trie, const char *name,
+                           const unsigned char abbreviate, kmnd_t **command) {
+    unsigned char exact;
+    const kmnd_trie_node_t *node = kmnd_trie_walk(trie, name, strlen(name),
+                                                  &exact);
+
+    if (node == NULL)
+        return -1;
+
+    if (exact && node->value != NULL &&
+        node->value->type == KMND_TYPE_COMMAND) {
+        *command = node->value;
+        return 0;
+    }
+
+    if (!abbreviate || node->num_commands == 0)
+        return -1;
+
+    if (node->num_commands > 1)
+        return -2;
+
+    *command = node->command;
+    return 0;
+}
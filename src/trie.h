@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_trie_h
+#define __kmnd_trie_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct kmnd_trie_s kmnd_trie_t;
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core.h"
+
+struct kmnd_command_s;
+
+/*
+ * Each node of the trie holds a label (a substring of the names below it).
+ * The children of a node are stored next to each other and are sorted by the
+ * first byte of their labels.
+ */
+typedef struct kmnd_trie_node_s {
+    const char *label;
+    uint32_t label_length;
+
+    uint32_t first_child;
+    uint32_t num_children;
+
+    /* This is the number of subcommands below (and including) this node. */
+    uint32_t num_commands;
+
+    /* This is the child whose name ends at this node (or NULL). */
+    kmnd_t *value;
+
+    /* This is one of the subcommands below this node (or NULL). */
+    kmnd_t *command;
+} kmnd_trie_node_t;
+
+/*
+ * A trie maps the names of the subcommands, options and inputs of a command to
+ * the children themselves. It is a radix trie, so looking up a name takes time
+ * proportional to its length rather than to the number of children. The first
+ * node is the root.
+ */
+struct kmnd_trie_s {
+    kmnd_trie_node_t *nodes;
+    size_t num_nodes;
+
+    /* This is the allocator of the command that the trie belongs to. */
+    const kmnd_allocator_t *allocator;
+};
+
+/**
+ * This function builds the trie of the children of the given command. When
+ * children share a name, subcommands take precedence over options and options
+ * over inputs. It returns -1 if memory could not be allocated.
+ */
+int kmnd_trie_build(kmnd_trie_t *trie, struct kmnd_command_s *command);
+
+/**
+ * This function frees the memory allocated by the trie (but not the trie
+ * itself).
+ */
+void kmnd_trie_release(kmnd_trie_t *trie);
+
+/**
+ * This function returns the child with exactly the given name (of `length`
+ * bytes), or NULL if there is none.
+ */
+kmnd_t *kmnd_trie_find(const kmnd_trie_t *trie, const char *name,
+                       const size_t length);
+
+/**
+ * This function looks up the subcommand with the given name. If `abbreviate`
+ * is set, a prefix of the name of exactly one subcommand also selects it. It
+ * returns 0 and stores the subcommand in `command` if one was found, -1 if
+ * there is none and -2 if the prefix is ambiguous.
+ */
+int kmnd_trie_find_command(const kmnd_trie_t *trie, const char *name,
+                           const unsigned char abbreviate, kmnd_t **command);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_trie_h */
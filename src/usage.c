@@ -24,19 +24,22 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "allocator.h"
+#include "cache.h"
 #include "command.h"
 #include "option.h"
 #include "terminal.h"
 #include "usage.h"
+#include "width.h"
 
 kmnd_t *kmnd_usage_new(const char *command, const char *description) {
-    kmnd_usage_t *usage = malloc(sizeof(kmnd_usage_t));
+    const kmnd_allocator_t *allocator = kmnd_allocator_current();
+    kmnd_usage_t *usage = kmnd_allocate(allocator, sizeof(kmnd_usage_t));
 
     if (usage == NULL)
         return NULL;
 
-    memset(usage, 0, sizeof(kmnd_usage_t));
-
+    usage->core.allocator = allocator;
     usage->core.type = KMND_TYPE_USAGE;
     usage->command = command;
     usage->description = description;
@@ -45,40 +48,151 @@ kmnd_t *kmnd_usage_new(const char *command, const char *description) {
 }
 
 void kmnd_usage_free(kmnd_usage_t *usage) {
+    size_t i;
+    for (i = 0; i < usage->num_layouts; i ++) {
+        if (usage->layouts[i] == NULL)
+            continue;
+
+        kmnd_layout_release(usage->layouts[i]);
+        free(usage->layouts[i]);
+    }
+
+    free(usage->layouts);
+
+    const kmnd_allocator_t *allocator = usage->core.allocator;
+
     memset(usage, 0, sizeof(kmnd_usage_t));
-    free(usage);
+    kmnd_release(allocator, usage);
 }
 
 #define KMND_USAGE(x) ((kmnd_usage_t *) x)
 
-void kmnd_usage_print(kmnd_usage_t *usage, kmnd_command_t *command) {
-    kmnd_terminal_text(command->terminal, "Usage:\n",
+/*
+ * This function returns the number of columns that the given name occupies,
+ * which is less than its length if it contains multi-byte characters.
+ */
+static size_t kmnd_usage_width(const char *name) {
+    return kmnd_width(name, strlen(name));
+}
+
+/*
+ * This function returns whether the usage text of the given command uses
+ * balanced line breaks, which is inherited from its ancestors.
+ */
+static unsigned char kmnd_usage_balanced(kmnd_command_t *command) {
+    while (command != NULL) {
+        if (command->balance_usage)
+            return 1;
+
+        command = (kmnd_command_t *) command->super;
+    }
+
+    return 0;
+}
+
+/*
+ * This function writes the given markup text with the layout at the given
+ * index, which is only computed again if the text or the width of the
+ * terminal has changed since the usage text was last written. If `usage` is
+ * NULL, the layout of the terminal is used instead.
+ */
+static void kmnd_usage_format(kmnd_usage_t *usage, kmnd_terminal_t *terminal,
+                              const size_t index, const char *text,
+                              const kmnd_terminal_options_t options) {
+    if (usage == NULL) {
+        kmnd_terminal_format(terminal, text, options);
+        return;
+    }
+
+    if (index >= usage->num_layouts) {
+        const size_t num_layouts = index + 8;
+        kmnd_layout_t **layouts = malloc(num_layouts * sizeof(kmnd_layout_t *));
+
+        if (layouts == NULL) {
+            kmnd_terminal_format(terminal, text, options);
+            return;
+        }
+
+        memset(layouts, 0, num_layouts * sizeof(kmnd_layout_t *));
+
+        if (usage->num_layouts > 0)
+            memcpy(layouts, usage->layouts,
+                   usage->num_layouts * sizeof(kmnd_layout_t *));
+
+        free(usage->layouts);
+
+        usage->layouts = layouts;
+        usage->num_layouts = num_layouts;
+    }
+
+    kmnd_layout_t *layout = usage->layouts[index];
+
+    if (layout != NULL && layout->source != text) {
+        kmnd_layout_release(layout);
+        free(layout);
+
+        layout = usage->layouts[index] = NULL;
+    }
+
+    if (layout == NULL) {
+        layout = malloc(sizeof(kmnd_layout_t));
+
+        if (layout == NULL ||
+            kmnd_layout_init(layout, text, strlen(text), 1) != 0) {
+            free(layout);
+
+            kmnd_terminal_format(terminal, text, options);
+            return;
+        }
+
+        usage->layouts[index] = layout;
+    }
+
+    kmnd_terminal_layout(terminal, layout, options);
+}
+
+static void kmnd_usage_render(kmnd_usage_t *usage, kmnd_command_t *command,
+                              kmnd_terminal_t *terminal) {
+    /* This is the index of the next layout. */
+    size_t layout = 0;
+
+    /* A frozen tree may be shared by several threads, so its layouts are not
+     * kept (and written) by the usage section but by each terminal. */
+    kmnd_usage_t *layouts = kmnd_command_root(command)->frozen ? NULL : usage;
+
+    const unsigned char balanced = terminal->balanced;
+    kmnd_terminal_balance(terminal, kmnd_usage_balanced(command));
+
+    kmnd_terminal_text(terminal, "Usage:\n",
                        KMND_TERMINAL_STYLE_UNDERLINE);
 
-    kmnd_terminal_text(command->terminal, "    $ ",
+    kmnd_terminal_text(terminal, "    $ ",
                        KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-    kmnd_terminal_indent(command->terminal, "    $ ",
+    kmnd_terminal_indent(terminal, "    $ ",
                          KMND_TERMINAL_OPTIONS_NONE);
-    kmnd_terminal_format(command->terminal, KMND_USAGE(usage)->command,
-                         KMND_TERMINAL_FOREGROUND_GREEN);
-    kmnd_terminal_indent(command->terminal, NULL,
+    kmnd_usage_format(layouts, terminal, layout ++,
+                      KMND_USAGE(usage)->command,
+                      KMND_TERMINAL_FOREGROUND_GREEN);
+    kmnd_terminal_indent(terminal, NULL,
                          KMND_TERMINAL_OPTIONS_NONE);
 
-    kmnd_terminal_text(command->terminal, "\n      ",
+    kmnd_terminal_text(terminal, "\n      ",
                        KMND_TERMINAL_OPTIONS_NO_NEWLINE);
 
-    kmnd_terminal_indent(command->terminal, "      ",
-                         KMND_TERMINAL_OPTIONS_NONE);
-    kmnd_terminal_format(command->terminal, KMND_USAGE(usage)->description,
+    kmnd_terminal_indent(terminal, "      ",
                          KMND_TERMINAL_OPTIONS_NONE);
-    kmnd_terminal_indent(command->terminal, NULL,
+    kmnd_usage_format(layouts, terminal, layout ++,
+                      KMND_USAGE(usage)->description,
+                      KMND_TERMINAL_OPTIONS_NONE);
+    kmnd_terminal_indent(terminal, NULL,
                          KMND_TERMINAL_OPTIONS_NONE);
 
     size_t indent_length = strlen("    -h/--help  ");
 
     size_t i;
     for (i = 0; i < command->num_commands; i ++) {
-        const size_t current = 6 + strlen(command->commands[i]->core.name) + 2;
+        const kmnd_command_t *subcommand = command->commands[i];
+        const size_t current = 6 + kmnd_usage_width(subcommand->core.name) + 2;
 
         if (current > indent_length)
             indent_length = current;
@@ -87,7 +201,7 @@ void kmnd_usage_print(kmnd_usage_t *usage, kmnd_command_t *command) {
     for (i = 0; i < command->num_options; i ++) {
         kmnd_option_t *option = command->options[i];
 
-        size_t current = 6 + strlen(option->core.name) + 2;
+        size_t current = 6 + kmnd_usage_width(option->core.name) + 2;
 
         if (option->character != 0)
             current += 3;
@@ -102,81 +216,81 @@ void kmnd_usage_print(kmnd_usage_t *usage, kmnd_command_t *command) {
         indent[i] = ' ';
 
     if (command->num_commands > 0) {
-        kmnd_terminal_text(command->terminal, "\nCommands:\n",
+        kmnd_terminal_text(terminal, "\nCommands:\n",
                            KMND_TERMINAL_STYLE_UNDERLINE);
 
-        kmnd_terminal_indent(command->terminal, indent,
+        kmnd_terminal_indent(terminal, indent,
                              KMND_TERMINAL_OPTIONS_NONE);
 
         size_t j, k;
         for (j = 0; j < command->num_commands; j ++) {
             kmnd_command_t *subcommand = command->commands[j];
 
-            kmnd_terminal_text(command->terminal, "    + ",
+            kmnd_terminal_text(terminal, "    + ",
                                KMND_TERMINAL_FOREGROUND_GREEN |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-            kmnd_terminal_text(command->terminal, subcommand->core.name,
+            kmnd_terminal_text(terminal, subcommand->core.name,
                                KMND_TERMINAL_FOREGROUND_GREEN |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
 
-            const size_t padding_length = indent_length - 6 -
-                                          strlen(subcommand->core.name);
+            const size_t padding_length =
+                indent_length - 6 - kmnd_usage_width(subcommand->core.name);
             char padding[padding_length + 1];
             for (k = 0; k < padding_length; k ++)
                 padding[k] = ' ';
             padding[k] = '\0';
 
-            kmnd_terminal_text(command->terminal, padding,
+            kmnd_terminal_text(terminal, padding,
                                  KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-            kmnd_terminal_format(command->terminal,
-                                 subcommand->core.description,
-                                 KMND_TERMINAL_OPTIONS_NONE);
+            kmnd_usage_format(layouts, terminal, layout ++,
+                              subcommand->core.description,
+                              KMND_TERMINAL_OPTIONS_NONE);
         }
 
-        kmnd_terminal_indent(command->terminal, NULL,
+        kmnd_terminal_indent(terminal, NULL,
                              KMND_TERMINAL_OPTIONS_NONE);
     }
 
     if (command->num_inputs > 0) {
-        kmnd_terminal_text(command->terminal, "\nInput:\n",
+        kmnd_terminal_text(terminal, "\nInput:\n",
                            KMND_TERMINAL_STYLE_UNDERLINE);
 
-        kmnd_terminal_indent(command->terminal, indent,
+        kmnd_terminal_indent(terminal, indent,
                              KMND_TERMINAL_OPTIONS_NONE);
 
         size_t j, k;
         for (j = 0; j < command->num_inputs; j ++) {
             kmnd_input_t *input = command->inputs[j];
 
-            kmnd_terminal_text(command->terminal, "      ",
+            kmnd_terminal_text(terminal, "      ",
                                KMND_TERMINAL_FOREGROUND_GREEN |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-            kmnd_terminal_text(command->terminal, input->core.name,
+            kmnd_terminal_text(terminal, input->core.name,
                                KMND_TERMINAL_FOREGROUND_GREEN |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
 
             const size_t padding_length = indent_length - 6 -
-                                          strlen(input->core.name);
+                                          kmnd_usage_width(input->core.name);
             char padding[padding_length + 1];
             for (k = 0; k < padding_length; k ++)
                 padding[k] = ' ';
             padding[k] = '\0';
 
-            kmnd_terminal_text(command->terminal, padding,
+            kmnd_terminal_text(terminal, padding,
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-            kmnd_terminal_format(command->terminal,
-                                 input->core.description,
-                                 KMND_TERMINAL_OPTIONS_NONE);
+            kmnd_usage_format(layouts, terminal, layout ++,
+                              input->core.description,
+                              KMND_TERMINAL_OPTIONS_NONE);
         }
 
-        kmnd_terminal_indent(command->terminal, NULL,
+        kmnd_terminal_indent(terminal, NULL,
                              KMND_TERMINAL_OPTIONS_NONE);
     }
 
-    kmnd_terminal_text(command->terminal, "\nOptions:\n",
+    kmnd_terminal_text(terminal, "\nOptions:\n",
                        KMND_TERMINAL_STYLE_UNDERLINE);
 
-    kmnd_terminal_indent(command->terminal, indent,
+    kmnd_terminal_indent(terminal, indent,
                          KMND_TERMINAL_OPTIONS_NONE);
 
     size_t j, k;
@@ -184,31 +298,31 @@ void kmnd_usage_print(kmnd_usage_t *usage, kmnd_command_t *command) {
         kmnd_option_t *option = (kmnd_option_t *) command->options[j];
 
         if (option->character) {
-            kmnd_terminal_text(command->terminal, "    -",
+            kmnd_terminal_text(terminal, "    -",
                                KMND_TERMINAL_FOREGROUND_BLUE |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
             char key[2] = { option->character, 0 };
-            kmnd_terminal_text(command->terminal, key,
+            kmnd_terminal_text(terminal, key,
                                KMND_TERMINAL_FOREGROUND_BLUE |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-            kmnd_terminal_text(command->terminal, "/--",
+            kmnd_terminal_text(terminal, "/--",
                                KMND_TERMINAL_FOREGROUND_BLUE |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
 
-            kmnd_terminal_text(command->terminal, option->core.name,
+            kmnd_terminal_text(terminal, option->core.name,
                                KMND_TERMINAL_FOREGROUND_BLUE |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
         }else {
-            kmnd_terminal_text(command->terminal, "    --",
+            kmnd_terminal_text(terminal, "    --",
                                KMND_TERMINAL_FOREGROUND_BLUE |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-            kmnd_terminal_text(command->terminal, option->core.name,
+            kmnd_terminal_text(terminal, option->core.name,
                                KMND_TERMINAL_FOREGROUND_BLUE |
                                KMND_TERMINAL_OPTIONS_NO_NEWLINE);
         }
 
         size_t padding_length = indent_length - 6 -
-                                strlen(option->core.name);
+                                kmnd_usage_width(option->core.name);
 
         if (option->character != 0)
             padding_length -= 3;
@@ -218,11 +332,11 @@ void kmnd_usage_print(kmnd_usage_t *usage, kmnd_command_t *command) {
             padding[k] = ' ';
         padding[k] = '\0';
 
-        kmnd_terminal_text(command->terminal, padding,
+        kmnd_terminal_text(terminal, padding,
                            KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-        kmnd_terminal_format(command->terminal,
-                             option->core.description,
-                             KMND_TERMINAL_OPTIONS_NONE);
+        kmnd_usage_format(layouts, terminal, layout ++,
+                          option->core.description,
+                          KMND_TERMINAL_OPTIONS_NONE);
     }
 
     size_t padding_length = indent_length - 6 - 4 - 2 - 3;
@@ -232,14 +346,90 @@ void kmnd_usage_print(kmnd_usage_t *usage, kmnd_command_t *command) {
         padding[k] = ' ';
     padding[k] = '\0';
 
-    kmnd_terminal_text(command->terminal, "    -h/--help  ",
+    kmnd_terminal_text(terminal, "    -h/--help  ",
                        KMND_TERMINAL_FOREGROUND_BLUE |
                        KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-    kmnd_terminal_text(command->terminal, padding,
+    kmnd_terminal_text(terminal, padding,
                        KMND_TERMINAL_OPTIONS_NO_NEWLINE);
-    kmnd_terminal_text(command->terminal, "Show help banner of specified "
+    kmnd_terminal_text(terminal, "Show help banner of specified "
                        "command", KMND_TERMINAL_OPTIONS_NONE);
 
-    kmnd_terminal_indent(command->terminal, NULL,
+    kmnd_terminal_indent(terminal, NULL,
                          KMND_TERMINAL_OPTIONS_NONE);
+
+    kmnd_terminal_balance(terminal, balanced);
+}
+
+void kmnd_usage_cache(kmnd_t *kmnd, const unsigned char enabled) {
+    ((kmnd_command_t *) kmnd)->cache_usage = enabled;
+}
+
+void kmnd_usage_balance(kmnd_t *kmnd, const unsigned char enabled) {
+    ((kmnd_command_t *) kmnd)->balance_usage = enabled;
+}
+
+/*
+ * This function computes the cache key of the usage text of the given command.
+ * It returns -1 if caching is not enabled for this command.
+ */
+static int kmnd_usage_cache_key(kmnd_command_t *command,
+                                kmnd_terminal_t *terminal,
+                                kmnd_cache_key_t *key) {
+    unsigned char enabled = 0;
+
+    /* The key covers the names of all commands from this one up to the root,
+     * which identify the command within the binary. */
+    key->hash = kmnd_cache_hash_init();
+
+    kmnd_command_t *iterator = command;
+
+    while (iterator != NULL) {
+        enabled |= iterator->cache_usage;
+
+        key->hash = kmnd_cache_hash(key->hash, iterator->core.name ?
+                                               iterator->core.name : "");
+
+        iterator = (kmnd_command_t *) iterator->super;
+    }
+
+    if (kmnd_usage_balanced(command))
+        key->hash = kmnd_cache_hash(key->hash, "balanced");
+
+    key->num_columns = kmnd_terminal_columns(terminal);
+    key->formatting = kmnd_terminal_supports_formatting(terminal);
+
+    /* The cached text always starts at the beginning of a line. */
+    if (!enabled || terminal->line_chars != 0)
+        return -1;
+
+    return 0;
+}
+
+void kmnd_usage_print(kmnd_usage_t *usage, kmnd_command_t *command) {
+    kmnd_terminal_t *terminal = kmnd_command_terminal(command);
+
+    kmnd_cache_key_t key;
+    char path[4096];
+
+    if (kmnd_usage_cache_key(command, terminal, &key) != 0 ||
+        kmnd_cache_path(&key, path, sizeof(path)) != 0) {
+        kmnd_usage_render(usage, command, terminal);
+        kmnd_terminal_flush(terminal);
+        return;
+    }
+
+    if (kmnd_cache_load(path, &key, terminal) == 0)
+        return;
+
+    kmnd_terminal_capture_start(terminal);
+
+    kmnd_usage_render(usage, command, terminal);
+
+    size_t length;
+    char *capture = kmnd_terminal_capture_end(terminal, &length);
+
+    if (capture != NULL)
+        kmnd_cache_store(path, &key, capture, length);
+
+    free(capture);
 }
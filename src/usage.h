@@ -33,12 +33,20 @@ typedef struct kmnd_usage_s kmnd_usage_t;
 
 #include "command.h"
 #include "core.h"
+#include "layout.h"
 
 struct kmnd_usage_s {
     kmnd_t core;
 
     const char *command;
     const char *description;
+
+    /* These are the layouts of the descriptions in the usage text, in the
+     * order in which they are written. They are reused as long as the width
+     * of the terminal does not change. They are not used for frozen trees,
+     * whose usage text may be written by several threads at once. */
+    kmnd_layout_t **layouts;
+    size_t num_layouts;
 };
 
 void kmnd_usage_free(kmnd_usage_t *usage);
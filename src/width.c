@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "scan.h"
+#include "width.h"
+
+typedef struct kmnd_width_range_s {
+    uint32_t start;
+    uint32_t end;
+} kmnd_width_range_t;
+
+#include "width_table.h"
+
+#define KMND_WIDTH_COUNT(table) (sizeof(table) / sizeof(table[0]))
+
+/*
+ * This is the code point that invalid UTF-8 is decoded to. It is only used to
+ * determine the width, the bytes themselves are written as-is.
+ */
+#define KMND_WIDTH_INVALID 0xFFFD
+
+static int kmnd_width_contains(const kmnd_width_range_t *table,
+                               const size_t count, const uint32_t code_point) {
+    if (code_point < table[0].start || code_point > table[count - 1].end)
+        return 0;
+
+    size_t low = 0;
+    size_t high = count;
+
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+
+        if (code_point > table[middle].end)
+            low = middle + 1;
+        else if (code_point < table[middle].start)
+            high = middle;
+        else
+            return 1;
+    }
+
+    return 0;
+}
+
+int kmnd_width_code_point(const uint32_t code_point) {
+    if (code_point < 0x20)
+        return 0;
+
+    if (code_point < 0x300)
+        return (code_point >= 0x7F && code_point < 0xA0) ? 0 : 1;
+
+    if (kmnd_width_contains(kmnd_width_zero, KMND_WIDTH_COUNT(kmnd_width_zero),
+                            code_point))
+        return 0;
+
+    if (kmnd_width_contains(kmnd_width_wide, KMND_WIDTH_COUNT(kmnd_width_wide),
+                            code_point))
+        return 2;
+
+    return 1;
+}
+
+/*
+ * This function decodes the character at the start of the given text and
+ * returns the number of bytes it occupies (at least one). Escape sequences
+ * are decoded as a single character without width.
+ */
+static size_t kmnd_width_next(const unsigned char *text, const size_t length,
+                              int *width) {
+    const unsigned char c = text[0];
+
+    if (c == 0x1B) {
+        *width = 0;
+
+        /* Control Sequence Introducer, e.g. \x1B[1;31m: parameter and
+         * intermediate bytes are followed by a final byte. */
+        if (length > 1 && text[1] == '[') {
+            size_t i = 2;
+
+            while (i < length && (text[i] < 0x40 || text[i] > 0x7E))
+                i ++;
+
+            return (i < length) ? i + 1 : length;
+        }
+
+        /* Other escape sequences consist of one more byte. */
+        return (length > 1) ? 2 : 1;
+    }
+
+    if (c < 0x80) {
+        *width = kmnd_width_code_point(c);
+        return 1;
+    }
+
+    size_t count;
+    uint32_t code_point;
+
+    if (c >= 0xC2 && c <= 0xDF) {
+        count = 2;
+        code_point = c & 0x1F;
+    }else if (c >= 0xE0 && c <= 0xEF) {
+        count = 3;
+        code_point = c & 0x0F;
+    }else if (c >= 0xF0 && c <= 0xF4) {
+        count = 4;
+        code_point = c & 0x07;
+    }else {
+        *width = 1;
+        return 1;
+    }
+
+    if (count > length) {
+        *width = 1;
+        return 1;
+    }
+
+    size_t i;
+    for (i = 1; i < count; i ++) {
+        if ((text[i] & 0xC0) != 0x80) {
+            *width = 1;
+            return 1;
+        }
+
+        code_point = (code_point << 6) | (text[i] & 0x3F);
+    }
+
+    /* Reject overlong encodings, surrogates and code points beyond the
+     * Unicode range. */
+    if ((count == 3 && code_point < 0x800) ||
+        (count == 4 && (code_point < 0x10000 || code_point > 0x10FFFF)) ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF))
+        code_point = KMND_WIDTH_INVALID;
+
+    *width = kmnd_width_code_point(code_point);
+
+    return count;
+}
+
+size_t kmnd_width(const char *text, const size_t length) {
+    size_t width;
+    kmnd_width_fit(text, length, (size_t) -1, &width);
+
+    return width;
+}
+
+size_t kmnd_width_fit(const char *text, const size_t length,
+                      const size_t max_width, size_t *width) {
+    const unsigned char *bytes = (const unsigned char *) text;
+
+    size_t i = 0;
+    size_t total = 0;
+
+    while (i < length) {
+        /* Printable ASCII takes one column per byte, so most text is handled
+         * here without decoding. */
+        size_t run = kmnd_scan_ascii(text + i, length - i);
+
+        if (run > max_width - total)
+            run = max_width - total;
+
+        i += run;
+        total += run;
+
+        if (i == length)
+            break;
+
+        int next_width;
+        const size_t next = kmnd_width_next(bytes + i, length - i,
+                                            &next_width);
+
+        if (total + (size_t) next_width > max_width)
+            break;
+
+        i += next;
+        total += (size_t) next_width;
+    }
+
+    *width = total;
+
+    return i;
+}
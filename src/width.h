@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __kmnd_width_h
+#define __kmnd_width_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * This function returns the number of columns that the given code point
+ * occupies in a terminal: 0 for combining marks and format characters, 2 for
+ * wide (e.g. CJK) characters and 1 for everything else.
+ */
+int kmnd_width_code_point(const uint32_t code_point);
+
+/**
+ * This function returns the number of columns that the given UTF-8 text
+ * occupies in a terminal. Escape sequences take no space. Invalid UTF-8 is
+ * counted as one column per byte.
+ */
+size_t kmnd_width(const char *text, const size_t length);
+
+/**
+ * This function returns the number of bytes of the given UTF-8 text that fit
+ * in `max_width` columns, without splitting a character (or separating it
+ * from the combining marks that follow it). The number of columns that these
+ * bytes occupy is stored in `width`.
+ */
+size_t kmnd_width_fit(const char *text, const size_t length,
+                      const size_t max_width, size_t *width);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __kmnd_width_h */
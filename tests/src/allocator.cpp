@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/allocator.h"
+#include "../../src/command.h"
+
+#include "malloc.h"
+
+typedef struct kmnd_test_counter_s {
+    size_t num_allocations;
+    size_t num_releases;
+} kmnd_test_counter_t;
+
+static void *kmnd_test_allocate(void *context, const size_t size) {
+    ((kmnd_test_counter_t *) context)->num_allocations ++;
+
+    return malloc(size);
+}
+
+static void kmnd_test_release(void *context, void *pointer) {
+    ((kmnd_test_counter_t *) context)->num_releases ++;
+
+    free(pointer);
+}
+
+static int kmnd_test_allocator_run(kmnd_t *kmnd) {
+    return 0;
+}
+
+/*
+ * This function builds a tree with every kind of node and runs it once.
+ */
+static kmnd_t *kmnd_test_tree(void) {
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0),
+           *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *file = kmnd_input_new("file", "This is file.", KMND_FLAGS_NONE,
+                                  NULL),
+           *sub = kmnd_new("sub", "This is sub.", kmnd_test_allocator_run,
+                           kmnd_usage_new("foobar sub", "This is sub."), name,
+                           file, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL,
+                            kmnd_usage_new("foobar", "This is foobar."),
+                            verbose, sub, NULL);
+
+    const char *args[5] = { "kmnd", "sub", "-v", "--name=def", "x.txt" };
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 5, args));
+    EXPECT_STREQ("def", kmnd_string_get(kmnd, "sub.name"));
+    EXPECT_STREQ("x.txt", kmnd_input_get(kmnd, "sub.file"));
+
+    return kmnd;
+}
+
+/*
+ * Everything that is allocated for a tree should be allocated with the
+ * allocator in use and released when the tree is freed, including inputs and
+ * usage sections.
+ */
+TEST(AllocatorFixture, Use) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_test_counter_t counter = { 0, 0 };
+    const kmnd_allocator_t allocator = {
+        kmnd_test_allocate, kmnd_test_release, &counter
+    };
+
+    const kmnd_allocator_t *previous = kmnd_allocator_current();
+
+    EXPECT_EQ(previous, kmnd_allocator_use(&allocator));
+
+    kmnd_t *kmnd = kmnd_test_tree();
+
+    kmnd_allocator_use(NULL);
+
+    EXPECT_TRUE(kmnd->allocator == &allocator);
+    EXPECT_LT(10u, counter.num_allocations);
+
+    kmnd_free(kmnd);
+
+    EXPECT_EQ(counter.num_allocations, counter.num_releases);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * A tree that is allocated from an arena should be released at once.
+ */
+TEST(AllocatorFixture, Arena) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_arena_t *arena = kmnd_arena_new(256);
+
+    kmnd_allocator_use(kmnd_arena_allocator(arena));
+
+    kmnd_t *kmnd = kmnd_test_tree();
+
+    kmnd_allocator_use(NULL);
+
+    /* Allocations that are larger than a block get a block of their own. */
+    const kmnd_allocator_t *allocator = kmnd_arena_allocator(arena);
+    char *large = (char *) kmnd_allocate(allocator, 1000);
+    char *small = (char *) kmnd_allocate(allocator, 3);
+
+    ASSERT_TRUE(large != NULL && small != NULL);
+    EXPECT_EQ(0, (uintptr_t) small % 16);
+
+    memset(large, 1, 1000);
+    memset(small, 2, 3);
+
+    kmnd_free(kmnd);
+    kmnd_arena_free(arena);
+
+    KMND_MEM_LEAK_POST();
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+#include "../../src/command.h"
+
+#include "malloc.h"
+
+/*
+ * This function writes the given text to a new temporary file and returns its
+ * path.
+ */
+static std::string kmnd_test_args_file(const std::string &text) {
+    char path[] = "/tmp/kmnd_args_XXXXXX";
+    int fd = mkstemp(path);
+
+    EXPECT_NE(-1, fd);
+    EXPECT_EQ((ssize_t) text.size(), write(fd, text.data(), text.size()));
+    close(fd);
+
+    return path;
+}
+
+static kmnd_t *kmnd_test_args_tree(void) {
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0),
+           *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *count = kmnd_int32_new('c', "count", "This is count.",
+                                   KMND_FLAGS_NONE, 0),
+           *first = kmnd_input_new("first", "This is first.", KMND_FLAGS_NONE,
+                                   NULL),
+           *second = kmnd_input_new("second", "This is second.",
+                                    KMND_FLAGS_NONE, NULL),
+           *sub = kmnd_new("sub", "This is sub.", NULL, name, count, first,
+                           second, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, verbose, sub,
+                            NULL);
+
+    kmnd_memory(kmnd);
+    kmnd_response_files(kmnd, 1);
+
+    return kmnd;
+}
+
+/*
+ * Arguments in response files should be split like lines and take the place of
+ * the `@path` argument, also when files refer to other files.
+ */
+TEST(ArgsFixture, Expand) {
+    KMND_MEM_LEAK_PRE();
+
+    /* The strings must be freed before the memory is checked. */
+    {
+        std::string inner = kmnd_test_args_file("--count=7 \\\n 'x y.txt'");
+        std::string outer = kmnd_test_args_file("# This is a comment.\n"
+                                                "sub -v --name=\"d e\" @" +
+                                                inner + "\n");
+
+        std::string at_outer = "@" + outer;
+
+        kmnd_t *kmnd = kmnd_test_args_tree();
+
+        const char *args[3] = { "kmnd", at_outer.c_str(), "z.txt" };
+
+        EXPECT_EQ(0, kmnd_run(kmnd, 3, args));
+        EXPECT_EQ(1, kmnd_boolean_get(kmnd, "verbose"));
+        EXPECT_STREQ("d e", kmnd_string_get(kmnd, "sub.name"));
+        EXPECT_EQ(7, kmnd_int32_get(kmnd, "sub.count"));
+        EXPECT_STREQ("x y.txt", kmnd_input_get(kmnd, "sub.first"));
+        EXPECT_STREQ("z.txt", kmnd_input_get(kmnd, "sub.second"));
+
+        kmnd_free(kmnd);
+
+        unlink(inner.c_str());
+        unlink(outer.c_str());
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * `@path` arguments should be passed on as they are if response files are not
+ * enabled or cannot be read.
+ */
+TEST(ArgsFixture, Literal) {
+    KMND_MEM_LEAK_PRE();
+
+    {
+        std::string path = kmnd_test_args_file("abc");
+        std::string at_path = "@" + path;
+
+        kmnd_t *kmnd = kmnd_test_args_tree();
+        kmnd_response_files(kmnd, 0);
+
+        const char *args[4] = { "kmnd", "sub", at_path.c_str(),
+                                "@/does/not/exist" };
+
+        EXPECT_EQ(0, kmnd_run(kmnd, 4, args));
+        EXPECT_STREQ(at_path.c_str(), kmnd_input_get(kmnd, "sub.first"));
+        EXPECT_STREQ("@/does/not/exist", kmnd_input_get(kmnd, "sub.second"));
+
+        kmnd_free(kmnd);
+
+        /* Subcommands inherit the setting. */
+        kmnd = kmnd_test_args_tree();
+
+        EXPECT_EQ(0, kmnd_run(kmnd, 4, args));
+        EXPECT_STREQ("abc", kmnd_input_get(kmnd, "sub.first"));
+        EXPECT_STREQ("@/does/not/exist", kmnd_input_get(kmnd, "sub.second"));
+
+        kmnd_free(kmnd);
+
+        unlink(path.c_str());
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+TEST(ArgsFixture, Errors) {
+    KMND_MEM_LEAK_PRE();
+
+    {
+        /* A file that refers to itself is nested too deeply. */
+        char path[] = "/tmp/kmnd_args_XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_NE(-1, fd);
+
+        std::string text = std::string("@") + path;
+        ASSERT_EQ((ssize_t) text.size(), write(fd, text.data(), text.size()));
+        close(fd);
+
+        std::string at_path = std::string("@") + path;
+
+        kmnd_t *kmnd = kmnd_test_args_tree();
+
+        size_t length;
+        const char *args[2] = { "kmnd", at_path.c_str() };
+
+        EXPECT_EQ(-1, kmnd_run(kmnd, 2, args));
+        EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                           "Response files are nested too deeply") != NULL);
+        kmnd_output_clear(kmnd);
+
+        std::string quote = kmnd_test_args_file("sub 'abc");
+        std::string at_quote = "@" + quote;
+
+        const char *unterminated[2] = { "kmnd", at_quote.c_str() };
+
+        EXPECT_EQ(-1, kmnd_run(kmnd, 2, unterminated));
+        EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                           "Unterminated quote") != NULL);
+
+        kmnd_free(kmnd);
+
+        unlink(path);
+        unlink(quote.c_str());
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Borrowed values should point into the response file, which remains mapped
+ * until the tree is reset or freed.
+ */
+TEST(ArgsFixture, Borrow) {
+    KMND_MEM_LEAK_PRE();
+
+    {
+        /* The last argument ends exactly at the end of a page. */
+        const long page = sysconf(_SC_PAGESIZE);
+        std::string text = "sub " + std::string(page - 4, 'a');
+
+        std::string path = kmnd_test_args_file(text);
+        std::string at_path = "@" + path;
+
+        kmnd_t *kmnd = kmnd_test_args_tree();
+        kmnd_borrow(kmnd, 1);
+
+        const char *args[2] = { "kmnd", at_path.c_str() };
+
+        EXPECT_EQ(0, kmnd_run(kmnd, 2, args));
+        EXPECT_EQ(text.substr(4), kmnd_input_get(kmnd, "sub.first"));
+        EXPECT_TRUE(((kmnd_command_t *) kmnd)->mappings != NULL);
+
+        unlink(path.c_str());
+
+        EXPECT_EQ(text.substr(4), kmnd_input_get(kmnd, "sub.first"));
+
+        kmnd_free(kmnd);
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Large response files should be read as their arguments are needed.
+ */
+TEST(ArgsFixture, Stream) {
+    KMND_MEM_LEAK_PRE();
+
+    {
+        std::string text = "sub";
+
+        int i;
+        for (i = 0; i < 200000; i ++)
+            text += " --count=" + std::to_string(i);
+
+        std::string path = kmnd_test_args_file(text + "\n");
+        std::string at_path = "@" + path;
+
+        kmnd_t *kmnd = kmnd_test_args_tree();
+
+        const char *args[3] = { "kmnd", at_path.c_str(), "x" };
+
+        EXPECT_EQ(0, kmnd_run(kmnd, 3, args));
+        EXPECT_EQ(199999, kmnd_int32_get(kmnd, "sub.count"));
+        EXPECT_STREQ("x", kmnd_input_get(kmnd, "sub.first"));
+        EXPECT_TRUE(((kmnd_command_t *) kmnd)->mappings == NULL);
+
+        kmnd_free(kmnd);
+
+        unlink(path.c_str());
+    }
+
+    KMND_MEM_LEAK_POST();
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+#include "../../src/command.h"
+
+#include "malloc.h"
+
+static kmnd_template_t *kmnd_test_batch_template = NULL;
+
+static int kmnd_test_batch_run(kmnd_t *kmnd) {
+    const char *values[] = { kmnd_input_get(kmnd, "echo.text") };
+
+    int i;
+    for (i = 0; i < kmnd_int32_get(kmnd, "echo.repeat"); i ++)
+        kmnd_template_print(kmnd, kmnd_test_batch_template, values, 1);
+
+    return 0;
+}
+
+static int kmnd_test_batch_false(kmnd_t *kmnd) {
+    (void) kmnd;
+
+    return 1;
+}
+
+static kmnd_t *kmnd_test_batch_tree(void) {
+    kmnd_t *repeat = kmnd_int32_new('r', "repeat", "This is repeat.",
+                                    KMND_FLAGS_NONE, 1),
+           *text = kmnd_input_new("text", "This is text.", KMND_FLAGS_REQUIRED,
+                                  NULL),
+           *echo = kmnd_new("echo", "This is echo.", kmnd_test_batch_run,
+                            kmnd_usage_new("foobar echo", "This is echo."),
+                            repeat, text, NULL),
+           *fail = kmnd_new("false", "This is false.", kmnd_test_batch_false,
+                            NULL, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, echo, fail,
+                            NULL);
+
+    kmnd_memory(kmnd);
+    kmnd_batch(kmnd, 1);
+
+    return kmnd;
+}
+
+/*
+ * This function writes the given text to a new temporary file and returns its
+ * path.
+ */
+static std::string kmnd_test_batch_file(const std::string &text) {
+    char path[] = "/tmp/kmnd_batch_XXXXXX";
+    int fd = mkstemp(path);
+
+    EXPECT_NE(-1, fd);
+    EXPECT_EQ((ssize_t) text.size(), write(fd, text.data(), text.size()));
+    close(fd);
+
+    return path;
+}
+
+/*
+ * This function returns a batch with many lines, two of which fail.
+ */
+static std::string kmnd_test_batch_text(void) {
+    std::string text = "# This is a comment.\n\n";
+
+    int i;
+    for (i = 0; i < 500; i ++) {
+        text += "echo --repeat=" + std::to_string(i % 3) + " 'line " +
+                std::to_string(i) + "'\n";
+
+        /* Usage text is written by several threads at once. */
+        if (i % 10 == 5)
+            text += "echo --help\n";
+
+        if (i == 100)
+            text += "echo --repeat=x abc\n";
+        else if (i == 200)
+            text += "echo \"abc\n";
+    }
+
+    /* The last line does not end with a newline. */
+    return text + "echo last";
+}
+
+/*
+ * Lines that run on several threads should have the same output, in the same
+ * order, as lines that run one by one.
+ */
+TEST(BatchFixture, Run) {
+    KMND_MEM_LEAK_PRE();
+
+    /* The strings must be freed before the memory is checked. */
+    {
+        kmnd_test_batch_template = kmnd_template_new("{0}");
+
+        std::string path = kmnd_test_batch_file(kmnd_test_batch_text());
+
+        kmnd_t *serial = kmnd_test_batch_tree(),
+               *parallel = kmnd_test_batch_tree();
+
+        EXPECT_EQ(2, kmnd_run_batch(serial, path.c_str(), 1, NULL, NULL));
+        EXPECT_EQ(2, kmnd_run_batch(parallel, path.c_str(), 8, NULL, NULL));
+
+        size_t length, parallel_length;
+        const char *output = kmnd_output(serial, &length);
+        const char *parallel_output = kmnd_output(parallel, &parallel_length);
+
+        EXPECT_EQ(std::string(output, length),
+                  std::string(parallel_output, parallel_length));
+
+        EXPECT_EQ(0, strncmp("line 1\nline 2\nline 2\nline 4\n", output, 28));
+        EXPECT_TRUE(strstr(output, "Invalid value: `x`") != NULL);
+        EXPECT_TRUE(strstr(output, "Unterminated quote") != NULL);
+        EXPECT_TRUE(strstr(output, "line 497\nline 497\nline 499\nlast\n") !=
+                    NULL);
+
+        /* The tree is reset after the batch. */
+        EXPECT_EQ(1, kmnd_int32_get(serial, "echo.repeat"));
+        EXPECT_TRUE(NULL == kmnd_input_get(serial, "echo.text"));
+
+        kmnd_free(serial);
+        kmnd_free(parallel);
+
+        unlink(path.c_str());
+
+        kmnd_template_free(kmnd_test_batch_template);
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * The exit code of each line should be returned, including those that the
+ * callbacks return.
+ */
+TEST(BatchFixture, Codes) {
+    KMND_MEM_LEAK_PRE();
+
+    /* The strings must be freed before the memory is checked. */
+    {
+        kmnd_test_batch_template = kmnd_template_new("{0}");
+
+        std::string path = kmnd_test_batch_file("echo a\n\n# c\nfalse\n"
+                                                "echo --repeat=x b\n");
+
+        size_t jobs;
+        for (jobs = 1; jobs <= 3; jobs ++) {
+            kmnd_t *kmnd = kmnd_test_batch_tree();
+
+            const int *codes = NULL;
+            size_t num_lines = 0;
+
+            EXPECT_EQ(2, kmnd_run_batch(kmnd, path.c_str(), jobs, &codes,
+                                        &num_lines));
+
+            ASSERT_EQ(5u, num_lines);
+            EXPECT_EQ(0, codes[0]);
+            EXPECT_EQ(0, codes[1]);
+            EXPECT_EQ(0, codes[2]);
+            EXPECT_EQ(1, codes[3]);
+            EXPECT_EQ(-1, codes[4]);
+
+            kmnd_free(kmnd);
+        }
+
+        unlink(path.c_str());
+
+        kmnd_template_free(kmnd_test_batch_template);
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Response files should be expanded in lines that run on one thread and in
+ * lines that run on several.
+ */
+TEST(BatchFixture, ResponseFiles) {
+    KMND_MEM_LEAK_PRE();
+
+    /* The strings must be freed before the memory is checked. */
+    {
+        kmnd_test_batch_template = kmnd_template_new("{0}");
+
+        std::string args = kmnd_test_batch_file("--repeat=2 'from file'\n");
+        std::string path = kmnd_test_batch_file("echo a\necho @" + args +
+                                                "\necho b\n");
+
+        size_t jobs;
+        for (jobs = 1; jobs <= 2; jobs ++) {
+            kmnd_t *kmnd = kmnd_test_batch_tree();
+            kmnd_response_files(kmnd, 1);
+
+            EXPECT_EQ(0, kmnd_run_batch(kmnd, path.c_str(), jobs, NULL, NULL));
+
+            size_t length;
+            EXPECT_STREQ("a\nfrom file\nfrom file\nb\n",
+                         kmnd_output(kmnd, &length));
+
+            kmnd_free(kmnd);
+        }
+
+        unlink(args.c_str());
+        unlink(path.c_str());
+
+        kmnd_template_free(kmnd_test_batch_template);
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * The root command should run a batch when it is given `--batch=FILE`.
+ */
+TEST(BatchFixture, Arguments) {
+    KMND_MEM_LEAK_PRE();
+
+    /* The strings must be freed before the memory is checked. */
+    {
+        kmnd_test_batch_template = kmnd_template_new("{0}");
+
+        std::string path = kmnd_test_batch_file("echo a\necho --repeat=2 b\n");
+        std::string batch = "--batch=" + path;
+
+        kmnd_t *kmnd = kmnd_test_batch_tree();
+
+        size_t length;
+
+        const char *args[3] = { "kmnd", batch.c_str(), "--jobs=2" };
+
+        EXPECT_EQ(0, kmnd_run(kmnd, 3, args));
+        EXPECT_STREQ("a\nb\nb\n", kmnd_output(kmnd, &length));
+        kmnd_output_clear(kmnd);
+
+        const char *jobs[3] = { "kmnd", batch.c_str(), "--jobs=x" };
+
+        EXPECT_EQ(-1, kmnd_run(kmnd, 3, jobs));
+        EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                           "Invalid value: `x`, for option: `--jobs`") != NULL);
+        kmnd_output_clear(kmnd);
+
+        const char *missing[2] = { "kmnd", "--batch=/does/not/exist" };
+
+        EXPECT_EQ(-1, kmnd_run(kmnd, 2, missing));
+        EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                           "for option: `--batch`") != NULL);
+        kmnd_output_clear(kmnd);
+
+        /* Other arguments are not a batch. */
+        const char *other[3] = { "kmnd", batch.c_str(), "echo" };
+
+        EXPECT_EQ(-1, kmnd_run(kmnd, 3, other));
+        EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                           "Unknown option") != NULL);
+
+        kmnd_free(kmnd);
+
+        unlink(path.c_str());
+
+        kmnd_template_free(kmnd_test_batch_template);
+    }
+
+    KMND_MEM_LEAK_POST();
+}
@@ -22,6 +22,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 #include "../../src/command.h"
 
 #include "malloc.h"
@@ -137,3 +139,268 @@ TEST(CommandFixture, Subcommands) {
 
     KMND_MEM_LEAK_POST();
 }
+
+TEST(CommandFixture, Terminal) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *xyz = kmnd_new("xyz", "This is the description of xyz.", NULL,
+                           NULL);
+    kmnd_t *kmnd = kmnd_new("foobar", "This is the description of foobar.",
+                            NULL, xyz, NULL);
+
+    /* Make sure that no terminal is created while building the tree. */
+    EXPECT_TRUE(NULL == ((kmnd_command_t *) kmnd)->terminal);
+    EXPECT_TRUE(NULL == ((kmnd_command_t *) xyz)->terminal);
+
+    /* Make sure that subcommands share the terminal of the root. */
+    kmnd_terminal_t *terminal;
+    terminal = kmnd_command_terminal((kmnd_command_t *) xyz);
+
+    EXPECT_EQ(STDOUT_FILENO, terminal->fd);
+    EXPECT_EQ(terminal, kmnd_command_terminal((kmnd_command_t *) kmnd));
+    EXPECT_TRUE(NULL == ((kmnd_command_t *) xyz)->terminal);
+
+    /* Make sure that a subcommand can override the terminal. */
+    EXPECT_EQ(0, kmnd_fd(xyz, STDERR_FILENO));
+    EXPECT_EQ(STDERR_FILENO,
+              kmnd_command_terminal((kmnd_command_t *) xyz)->fd);
+    EXPECT_EQ(terminal, kmnd_command_terminal((kmnd_command_t *) kmnd));
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Output that is rendered into memory should be available through kmnd_output,
+ * also when it is written by a subcommand.
+ */
+TEST(CommandFixture, Memory) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *xyz = kmnd_new("xyz", "This is the description of xyz.", NULL,
+                           NULL);
+    kmnd_t *kmnd = kmnd_new("foobar", "This is the description of foobar.",
+                            NULL, xyz, NULL);
+
+    size_t length;
+    EXPECT_TRUE(NULL == kmnd_output(kmnd, &length));
+
+    EXPECT_EQ(0, kmnd_memory(kmnd));
+
+    kmnd_template_t *tmpl = kmnd_template_new("Copied `{0}` files");
+    const char *values[] = { "3" };
+
+    EXPECT_EQ(0, kmnd_template_print(xyz, tmpl, values, 1));
+    EXPECT_EQ(0, kmnd_template_print(kmnd, tmpl, values, 1));
+
+    const char *output = kmnd_output(xyz, &length);
+    EXPECT_EQ(30u, length);
+    EXPECT_STREQ("Copied 3 files\nCopied 3 files\n", output);
+
+    kmnd_output_clear(kmnd);
+
+    output = kmnd_output(kmnd, &length);
+    EXPECT_EQ(0u, length);
+    EXPECT_STREQ("", output);
+
+    kmnd_template_free(tmpl);
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+static int kmnd_test_write(void *context, const char *data,
+                           const size_t length) {
+    ((std::string *) context)->append(data, length);
+    return 0;
+}
+
+/*
+ * Buffered output should be passed on when the tree is flushed.
+ */
+TEST(CommandFixture, Flush) {
+    std::string output;
+    output.reserve(64);
+
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is the description of foobar.",
+                            NULL, NULL);
+
+    EXPECT_EQ(0, kmnd_callback(kmnd, kmnd_test_write, &output));
+
+    kmnd_terminal_text(kmnd_command_terminal((kmnd_command_t *) kmnd), "abc",
+                       KMND_TERMINAL_OPTIONS_NONE);
+    EXPECT_EQ(0u, output.size());
+
+    EXPECT_EQ(0, kmnd_flush(kmnd));
+    EXPECT_EQ("abc\n", output);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Long options should be matched exactly, and options of a subcommand should
+ * shadow inherited options with the same name.
+ */
+TEST(CommandFixture, LongOptions) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *foo = kmnd_boolean_new('f', "foo", "This is foo.",
+                                   KMND_FLAGS_NONE, 0),
+           *bar = kmnd_string_new('b', "bar", "This is bar.",
+                                  KMND_FLAGS_NONE, "abc"),
+           *local = kmnd_string_new('b', "bar", "This is another bar.",
+                                    KMND_FLAGS_NONE, "def"),
+           *xyz = kmnd_new("xyz", "This is the description of xyz.",
+                           kmnd_test_subcommand_run, local, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is the description of foobar.",
+                            kmnd_test_run, foo, bar, xyz, NULL);
+
+    kmnd_memory(kmnd);
+
+    const char *args[4] = { "kmnd", "xyz", "--foo", "--bar=a=b" };
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 4, args));
+    EXPECT_EQ(1, kmnd_boolean_get(kmnd, "foo"));
+    EXPECT_STREQ("abc", kmnd_string_get(kmnd, "bar"));
+    EXPECT_STREQ("a=b", kmnd_string_get(kmnd, "xyz.bar"));
+
+    /* A prefix of a name is not enough. */
+    const char *prefix[2] = { "kmnd", "--fo" };
+
+    EXPECT_EQ(-1, kmnd_run(kmnd, 2, prefix));
+
+    size_t length;
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length), "`--fo`") != NULL);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Short options can be combined, including options of ancestors, and the last
+ * one may be followed by a value.
+ */
+TEST(CommandFixture, ShortOptions) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *foo = kmnd_boolean_new('f', "foo", "This is foo.",
+                                   KMND_FLAGS_NONE, 0),
+           *bar = kmnd_string_new('b', "bar", "This is bar.",
+                                  KMND_FLAGS_NONE, "abc"),
+           *quiet = kmnd_boolean_new('q', "quiet", "This is quiet.",
+                                     KMND_FLAGS_NONE, 0),
+           *local = kmnd_string_new('b', "bar", "This is another bar.",
+                                    KMND_FLAGS_NONE, "def"),
+           *xyz = kmnd_new("xyz", "This is the description of xyz.",
+                           kmnd_test_subcommand_run, local, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is the description of foobar.",
+                            kmnd_test_run, foo, bar, quiet, xyz, NULL);
+
+    kmnd_memory(kmnd);
+
+    const char *args[3] = { "kmnd", "xyz", "-fqb=x" };
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 3, args));
+    EXPECT_EQ(1, kmnd_boolean_get(kmnd, "foo"));
+    EXPECT_EQ(1, kmnd_boolean_get(kmnd, "quiet"));
+    EXPECT_STREQ("abc", kmnd_string_get(kmnd, "bar"));
+    EXPECT_STREQ("x", kmnd_string_get(kmnd, "xyz.bar"));
+
+    const char *unknown[2] = { "kmnd", "-fz" };
+
+    EXPECT_EQ(-1, kmnd_run(kmnd, 2, unknown));
+
+    size_t length;
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length), "`-z`") != NULL);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Subcommands can be abbreviated once this is enabled, as long as the
+ * abbreviation is not ambiguous.
+ */
+TEST(CommandFixture, Abbreviate) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *status = kmnd_new("status", "This is status.",
+                              kmnd_test_subcommand_run, NULL),
+           *stash = kmnd_new("stash", "This is stash.",
+                             kmnd_test_subcommand_run, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is the description of foobar.",
+                            kmnd_test_run, status, stash, NULL);
+
+    kmnd_memory(kmnd);
+
+    const char *args[2] = { "kmnd", "statu" };
+
+    EXPECT_EQ(-1, kmnd_run(kmnd, 2, args));
+
+    kmnd_abbreviate(kmnd, 1);
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 2, args));
+
+    kmnd_output_clear(kmnd);
+
+    args[1] = "sta";
+
+    EXPECT_EQ(-1, kmnd_run(kmnd, 2, args));
+
+    size_t length;
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                       "`sta`, which could be: `status` `stash`") != NULL);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * String options and inputs point into the arguments once borrowing is
+ * enabled, and their lengths are available without measuring them again.
+ */
+TEST(CommandFixture, Borrow) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *bar = kmnd_string_new('b', "bar", "This is bar.",
+                                  KMND_FLAGS_NONE, "abc"),
+           *file = kmnd_input_new("file", "This is file.", KMND_FLAGS_NONE,
+                                  NULL),
+           *xyz = kmnd_new("xyz", "This is the description of xyz.",
+                           kmnd_test_subcommand_run, file, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is the description of foobar.",
+                            kmnd_test_run, bar, xyz, NULL);
+
+    kmnd_memory(kmnd);
+    kmnd_borrow(kmnd, 1);
+
+    const char *args[4] = { "kmnd", "xyz", "--bar=hello", "world.txt" };
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 4, args));
+
+    size_t length = 0;
+    EXPECT_EQ(args[2] + 6, kmnd_string_view(kmnd, "bar", &length));
+    EXPECT_EQ(5u, length);
+
+    EXPECT_EQ(args[3], kmnd_input_view(kmnd, "xyz.file", &length));
+    EXPECT_EQ(9u, length);
+
+    EXPECT_EQ(args[3], kmnd_view(kmnd_resolve(kmnd, "xyz.file"), &length));
+    EXPECT_EQ(9u, length);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
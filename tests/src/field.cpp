@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <kmnd.h>
+
+#include "../../src/command.h"
+
+#include "malloc.h"
+
+typedef struct kmnd_test_config_s {
+    unsigned char verbose;
+    const char *name;
+    int32_t threads;
+    uint64_t size;
+    double ratio;
+    const char *file;
+} kmnd_test_config_t;
+
+static const kmnd_field_t kmnd_test_fields[] = {
+    KMND_FIELD("verbose",     BOOLEAN, kmnd_test_config_t, verbose),
+    KMND_FIELD("name",        STRING,  kmnd_test_config_t, name),
+    KMND_FIELD("run.threads", INT32,   kmnd_test_config_t, threads),
+    KMND_FIELD("run.size",    UINT64,  kmnd_test_config_t, size),
+    KMND_FIELD("run.ratio",   DOUBLE,  kmnd_test_config_t, ratio),
+    KMND_FIELD("run.file",    STRING,  kmnd_test_config_t, file)
+};
+
+static kmnd_test_config_t kmnd_test_config;
+static kmnd_fields_t *kmnd_test_compiled = NULL;
+
+static int kmnd_test_load_run(kmnd_t *kmnd) {
+    kmnd_load(kmnd_test_compiled, &kmnd_test_config);
+    return 0;
+}
+
+/*
+ * All fields should be stored in the struct at once.
+ */
+TEST(FieldFixture, Load) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0),
+           *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *threads = kmnd_int32_new('t', "threads", "This is threads.",
+                                     KMND_FLAGS_NONE, 1),
+           *size = kmnd_uint64_new('s', "size", "This is size.",
+                                   KMND_FLAGS_NONE, 2),
+           *ratio = kmnd_double_new('r', "ratio", "This is ratio.",
+                                    KMND_FLAGS_NONE, 0.5),
+           *file = kmnd_input_new("file", "This is file.", KMND_FLAGS_NONE,
+                                  NULL),
+           *run = kmnd_new("run", "This is run.", kmnd_test_load_run,
+                           threads, size, ratio, file, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, verbose, name,
+                            run, NULL);
+
+    const char *args[5] = { "kmnd", "run", "-v", "--threads=8", "input.txt" };
+
+    /* The fields are only resolved and checked once. */
+    kmnd_test_compiled = kmnd_fields_compile(kmnd, kmnd_test_fields, 6);
+    ASSERT_TRUE(kmnd_test_compiled != NULL);
+
+    memset(&kmnd_test_config, 0, sizeof(kmnd_test_config));
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 5, args));
+    EXPECT_EQ(1, kmnd_test_config.verbose);
+    EXPECT_STREQ("abc", kmnd_test_config.name);
+    EXPECT_EQ(8, kmnd_test_config.threads);
+    EXPECT_EQ(2u, kmnd_test_config.size);
+    EXPECT_EQ(0.5, kmnd_test_config.ratio);
+    EXPECT_STREQ("input.txt", kmnd_test_config.file);
+
+    kmnd_fields_free(kmnd_test_compiled);
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+typedef struct kmnd_test_wide_s {
+    int32_t threads;
+    int64_t wide;
+} kmnd_test_wide_t;
+
+/*
+ * Fields whose path, type or size does not match should be rejected.
+ */
+TEST(FieldFixture, Mismatch) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *threads = kmnd_int32_new('t', "threads", "This is threads.",
+                                     KMND_FLAGS_NONE, 1);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, threads, NULL);
+
+    kmnd_test_wide_t config;
+
+    const kmnd_field_t type[] = {
+        KMND_FIELD("threads", UINT32, kmnd_test_wide_t, threads)
+    };
+
+    const kmnd_field_t size[] = {
+        { "threads", KMND_VALUE_INT32, offsetof(kmnd_test_wide_t, wide),
+          sizeof(config.wide) }
+    };
+
+    const kmnd_field_t path[] = {
+        KMND_FIELD("thread", INT32, kmnd_test_wide_t, threads)
+    };
+
+    const kmnd_field_t valid[] = {
+        KMND_FIELD("threads", INT32, kmnd_test_wide_t, threads)
+    };
+
+    EXPECT_TRUE(NULL == kmnd_fields_compile(kmnd, type, 1));
+    EXPECT_TRUE(NULL == kmnd_fields_compile(kmnd, size, 1));
+    EXPECT_TRUE(NULL == kmnd_fields_compile(kmnd, path, 1));
+
+    kmnd_fields_t *compiled = kmnd_fields_compile(kmnd, valid, 1);
+    ASSERT_TRUE(compiled != NULL);
+
+    kmnd_load(compiled, &config);
+    EXPECT_EQ(1, config.threads);
+
+    kmnd_fields_free(compiled);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
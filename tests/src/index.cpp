@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/command.h"
+#include "../../src/index.h"
+
+#include "malloc.h"
+
+/*
+ * The index should contain the options of the command and its ancestors, even
+ * when there are many of them.
+ */
+TEST(IndexFixture, Find) {
+    KMND_MEM_LEAK_PRE();
+
+    char names[300][8];
+    kmnd_t *options[300];
+
+    size_t i;
+    for (i = 0; i < 300; i ++) {
+        snprintf(names[i], sizeof(names[i]), "opt%zu", i);
+        options[i] = kmnd_boolean_new(0, names[i], "This is an option.",
+                                      KMND_FLAGS_NONE, 0);
+    }
+
+    kmnd_t *sub = kmnd_new("sub", "This is sub.", NULL, options[200],
+                           options[201], NULL);
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, sub, NULL);
+
+    /* Attach the remaining options to the root. */
+    kmnd_command_t *root = (kmnd_command_t *) kmnd;
+    kmnd_option_t **array =
+        (kmnd_option_t **) malloc(298 * sizeof(kmnd_option_t *));
+
+    root->options = array;
+
+    for (i = 0; i < 300; i ++) {
+        if (i != 200 && i != 201)
+            root->options[root->num_options ++] = (kmnd_option_t *) options[i];
+    }
+
+    kmnd_command_t *command = (kmnd_command_t *) sub;
+    ASSERT_EQ(0, kmnd_command_finalize(command));
+
+    size_t length;
+    for (i = 0; i < 300; i ++) {
+        EXPECT_EQ((kmnd_option_t *) options[i],
+                  kmnd_index_find(&command->index, names[i], &length));
+        EXPECT_EQ(strlen(names[i]), length);
+    }
+
+    EXPECT_EQ((kmnd_option_t *) options[7],
+              kmnd_index_find(&command->index, "opt7=value", &length));
+    EXPECT_EQ(4u, length);
+
+    EXPECT_TRUE(NULL == kmnd_index_find(&command->index, "opt", &length));
+    EXPECT_TRUE(NULL == kmnd_index_find(&command->index, "opt3000",
+                                        &length));
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * The table of short names should only be allocated for commands that have
+ * short options (including inherited ones).
+ */
+TEST(IndexFixture, FindShort) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0),
+           *name = kmnd_string_new(0, "name", "This is name.",
+                                   KMND_FLAGS_NONE, NULL),
+           *count = kmnd_int32_new('c', "count", "This is count.",
+                                   KMND_FLAGS_NONE, 0),
+           *leaf = kmnd_new("leaf", "This is leaf.", NULL, name, NULL),
+           *sub = kmnd_new("sub", "This is sub.", NULL, count, NULL),
+           *kmnd = kmnd_new("foobar", "This is foobar.", NULL, leaf, sub,
+                            NULL);
+
+    kmnd_command_t *root = (kmnd_command_t *) kmnd;
+    root->options = (kmnd_option_t **) malloc(sizeof(kmnd_option_t *));
+    root->options[root->num_options ++] = (kmnd_option_t *) verbose;
+
+    kmnd_command_t *command = (kmnd_command_t *) sub;
+    ASSERT_EQ(0, kmnd_command_finalize(command));
+
+    EXPECT_TRUE(command->index.shorts != NULL);
+    EXPECT_EQ((kmnd_option_t *) count,
+              kmnd_index_find_short(&command->index, 'c'));
+    EXPECT_EQ((kmnd_option_t *) verbose,
+              kmnd_index_find_short(&command->index, 'v'));
+    EXPECT_TRUE(NULL == kmnd_index_find_short(&command->index, 'n'));
+
+    /* Without any short options there is no table. */
+    root->num_options = 0;
+
+    command = (kmnd_command_t *) leaf;
+    ASSERT_EQ(0, kmnd_command_finalize(command));
+
+    EXPECT_TRUE(command->index.shorts == NULL);
+    EXPECT_TRUE(NULL == kmnd_index_find_short(&command->index, 'v'));
+
+    root->num_options = 1;
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
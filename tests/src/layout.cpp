@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/layout.h"
+
+#include "malloc.h"
+
+TEST(LayoutFixture, Greedy) {
+    KMND_MEM_LEAK_PRE();
+
+    const char *text = "the quick brown fox jumps";
+
+    kmnd_layout_t layout;
+    ASSERT_EQ(0, kmnd_layout_init(&layout, text, strlen(text), 0));
+    ASSERT_EQ(5u, layout.num_tokens);
+    EXPECT_EQ(5u, layout.tokens[1].width);
+
+    kmnd_layout_break(&layout, 10, 0, 0, KMND_LAYOUT_GREEDY);
+
+    EXPECT_EQ(0, layout.tokens[1].wrap);
+    EXPECT_EQ(1, layout.tokens[2].wrap);
+    EXPECT_EQ(0, layout.tokens[3].wrap);
+    EXPECT_EQ(1, layout.tokens[4].wrap);
+
+    /* The first line is shorter if it starts further to the right. */
+    kmnd_layout_break(&layout, 10, 5, 0, KMND_LAYOUT_GREEDY);
+
+    EXPECT_EQ(1, layout.tokens[1].wrap);
+    EXPECT_EQ(1, layout.tokens[2].wrap);
+    EXPECT_EQ(0, layout.tokens[3].wrap);
+    EXPECT_EQ(1, layout.tokens[4].wrap);
+
+    kmnd_layout_release(&layout);
+
+    KMND_MEM_LEAK_POST();
+}
+
+TEST(LayoutFixture, Balanced) {
+    KMND_MEM_LEAK_PRE();
+
+    const char *text = "aaa bb cc ddddd";
+
+    kmnd_layout_t layout;
+    ASSERT_EQ(0, kmnd_layout_init(&layout, text, strlen(text), 0));
+
+    /* Greedy: "aaa bb", "cc" and "ddddd". */
+    kmnd_layout_break(&layout, 6, 0, 0, KMND_LAYOUT_GREEDY);
+
+    EXPECT_EQ(0, layout.tokens[1].wrap);
+    EXPECT_EQ(1, layout.tokens[2].wrap);
+    EXPECT_EQ(1, layout.tokens[3].wrap);
+
+    /* Balanced: "aaa", "bb cc" and "ddddd". */
+    kmnd_layout_break(&layout, 6, 0, 0, KMND_LAYOUT_BALANCED);
+
+    EXPECT_EQ(1, layout.tokens[1].wrap);
+    EXPECT_EQ(0, layout.tokens[2].wrap);
+    EXPECT_EQ(1, layout.tokens[3].wrap);
+
+    kmnd_layout_release(&layout);
+
+    KMND_MEM_LEAK_POST();
+}
+
+TEST(LayoutFixture, Markup) {
+    KMND_MEM_LEAK_PRE();
+
+    const char *text = "**bold** and `code`\nnext";
+
+    kmnd_layout_t layout;
+    ASSERT_EQ(0, kmnd_layout_init(&layout, text, strlen(text), 1));
+
+    EXPECT_EQ(std::string("bold and code\nnext"),
+              std::string(layout.text, layout.length));
+
+    ASSERT_EQ(4u, layout.num_runs);
+    EXPECT_EQ(4u, layout.runs[0].end);
+    EXPECT_EQ(KMND_TERMINAL_STYLE_BOLD, layout.runs[0].options);
+    EXPECT_EQ(KMND_TERMINAL_FOREGROUND_MAGENTA, layout.runs[2].options);
+
+    ASSERT_EQ(4u, layout.num_tokens);
+    EXPECT_EQ(1, layout.tokens[3].newline);
+
+    kmnd_layout_release(&layout);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Line breaks should only be computed again if the parameters change.
+ */
+TEST(LayoutFixture, Reuse) {
+    KMND_MEM_LEAK_PRE();
+
+    char text[1024];
+
+    size_t i;
+    for (i = 0; i + 1 < sizeof(text); i ++)
+        text[i] = (i % 4 == 3) ? ' ' : 'a';
+    text[i] = '\0';
+
+    kmnd_layout_t layout;
+    ASSERT_EQ(0, kmnd_layout_init(&layout, text, strlen(text), 0));
+    EXPECT_EQ(256u, layout.num_tokens);
+
+    kmnd_layout_break(&layout, 10, 0, 0, KMND_LAYOUT_GREEDY);
+    EXPECT_EQ(1, layout.tokens[2].wrap);
+
+    /* Tamper with the result to prove that it is not computed again. */
+    layout.tokens[2].wrap = 0;
+
+    kmnd_layout_break(&layout, 10, 0, 0, KMND_LAYOUT_GREEDY);
+    EXPECT_EQ(0, layout.tokens[2].wrap);
+
+    kmnd_layout_break(&layout, 20, 0, 0, KMND_LAYOUT_GREEDY);
+    EXPECT_EQ(0, layout.tokens[2].wrap);
+    EXPECT_EQ(1, layout.tokens[5].wrap);
+
+    kmnd_layout_release(&layout);
+
+    KMND_MEM_LEAK_POST();
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../../src/allocator.h"
+#include "../../src/command.h"
+
+#include "malloc.h"
+
+/*
+ * This function splits the given string and compares the arguments (after the
+ * name) with the expected ones. It returns the result of kmnd_line_split.
+ */
+static int kmnd_test_split(const char *string,
+                           std::vector<std::string> expected) {
+    kmnd_line_t line;
+    memset(&line, 0, sizeof(kmnd_line_t));
+    line.allocator = kmnd_allocator_current();
+
+    int argc = 0;
+    int res = kmnd_line_split(&line, string, strlen(string), "kmnd", &argc);
+
+    if (res == 0) {
+        EXPECT_EQ(expected.size() + 1, (size_t) argc) << string;
+        EXPECT_STREQ("kmnd", line.argv[0]);
+        EXPECT_TRUE(line.argv[argc] == NULL);
+
+        size_t i;
+        for (i = 0; i < expected.size() && i + 1 < (size_t) argc; i ++)
+            EXPECT_EQ(expected[i], line.argv[i + 1]) << string;
+    }
+
+    kmnd_line_release(&line);
+
+    return res;
+}
+
+TEST(LineFixture, Split) {
+    KMND_MEM_LEAK_PRE();
+
+    EXPECT_EQ(0, kmnd_test_split("", {}));
+    EXPECT_EQ(0, kmnd_test_split(" \t\r\n ", {}));
+    EXPECT_EQ(0, kmnd_test_split("a", { "a" }));
+    EXPECT_EQ(0, kmnd_test_split("  add  --name=abc\tx.txt\n",
+                                 { "add", "--name=abc", "x.txt" }));
+
+    /* Single quotes preserve everything. */
+    EXPECT_EQ(0, kmnd_test_split("'a b' 'c\\d' '\"' ''",
+                                 { "a b", "c\\d", "\"", "" }));
+
+    /* Double quotes preserve everything but a few escapes. */
+    EXPECT_EQ(0, kmnd_test_split("\"a b\" \"\\\"\\\\\\$\\`\" \"\\n\"",
+                                 { "a b", "\"\\$`", "\\n" }));
+    EXPECT_EQ(0, kmnd_test_split("\"a\\\nb\" \"'\"", { "ab", "'" }));
+
+    /* A backslash preserves the next character. */
+    EXPECT_EQ(0, kmnd_test_split("a\\ b \\'c \\\\ d\\\ne \\",
+                                 { "a b", "'c", "\\", "de", "\\" }));
+
+    /* Quotes may be combined within one argument. */
+    EXPECT_EQ(0, kmnd_test_split("--name='a b'\"c d\"e",
+                                 { "--name=a bc de" }));
+
+    /* Comments start at the start of a word and end at the end of a line. */
+    EXPECT_EQ(0, kmnd_test_split("a#b # c d\n e # f",
+                                 { "a#b", "e" }));
+
+    /* There are no expansions or operators. */
+    EXPECT_EQ(0, kmnd_test_split("$HOME ~ *.c a;b a|b",
+                                 { "$HOME", "~", "*.c", "a;b", "a|b" }));
+
+    EXPECT_EQ(-2, kmnd_test_split("'abc", {}));
+    EXPECT_EQ(-2, kmnd_test_split("\"abc", {}));
+    EXPECT_EQ(-2, kmnd_test_split("\"abc\\\"", {}));
+
+    KMND_MEM_LEAK_POST();
+}
+
+static int kmnd_test_line_called = 0;
+
+static int kmnd_test_line_run(kmnd_t *kmnd) {
+    kmnd_test_line_called ++;
+
+    return 0;
+}
+
+/*
+ * The same tree should run any number of lines, each of which starts with the
+ * initial values of all options and inputs.
+ */
+TEST(LineFixture, Run) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0),
+           *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *count = kmnd_int32_new('c', "count", "This is count.",
+                                   KMND_FLAGS_NONE, 3),
+           *file = kmnd_input_new("file", "This is file.", KMND_FLAGS_REQUIRED,
+                                  NULL),
+           *add = kmnd_new("add", "This is add.", kmnd_test_line_run,
+                           kmnd_usage_new("foobar add", "This is add."), count,
+                           file, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL,
+                            kmnd_usage_new("foobar", "This is foobar."),
+                            verbose, name, add, NULL);
+
+    kmnd_memory(kmnd);
+
+    kmnd_test_line_called = 0;
+
+    const char *first = "add -v --name='x y' --count=7 \"a b.txt\"";
+
+    EXPECT_EQ(0, kmnd_run_line(kmnd, first, strlen(first)));
+    EXPECT_EQ(1, kmnd_test_line_called);
+    EXPECT_EQ(1, kmnd_boolean_get(kmnd, "verbose"));
+    EXPECT_STREQ("x y", kmnd_string_get(kmnd, "name"));
+    EXPECT_EQ(7, kmnd_int32_get(kmnd, "add.count"));
+    EXPECT_STREQ("a b.txt", kmnd_input_get(kmnd, "add.file"));
+
+    const char *second = "add c.txt";
+
+    EXPECT_EQ(0, kmnd_run_line(kmnd, second, strlen(second)));
+    EXPECT_EQ(2, kmnd_test_line_called);
+    EXPECT_EQ(0, kmnd_boolean_get(kmnd, "verbose"));
+    EXPECT_STREQ("abc", kmnd_string_get(kmnd, "name"));
+    EXPECT_EQ(3, kmnd_int32_get(kmnd, "add.count"));
+    EXPECT_STREQ("c.txt", kmnd_input_get(kmnd, "add.file"));
+
+    /* A line that fails leaves no state behind either. */
+    const char *invalid = "add --count=abc d.txt";
+
+    EXPECT_EQ(-1, kmnd_run_line(kmnd, invalid, strlen(invalid)));
+
+    const char *missing = "add";
+
+    EXPECT_EQ(-1, kmnd_run_line(kmnd, missing, strlen(missing)));
+    EXPECT_EQ(2, kmnd_test_line_called);
+
+    const char *unterminated = "add 'e.txt";
+
+    kmnd_output_clear(kmnd);
+
+    size_t length;
+    EXPECT_EQ(-1, kmnd_run_line(kmnd, unterminated, strlen(unterminated)));
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                       "Unterminated quote") != NULL);
+
+    /* Options that need a value are reported instead of ending the process,
+     * also when they are combined with other short options. */
+    const char *flags[2] = { "add -v --count d.txt", "add -vc d.txt" };
+
+    size_t i;
+    for (i = 0; i < 2; i ++) {
+        kmnd_output_clear(kmnd);
+
+        EXPECT_EQ(-1, kmnd_run_line(kmnd, flags[i], strlen(flags[i])));
+        EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                           "Not a boolean option: `--count`") != NULL);
+        EXPECT_TRUE(strstr(kmnd_output(kmnd, &length), "Usage:") != NULL);
+    }
+
+    EXPECT_EQ(0, kmnd_run_line(kmnd, second, strlen(second)));
+    EXPECT_EQ(3, kmnd_test_line_called);
+    EXPECT_EQ(3, kmnd_int32_get(kmnd, "add.count"));
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+typedef struct kmnd_test_line_counter_s {
+    size_t num_allocations;
+} kmnd_test_line_counter_t;
+
+static void *kmnd_test_line_allocate(void *context, const size_t size) {
+    ((kmnd_test_line_counter_t *) context)->num_allocations ++;
+
+    return malloc(size);
+}
+
+static void kmnd_test_line_release(void *context, void *pointer) {
+    free(pointer);
+}
+
+/*
+ * Once the buffer is large enough, running a line should not allocate any
+ * memory, not even for string options and inputs.
+ */
+TEST(LineFixture, Allocations) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_test_line_counter_t counter = { 0 };
+    const kmnd_allocator_t allocator = {
+        kmnd_test_line_allocate, kmnd_test_line_release, &counter
+    };
+
+    kmnd_allocator_use(&allocator);
+
+    kmnd_t *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *file = kmnd_input_new("file", "This is file.", KMND_FLAGS_NONE,
+                                  NULL),
+           *add = kmnd_new("add", "This is add.", kmnd_test_line_run, name,
+                           file, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, add, NULL);
+
+    kmnd_allocator_use(NULL);
+
+    const char *line = "add --name=\"a b c\" 'x.txt'";
+
+    EXPECT_EQ(0, kmnd_run_line(kmnd, line, strlen(line)));
+
+    const size_t num_allocations = counter.num_allocations;
+
+    int i;
+    for (i = 0; i < 1000; i ++)
+        EXPECT_EQ(0, kmnd_run_line(kmnd, line, strlen(line)));
+
+    EXPECT_EQ(num_allocations, counter.num_allocations);
+    EXPECT_STREQ("a b c", kmnd_string_get(kmnd, "add.name"));
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
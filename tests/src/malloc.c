@@ -27,6 +27,7 @@
 #include <dlfcn.h>
 #endif
 
+#include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,16 +47,39 @@ static ssize_t usage = 0;
 static kmnd_mem_entry_t *entries = NULL;
 static uintmax_t num_entries = 0;
 
+/* This guards the entries, since memory is also allocated by threads. */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* While this is set, allocations fail and are counted in `refused`. */
+static unsigned char disabled = 0;
+static unsigned char refused = 0;
+
 ssize_t kmnd_mem_usage(void) {
     return usage;
 }
 
+void kmnd_mem_disable_start(void) {
+    refused = 0;
+    disabled = 1;
+}
+
+unsigned char kmnd_mem_disable_end(void) {
+    disabled = 0;
+
+    return refused;
+}
+
 void *malloc(const size_t size) {
     static void *(*_malloc)(const size_t) = NULL;
 
     if (_malloc == NULL)
         _malloc = dlsym(RTLD_NEXT, "malloc");
 
+    if (disabled) {
+        refused = 1;
+        return NULL;
+    }
+
     void *pointer = _malloc(size);
 
     if (!pointer)
@@ -64,13 +88,18 @@ void *malloc(const size_t size) {
     kmnd_mem_entry_t *entry = _malloc(sizeof(kmnd_mem_entry_t));
     entry->pointer = pointer;
     entry->size = size;
-    entry->next = entries;
     entry->freed = 0;
+
+    pthread_mutex_lock(&lock);
+
+    entry->next = entries;
     entries = entry;
 
     num_entries ++;
     usage += entry->size;
 
+    pthread_mutex_unlock(&lock);
+
     return pointer;
 }
 
@@ -86,11 +115,14 @@ void free(void *pointer) {
     if (_free == NULL)
         _free = dlsym(RTLD_NEXT, "free");
 
+    pthread_mutex_lock(&lock);
+
     kmnd_mem_entry_t *entry = entries;
 
     uintmax_t i;
     for (i = 0; i < num_entries; i ++) {
-        if (entry->pointer == pointer) {
+        /* Addresses are reused, so skip entries that have been freed. */
+        if (entry->pointer == pointer && !entry->freed) {
             entry->freed = 1;
             usage -= entry->size;
             break;
@@ -99,6 +131,8 @@ void free(void *pointer) {
         entry = entry->next;
     }
 
+    pthread_mutex_unlock(&lock);
+
     _free(pointer);
 }
 
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/number.h"
+
+static int kmnd_test_unsigned(const char *string, const uint64_t max,
+                              uint64_t *value) {
+    return kmnd_number_parse_unsigned(string, strlen(string), max, value);
+}
+
+static int kmnd_test_signed(const char *string, const int64_t min,
+                            const int64_t max, int64_t *value) {
+    return kmnd_number_parse_signed(string, strlen(string), min, max, value);
+}
+
+TEST(NumberFixture, Decimal) {
+    uint64_t value = 0;
+
+    /* Every length is compared with strtoull so that both the eight-digit
+     * conversion and the scalar tail are covered. */
+    const char *digits = "12345678901234567890";
+
+    size_t length;
+    for (length = 1; length < 20; length ++) {
+        std::string string(digits, length);
+
+        EXPECT_EQ(0, kmnd_test_unsigned(string.c_str(), UINT64_MAX, &value));
+        EXPECT_EQ(strtoull(string.c_str(), NULL, 10), value);
+    }
+
+    EXPECT_EQ(0, kmnd_test_unsigned("18446744073709551615", UINT64_MAX,
+                                    &value));
+    EXPECT_EQ(UINT64_MAX, value);
+
+    EXPECT_EQ(-1, kmnd_test_unsigned("18446744073709551616", UINT64_MAX,
+                                     &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("99999999999999999999", UINT64_MAX,
+                                     &value));
+
+    /* Leading whitespace and a plus sign are accepted, other characters are
+     * not. */
+    EXPECT_EQ(0, kmnd_test_unsigned(" \t+42", UINT64_MAX, &value));
+    EXPECT_EQ(42u, value);
+
+    EXPECT_EQ(-1, kmnd_test_unsigned("", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("+", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("42 ", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("4a2", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("-0", UINT64_MAX, &value));
+
+    /* Only the given length is parsed. */
+    EXPECT_EQ(0, kmnd_number_parse_unsigned("12345", 3, UINT64_MAX, &value));
+    EXPECT_EQ(123u, value);
+}
+
+TEST(NumberFixture, Prefixes) {
+    uint64_t value = 0;
+
+    EXPECT_EQ(0, kmnd_test_unsigned("0xFf", UINT64_MAX, &value));
+    EXPECT_EQ(255u, value);
+
+    EXPECT_EQ(0, kmnd_test_unsigned("0o17", UINT64_MAX, &value));
+    EXPECT_EQ(15u, value);
+
+    EXPECT_EQ(0, kmnd_test_unsigned("0B101", UINT64_MAX, &value));
+    EXPECT_EQ(5u, value);
+
+    /* A leading zero without a prefix is still decimal. */
+    EXPECT_EQ(0, kmnd_test_unsigned("010", UINT64_MAX, &value));
+    EXPECT_EQ(10u, value);
+
+    EXPECT_EQ(0, kmnd_test_unsigned("0xFFFFFFFFFFFFFFFF", UINT64_MAX, &value));
+    EXPECT_EQ(UINT64_MAX, value);
+
+    EXPECT_EQ(-1, kmnd_test_unsigned("0x10000000000000000", UINT64_MAX,
+                                     &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("0o2000000000000000000000", UINT64_MAX,
+                                     &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("0x", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("0o8", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("0b2", UINT64_MAX, &value));
+}
+
+TEST(NumberFixture, Separators) {
+    uint64_t value = 0;
+
+    EXPECT_EQ(0, kmnd_test_unsigned("1_000_000", UINT64_MAX, &value));
+    EXPECT_EQ(1000000u, value);
+
+    EXPECT_EQ(0, kmnd_test_unsigned("0xdead_beef", UINT64_MAX, &value));
+    EXPECT_EQ(0xdeadbeefu, value);
+
+    EXPECT_EQ(-1, kmnd_test_unsigned("_1", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("1_", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("1__0", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("0x_1", UINT64_MAX, &value));
+}
+
+TEST(NumberFixture, Suffixes) {
+    uint64_t value = 0;
+
+    EXPECT_EQ(0, kmnd_test_unsigned("4k", UINT64_MAX, &value));
+    EXPECT_EQ(4000u, value);
+
+    EXPECT_EQ(0, kmnd_test_unsigned("4Ki", UINT64_MAX, &value));
+    EXPECT_EQ(4096u, value);
+
+    EXPECT_EQ(0, kmnd_test_unsigned("3M", UINT64_MAX, &value));
+    EXPECT_EQ(3000000u, value);
+
+    EXPECT_EQ(0, kmnd_test_unsigned("2Gi", UINT64_MAX, &value));
+    EXPECT_EQ(2147483648u, value);
+
+    EXPECT_EQ(-1, kmnd_test_unsigned("16Ei", UINT64_MAX, &value));
+    EXPECT_EQ(0, kmnd_test_unsigned("15Ei", UINT64_MAX, &value));
+    EXPECT_EQ(15ull << 60, value);
+
+    EXPECT_EQ(-1, kmnd_test_unsigned("4ki", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("4K", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("4kB", UINT64_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("k", UINT64_MAX, &value));
+
+    /* The range is checked after the suffix is applied. */
+    EXPECT_EQ(0, kmnd_test_unsigned("64Ki", UINT32_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_unsigned("64Ki", UINT16_MAX, &value));
+}
+
+TEST(NumberFixture, Signed) {
+    int64_t value = 0;
+
+    EXPECT_EQ(0, kmnd_test_signed("-128", INT8_MIN, INT8_MAX, &value));
+    EXPECT_EQ(-128, value);
+
+    EXPECT_EQ(-1, kmnd_test_signed("-129", INT8_MIN, INT8_MAX, &value));
+    EXPECT_EQ(-1, kmnd_test_signed("128", INT8_MIN, INT8_MAX, &value));
+
+    EXPECT_EQ(0, kmnd_test_signed("-9223372036854775808", INT64_MIN,
+                                  INT64_MAX, &value));
+    EXPECT_EQ(INT64_MIN, value);
+
+    EXPECT_EQ(-1, kmnd_test_signed("9223372036854775808", INT64_MIN,
+                                   INT64_MAX, &value));
+
+    EXPECT_EQ(0, kmnd_test_signed(" -0x80", INT16_MIN, INT16_MAX, &value));
+    EXPECT_EQ(-128, value);
+
+    EXPECT_EQ(0, kmnd_test_signed("-2Ki", INT32_MIN, INT32_MAX, &value));
+    EXPECT_EQ(-2048, value);
+
+    EXPECT_EQ(0, kmnd_test_signed("-0", INT8_MIN, INT8_MAX, &value));
+    EXPECT_EQ(0, value);
+}
@@ -270,3 +270,25 @@ TEST(OptionBooleanFixture, Free) {
 
     KMND_MEM_LEAK_POST();
 }
+
+TEST(OptionBooleanFixture, Bind) {
+    KMND_MEM_LEAK_PRE();
+
+    unsigned char variable = 0;
+
+    /* Create a new boolean option that is bound to the variable. */
+    kmnd_t *boolean = kmnd_boolean_bind('b', "boolean", "This is a boolean.",
+                                        KMND_FLAGS_NONE, &variable);
+
+    kmnd_option_t *option = (kmnd_option_t *) boolean;
+    kmnd_option_flag(boolean, option);
+
+    /* Make sure that the value is written to the variable. */
+    EXPECT_EQ(1, variable);
+    EXPECT_EQ(1, kmnd_boolean_get(boolean, NULL));
+
+    /* Free the option. */
+    kmnd_free(boolean);
+
+    KMND_MEM_LEAK_POST();
+}
@@ -142,3 +142,29 @@ TEST(OptionInt32Fixture, ParseOverflow) {
         exit(1);
     }, "Invalid value");
 }
+
+TEST(OptionInt32Fixture, Bind) {
+    KMND_MEM_LEAK_PRE();
+
+    int32_t variable = 42;
+
+    /* Create a new int32 option that is bound to the variable. */
+    kmnd_t *int32 = kmnd_int32_bind('i', "int32", "This is a int32.",
+                                    KMND_FLAGS_NONE, &variable);
+
+    kmnd_option_t *option = (kmnd_option_t *) int32;
+
+    /* Make sure that the default value is taken from the variable. */
+    EXPECT_EQ(42, kmnd_int32_get(int32, NULL));
+
+    kmnd_option_activate((kmnd_t *) option, option, "-7");
+
+    /* Make sure that the value is written to the variable. */
+    EXPECT_EQ(-7, variable);
+    EXPECT_EQ(-7, kmnd_int32_get(int32, NULL));
+
+    /* Free the option. */
+    kmnd_free(int32);
+
+    KMND_MEM_LEAK_POST();
+}
@@ -78,6 +78,11 @@ TEST(OptionStringFixture, Parse) {
     /* Make sure that the value is correctly set. */
     EXPECT_STREQ("Hello World!", kmnd_string_get(string, NULL));
 
+    /* Make sure that the length is stored along with the value. */
+    size_t length = 0;
+    kmnd_string_view(string, NULL, &length);
+    EXPECT_EQ(12u, length);
+
     /* Free the option. */
     kmnd_free(string);
 
@@ -107,3 +112,29 @@ TEST(OptionStringFixture, Free) {
 
     KMND_MEM_LEAK_POST();
 }
+
+TEST(OptionStringFixture, Bind) {
+    KMND_MEM_LEAK_PRE();
+
+    const char *variable = "foobar";
+
+    /* Create a new string option that is bound to the variable. */
+    kmnd_t *string = kmnd_string_bind('s', "string", "This is a string.",
+                                      KMND_FLAGS_NONE, &variable);
+
+    /* Make sure that the default value is taken from the variable. */
+    EXPECT_STREQ("foobar", kmnd_string_get(string, NULL));
+
+    int res = kmnd_option_activate(string, (kmnd_option_t *) string,
+                                   "Hello World!");
+    EXPECT_EQ(0, res);
+
+    /* Make sure that the value is written to the variable. */
+    EXPECT_STREQ("Hello World!", variable);
+    EXPECT_STREQ("Hello World!", kmnd_string_get(string, NULL));
+
+    /* Free the option. */
+    kmnd_free(string);
+
+    KMND_MEM_LEAK_POST();
+}
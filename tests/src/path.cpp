@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
+#include "../../src/input.h"
 #include "../../src/path.h"
 
 #include "malloc.h"
@@ -46,3 +49,145 @@ TEST(PathFixture, Root) {
 
     KMND_MEM_LEAK_POST();
 }
+
+/*
+ * Names in a path should match exactly, not just by prefix.
+ */
+TEST(PathFixture, Exact) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 1),
+           *sub = kmnd_new("subcommand", "This is sub.", NULL, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, verbose, sub,
+                            NULL);
+
+    EXPECT_EQ(verbose, (kmnd_t *) kmnd_option_path(kmnd, "verbose"));
+    EXPECT_EQ(sub, (kmnd_t *) kmnd_command_path(kmnd, "subcommand"));
+
+    EXPECT_EQ(NULL, kmnd_path(kmnd, "verb"));
+    EXPECT_EQ(NULL, kmnd_path(kmnd, "sub"));
+    EXPECT_EQ(NULL, kmnd_path(kmnd, "sub.verbose"));
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+static int32_t kmnd_test_handle_count = 0;
+
+static int kmnd_test_handle_run(kmnd_t *kmnd) {
+    /* The handle is only resolved the first time. */
+    kmnd_handle_t handle = KMND_HANDLE(kmnd, "sub.count");
+    EXPECT_TRUE(handle == kmnd_resolve(kmnd, "sub.count"));
+
+    kmnd_test_handle_count = kmnd_int32_value(handle);
+
+    return 0;
+}
+
+/*
+ * Handles should refer to options and inputs and return their current values.
+ */
+TEST(PathFixture, Handle) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *count = kmnd_int32_new('c', "count", "This is count.",
+                                   KMND_FLAGS_NONE, 3),
+           *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *sub = kmnd_new("sub", "This is sub.", kmnd_test_handle_run,
+                           count, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, name, sub,
+                            NULL);
+
+    kmnd_handle_t handle = kmnd_resolve(kmnd, "name");
+
+    EXPECT_TRUE(handle != NULL);
+    EXPECT_STREQ("abc", kmnd_string_value(handle));
+    EXPECT_EQ(3, kmnd_int32_value(kmnd_resolve(kmnd, "sub.count")));
+    EXPECT_TRUE(NULL == kmnd_resolve(kmnd, "sub"));
+    EXPECT_TRUE(NULL == kmnd_resolve(kmnd, "nam"));
+
+    const char *args[4] = { "kmnd", "sub", "--name=def", "--count=7" };
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 4, args));
+    EXPECT_EQ(7, kmnd_test_handle_count);
+    EXPECT_STREQ("def", kmnd_string_value(handle));
+
+    kmnd_free(kmnd);
+
+    kmnd_t *file = kmnd_input_new("file", "This is file.", KMND_FLAGS_NONE,
+                                  NULL);
+
+    EXPECT_EQ(0, kmnd_input_activate((kmnd_input_t *) file, file, "x"));
+    EXPECT_STREQ("x", kmnd_input_value(kmnd_resolve(file, NULL)));
+
+    kmnd_free(file);
+
+    KMND_MEM_LEAK_POST();
+}
+
+static kmnd_t *kmnd_test_handle_tree(const int32_t value) {
+    kmnd_t *count = kmnd_int32_new('c', "count", "This is count.",
+                                   KMND_FLAGS_NONE, value),
+           *sub = kmnd_new("sub", "This is sub.", NULL, count, NULL);
+
+    return kmnd_new("foobar", "This is foobar.", NULL, sub, NULL);
+}
+
+/*
+ * This function reads the count through a single call site, so that every
+ * call shares its cache.
+ */
+static int32_t kmnd_test_handle_value(kmnd_t *tree) {
+    return kmnd_int32_value(KMND_HANDLE(tree, "sub.count"));
+}
+
+/*
+ * The handle of a call site should be resolved again for every new tree, even
+ * one that is allocated where a freed tree was, and separately by each thread.
+ */
+TEST(PathFixture, HandleCache) {
+    KMND_MEM_LEAK_PRE();
+
+    int32_t i;
+    for (i = 0; i < 8; i ++) {
+        kmnd_t *tree = kmnd_test_handle_tree(i);
+
+        EXPECT_EQ(i, kmnd_test_handle_value(tree));
+        EXPECT_EQ(i, kmnd_test_handle_value(tree));
+
+        kmnd_free(tree);
+    }
+
+    kmnd_t *trees[4];
+
+    for (i = 0; i < 4; i ++)
+        trees[i] = kmnd_test_handle_tree(100 + i);
+
+    std::thread threads[4];
+    int32_t values[4] = { 0 };
+
+    for (i = 0; i < 4; i ++) {
+        threads[i] = std::thread([&trees, &values, i] {
+            int j;
+            for (j = 0; j < 1000; j ++)
+                values[i] += kmnd_test_handle_value(trees[i]) - (100 + i);
+
+            values[i] += kmnd_test_handle_value(trees[i]);
+        });
+    }
+
+    for (i = 0; i < 4; i ++) {
+        threads[i].join();
+
+        EXPECT_EQ(100 + i, values[i]);
+
+        kmnd_free(trees[i]);
+    }
+
+    KMND_MEM_LEAK_POST();
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdint.h>
+
+#include "../../src/real.h"
+
+/*
+ * This function returns whether the mantissa of the given number has a digit
+ * that is not zero.
+ */
+static bool kmnd_test_nonzero(const char *string) {
+    const size_t length = strcspn(string, strstr(string, "0x") ? "pP" : "eE");
+
+    size_t i;
+    for (i = 0; i < length; i ++) {
+        if (string[i] >= '1' && string[i] <= '9')
+            return true;
+    }
+
+    return false;
+}
+
+/*
+ * This function compares the result of kmnd_real_parse_double with strtod. A
+ * result that overflows or underflows to zero must be rejected.
+ */
+static void kmnd_test_double(const char *string) {
+    const double expected = strtod(string, NULL);
+
+    double value = 0;
+    const int res = kmnd_real_parse_double(string, strlen(string), &value);
+
+    if (isinf(expected) || (expected == 0 && kmnd_test_nonzero(string))) {
+        EXPECT_EQ(-1, res) << string;
+        return;
+    }
+
+    ASSERT_EQ(0, res) << string;
+    EXPECT_EQ(0, memcmp(&expected, &value, sizeof(value))) << string;
+}
+
+static void kmnd_test_float(const char *string) {
+    const float expected = strtof(string, NULL);
+
+    float value = 0;
+    const int res = kmnd_real_parse_float(string, strlen(string), &value);
+
+    if (isinf(expected) || (expected == 0 && kmnd_test_nonzero(string))) {
+        EXPECT_EQ(-1, res) << string;
+        return;
+    }
+
+    ASSERT_EQ(0, res) << string;
+    EXPECT_EQ(0, memcmp(&expected, &value, sizeof(value))) << string;
+}
+
+static void kmnd_test_real(const char *string) {
+    kmnd_test_double(string);
+    kmnd_test_float(string);
+}
+
+TEST(RealFixture, Decimal) {
+    const char *strings[] = {
+        "0", "-0", "1", "+1.5", " \t-37.827281689071", "1e10", "1E-10",
+        ".5", "5.", "0.1", "0.3", "123456789012345678901234567890",
+        "1.7976931348623157e308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062328e-324",
+        "3.4028234663852886e38", "1.17549435e-38", "1.4e-45",
+        "9007199254740993", "9007199254740992.5", "16777217",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.000000059604644775390625", "7.038531e-26", "0.000000000000001",
+        "1e-350", "1e400", "1e-50", "1e50", "0e999999999", "000000.000001"
+    };
+
+    size_t i;
+    for (i = 0; i < sizeof(strings) / sizeof(strings[0]); i ++)
+        kmnd_test_real(strings[i]);
+}
+
+TEST(RealFixture, Random) {
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    char string[1024];
+
+    size_t i;
+    for (i = 0; i < 100000; i ++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        /* Round trips of arbitrary bit patterns, including subnormals. */
+        double real;
+        memcpy(&real, &state, sizeof(real));
+
+        if (!isfinite(real))
+            continue;
+
+        snprintf(string, sizeof(string), "%.17g", real);
+        kmnd_test_real(string);
+
+        snprintf(string, sizeof(string), "%.*e", (int) (state % 40), real);
+        kmnd_test_real(string);
+
+        /* Values that are close to halfway between two floats, with many
+         * digits. */
+        const float single = (float) real;
+
+        if (!isfinite(single))
+            continue;
+
+        snprintf(string, sizeof(string), "%.60e", (double) single +
+                 (double) single * 2.9802322387695312e-08);
+        kmnd_test_real(string);
+    }
+}
+
+TEST(RealFixture, Halfway) {
+    /* These are exactly halfway between two doubles, so they round to even,
+     * unless a digit beyond the first 800 is not zero. */
+    std::string halfway = "9007199254740993";
+    kmnd_test_real(halfway.c_str());
+
+    std::string tail = "9007199254740993." + std::string(1000, '0');
+    kmnd_test_real(tail.c_str());
+    kmnd_test_real((tail + "1").c_str());
+
+    std::string subnormal = "2.4703282292062327208828439643411068618252990130"
+                            "716238221279284125033775363510437593264991818081"
+                            "799618989828234772285886546332835517796989819938"
+                            "739800539093906315035659515570226392290858392449"
+                            "105184435931802849936536152500319370457678249219"
+                            "365623669863658480757001585769269903706311928279"
+                            "558551332927834338409351978015531246597263579574"
+                            "622766465272827220056374006485499977096599470454"
+                            "020828166226237857393450736339007967761930577506"
+                            "740176324673600968951340535537458516661134223766"
+                            "678604162159680461914467291840300530057530849048"
+                            "765391711386591646239524912623653881879636239373"
+                            "280423891018672348497668235089863388587925628302"
+                            "755995657524455507255189313690836254779186948667"
+                            "994968324049705821028513185451396213837722826145"
+                            "437693412532098591327667236328125e-324";
+    kmnd_test_real(subnormal.c_str());
+    kmnd_test_real((subnormal.substr(0, subnormal.size() - 5) + "1e-324")
+                   .c_str());
+}
+
+TEST(RealFixture, Hexadecimal) {
+    const char *strings[] = {
+        "0x1p0", "-0x37.827281689071p1", "0x1.fffffffffffffp1023",
+        "0x1.fffffffffffff8p1023", "0x1p-1074", "0x1p-1075", "0x1.8p-1075",
+        "0x1.0000000000000800000000001p0", "0x1.00000000000008p0",
+        "0x1.00000000000018p0", "0X.8P1", "0x10", "0x1p-149", "0x1.8p-150",
+        "0x1.000001p0", "0x1.0000008p0", "0x1.0000018p0", "0xffffffffp-32",
+        "0x123456789abcdef0123p0"
+    };
+
+    size_t i;
+    for (i = 0; i < sizeof(strings) / sizeof(strings[0]); i ++)
+        kmnd_test_real(strings[i]);
+}
+
+TEST(RealFixture, Special) {
+    double value = 0;
+
+    EXPECT_EQ(0, kmnd_real_parse_double("INF", 3, &value));
+    EXPECT_TRUE(isinf(value) && value > 0);
+
+    EXPECT_EQ(0, kmnd_real_parse_double("-Infinity", 9, &value));
+    EXPECT_TRUE(isinf(value) && value < 0);
+
+    EXPECT_EQ(0, kmnd_real_parse_double("nan", 3, &value));
+    EXPECT_TRUE(isnan(value));
+
+    EXPECT_EQ(0, kmnd_real_parse_double("NaN(abc_1)", 10, &value));
+    EXPECT_TRUE(isnan(value));
+
+    const char *invalid[] = {
+        "", "-", ".", "e5", "1e", "1e+", "0x", "0xp1", "0x1p", "abc", "1.5 ",
+        "infinit", "nan(", "nan(a-b)", "1..5", "1,5", "--1"
+    };
+
+    size_t i;
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i ++) {
+        EXPECT_EQ(-1, kmnd_real_parse_double(invalid[i], strlen(invalid[i]),
+                                             &value)) << invalid[i];
+    }
+
+    /* Only the given length is parsed. */
+    EXPECT_EQ(0, kmnd_real_parse_double("1.25e3", 4, &value));
+    EXPECT_EQ(1.25, value);
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "../../src/command.h"
+
+#include "malloc.h"
+
+static thread_local int kmnd_test_result_count = 0;
+
+static int kmnd_test_result_run(kmnd_t *kmnd) {
+    kmnd_test_result_count = kmnd_int32_get(kmnd, "sub.count");
+
+    return kmnd_boolean_get(kmnd, "verbose") ? 2 : 1;
+}
+
+/*
+ * This function builds a frozen tree with an option of every kind of value
+ * that is relevant and a subcommand with an input.
+ */
+static kmnd_t *kmnd_test_result_tree(void) {
+    kmnd_t *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0),
+           *name = kmnd_string_new('n', "name", "This is name.",
+                                   KMND_FLAGS_NONE, "abc"),
+           *count = kmnd_int32_new('c', "count", "This is count.",
+                                   KMND_FLAGS_NONE, 3),
+           *file = kmnd_input_new("file", "This is file.", KMND_FLAGS_REQUIRED,
+                                  NULL),
+           *sub = kmnd_new("sub", "This is sub.", kmnd_test_result_run,
+                           kmnd_usage_new("foobar sub", "This is sub."), count,
+                           file, NULL);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL,
+                            kmnd_usage_new("foobar", "This is foobar."),
+                            verbose, name, sub, NULL);
+
+    EXPECT_EQ(0, kmnd_memory(kmnd));
+    EXPECT_EQ(0, kmnd_freeze(kmnd));
+
+    return kmnd;
+}
+
+/*
+ * Results of the same tree should be independent of each other and of the tree
+ * itself, which keeps its initial values.
+ */
+TEST(ResultFixture, Parse) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *kmnd = kmnd_test_result_tree();
+
+    kmnd_result_t *a = kmnd_result_new(kmnd), *b = kmnd_result_new(kmnd);
+
+    const char *args_a[5] = { "kmnd", "sub", "-v", "--name=def", "x.txt" };
+    const char *args_b[4] = { "kmnd", "sub", "-c=42", "y.txt" };
+
+    EXPECT_EQ(0, kmnd_parse(kmnd, 5, args_a, a));
+    EXPECT_EQ(0, kmnd_parse(kmnd, 4, args_b, b));
+
+    kmnd_handle_t verbose = kmnd_resolve(kmnd, "verbose"),
+                  name = kmnd_resolve(kmnd, "name"),
+                  count = kmnd_resolve(kmnd, "sub.count"),
+                  file = kmnd_resolve(kmnd, "sub.file");
+
+    kmnd_t *sub = (kmnd_t *) ((kmnd_command_t *) kmnd)->commands[0];
+
+    EXPECT_EQ(sub, kmnd_result_command(a));
+    EXPECT_EQ(1, kmnd_result_boolean(a, verbose));
+    EXPECT_STREQ("def", kmnd_result_string(a, name));
+    EXPECT_EQ(3, kmnd_result_int32(a, count));
+    EXPECT_STREQ("x.txt", kmnd_result_input(a, file));
+    EXPECT_EQ(1, kmnd_result_activated(a, name));
+    EXPECT_EQ(0, kmnd_result_activated(a, count));
+
+    EXPECT_EQ(0, kmnd_result_boolean(b, verbose));
+    EXPECT_STREQ("abc", kmnd_result_string(b, name));
+    EXPECT_EQ(42, kmnd_result_int32(b, count));
+    EXPECT_EQ(0, kmnd_result_activated(b, name));
+
+    /* String values point into the arguments. */
+    size_t length;
+    EXPECT_EQ(args_a[3] + 7, kmnd_result_view(a, name, &length));
+    EXPECT_EQ(3u, length);
+    EXPECT_EQ(args_b[3], kmnd_result_view(b, file, &length));
+    EXPECT_EQ(5u, length);
+
+    EXPECT_EQ(0, kmnd_boolean_get(kmnd, "verbose"));
+    EXPECT_STREQ("abc", kmnd_string_get(kmnd, "name"));
+    EXPECT_EQ(3, kmnd_int32_get(kmnd, "sub.count"));
+    EXPECT_TRUE(NULL == kmnd_input_get(kmnd, "sub.file"));
+
+    /* A result starts over for every call. */
+    EXPECT_EQ(0, kmnd_parse(kmnd, 4, args_b, a));
+    EXPECT_EQ(0, kmnd_result_boolean(a, verbose));
+    EXPECT_STREQ("abc", kmnd_result_string(a, name));
+    EXPECT_STREQ("y.txt", kmnd_result_input(a, file));
+
+    kmnd_result_free(a);
+    kmnd_result_free(b);
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * While the callback of a result runs, the regular getters should return the
+ * values in that result.
+ */
+TEST(ResultFixture, Run) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *kmnd = kmnd_test_result_tree();
+    kmnd_result_t *result = kmnd_result_new(kmnd);
+
+    const char *args[5] = { "kmnd", "sub", "--verbose", "--count=7", "x" };
+
+    kmnd_test_result_count = 0;
+
+    EXPECT_EQ(0, kmnd_parse(kmnd, 5, args, result));
+    EXPECT_EQ(2, kmnd_result_run(result));
+    EXPECT_EQ(7, kmnd_test_result_count);
+
+    EXPECT_EQ(0, kmnd_boolean_get(kmnd, "verbose"));
+    EXPECT_EQ(3, kmnd_int32_get(kmnd, "sub.count"));
+
+    /* The root command has no callback, so its usage is printed instead. */
+    const char *help[2] = { "kmnd", "--help" };
+
+    EXPECT_EQ(0, kmnd_parse(kmnd, 2, help, result));
+    EXPECT_EQ(0, kmnd_result_run(result));
+
+    size_t length;
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length), "This is foobar.") != NULL);
+
+    kmnd_result_free(result);
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Invalid arguments should be recorded in the result and only printed when the
+ * result is reported.
+ */
+TEST(ResultFixture, Errors) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *kmnd = kmnd_test_result_tree();
+    kmnd_result_t *result = kmnd_result_new(kmnd);
+
+    size_t length;
+
+    const char *unknown[3] = { "kmnd", "-vx", "sub" };
+
+    EXPECT_EQ(-1, kmnd_parse(kmnd, 3, unknown, result));
+    EXPECT_EQ(-1, kmnd_result_run(result));
+    EXPECT_STREQ("", kmnd_output(kmnd, &length));
+
+    kmnd_result_report(result);
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                       "Unknown option: `-x`") != NULL);
+    kmnd_output_clear(kmnd);
+
+    const char *missing[2] = { "kmnd", "sub" };
+
+    EXPECT_EQ(-1, kmnd_parse(kmnd, 2, missing, result));
+    kmnd_t *sub = (kmnd_t *) ((kmnd_command_t *) kmnd)->commands[0];
+    EXPECT_EQ(sub, kmnd_result_command(result));
+
+    kmnd_result_report(result);
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length), "file") != NULL);
+    kmnd_output_clear(kmnd);
+
+    const char *invalid[4] = { "kmnd", "sub", "--count=abc", "x" };
+
+    EXPECT_EQ(-1, kmnd_parse(kmnd, 4, invalid, result));
+
+    const char *flag[3] = { "kmnd", "--name", "sub" };
+
+    EXPECT_EQ(-1, kmnd_parse(kmnd, 3, flag, result));
+
+    kmnd_result_report(result);
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length),
+                       "Not a boolean option: `--name`") != NULL);
+
+    kmnd_result_free(result);
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Response files should be expanded, and remain mapped while the strings of
+ * the result point into them.
+ */
+TEST(ResultFixture, ResponseFiles) {
+    KMND_MEM_LEAK_PRE();
+
+    /* The strings must be freed before the memory is checked. */
+    {
+        kmnd_t *kmnd = kmnd_test_result_tree();
+        kmnd_response_files(kmnd, 1);
+
+        kmnd_result_t *result = kmnd_result_new(kmnd);
+
+        char path[] = "/tmp/kmnd_result_XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_NE(-1, fd);
+
+        const std::string text = "sub -c=7 'in file.txt'\n";
+        EXPECT_EQ((ssize_t) text.size(), write(fd, text.data(), text.size()));
+        close(fd);
+
+        const std::string arg = std::string("@") + path;
+        const char *args[2] = { "kmnd", arg.c_str() };
+
+        EXPECT_EQ(0, kmnd_parse(kmnd, 2, args, result));
+        EXPECT_EQ(7, kmnd_result_int32(result, kmnd_resolve(kmnd,
+                                                            "sub.count")));
+
+        unlink(path);
+
+        EXPECT_STREQ("in file.txt",
+                     kmnd_result_input(result, kmnd_resolve(kmnd,
+                                                            "sub.file")));
+
+        kmnd_result_free(result);
+        kmnd_free(kmnd);
+    }
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * A frozen tree should be usable from several threads at the same time.
+ */
+TEST(ResultFixture, Threads) {
+    kmnd_t *kmnd = kmnd_test_result_tree();
+
+    kmnd_handle_t count = kmnd_resolve(kmnd, "sub.count"),
+                  file = kmnd_resolve(kmnd, "sub.file");
+
+    std::thread threads[4];
+    int failures[4] = { 0, 0, 0, 0 };
+
+    int t;
+    for (t = 0; t < 4; t ++) {
+        threads[t] = std::thread([=, &failures]() {
+            kmnd_result_t *result = kmnd_result_new(kmnd);
+
+            char value[32];
+            const char *args[4] = { "kmnd", "sub", value, "x" };
+
+            int i;
+            for (i = 0; i < 1000; i ++) {
+                snprintf(value, sizeof(value), "--count=%d", t * 1000 + i);
+
+                if (kmnd_parse(kmnd, 4, args, result) != 0 ||
+                    kmnd_result_int32(result, count) != t * 1000 + i ||
+                    strcmp(kmnd_result_input(result, file), "x") != 0 ||
+                    kmnd_result_run(result) != 1 ||
+                    kmnd_test_result_count != t * 1000 + i)
+                    failures[t] ++;
+            }
+
+            kmnd_result_free(result);
+        });
+    }
+
+    for (t = 0; t < 4; t ++) {
+        threads[t].join();
+        EXPECT_EQ(0, failures[t]);
+    }
+
+    kmnd_free(kmnd);
+}
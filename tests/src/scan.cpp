@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/scan.h"
+
+TEST(ScanFixture, Any) {
+    char text[200];
+
+    /* Every position and every length is compared with a plain loop so that
+     * both the vectorized body and the scalar tail are covered. */
+    size_t length;
+    for (length = 0; length < sizeof(text); length += 7) {
+        size_t position;
+        for (position = 0; position <= length; position ++) {
+            memset(text, 'a', sizeof(text));
+
+            if (position < length)
+                text[position] = '_';
+
+            EXPECT_EQ(position, kmnd_scan_any(text, length, "`*_{", 4));
+            EXPECT_EQ(position, kmnd_scan_any_portable(text, length, "`*_{",
+                                                       4));
+        }
+    }
+
+    /* A needle that is not searched for is ignored. */
+    EXPECT_EQ(5u, kmnd_scan_any("{ab*c_d", 7, "`_", 2));
+    EXPECT_EQ(0u, kmnd_scan_any("{ab*c_d", 7, "`*_{", 4));
+    EXPECT_EQ(7u, kmnd_scan_any("{ab*c_d", 7, "`", 1));
+
+    /* Bytes with the high bit set must not be mistaken for a needle. */
+    memset(text, '\xe0', sizeof(text));
+    text[150] = '*';
+
+    EXPECT_EQ(150u, kmnd_scan_any(text, sizeof(text), "`*_{", 4));
+    EXPECT_EQ(150u, kmnd_scan_any_portable(text, sizeof(text), "`*_{", 4));
+}
+
+TEST(ScanFixture, ASCII) {
+    char text[200];
+
+    size_t length;
+    for (length = 0; length < sizeof(text); length += 7) {
+        size_t position;
+        for (position = 0; position <= length; position ++) {
+            memset(text, '~', sizeof(text));
+
+            if (position < length)
+                text[position] = (position % 2) ? '\x1B' : '\xC3';
+
+            EXPECT_EQ(position, kmnd_scan_ascii(text, length));
+            EXPECT_EQ(position, kmnd_scan_ascii_portable(text, length));
+        }
+    }
+
+    EXPECT_EQ(3u, kmnd_scan_ascii("a b\n", 4));
+    EXPECT_EQ(4u, kmnd_scan_ascii(" ~\x7F" "a", 4));
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/command.h"
+
+#include "malloc.h"
+
+static int32_t kmnd_test_threads = 4;
+
+static int kmnd_test_spec_called = 0;
+
+static int kmnd_test_spec_run(kmnd_t *kmnd) {
+    kmnd_test_spec_called ++;
+
+    return 0;
+}
+
+static const kmnd_option_spec_t kmnd_test_run_options[] = {
+    KMND_BIND_SPEC(INT32, 't', "threads", "This is threads.", KMND_FLAGS_NONE,
+                   &kmnd_test_threads),
+    KMND_REAL_SPEC(DOUBLE, 'r', "ratio", "This is ratio.", KMND_FLAGS_NONE,
+                   0.5),
+    KMND_UINT_SPEC(UINT16, 's', "size", "This is size.", KMND_FLAGS_NONE, 80)
+};
+
+static const kmnd_input_spec_t kmnd_test_run_inputs[] = {
+    KMND_INPUT_SPEC("file", "This is file.", KMND_FLAGS_REQUIRED, NULL)
+};
+
+static const kmnd_option_spec_t kmnd_test_list_options[] = {
+    KMND_BOOLEAN_SPEC('a', "all", "This is all.", KMND_FLAGS_NONE, 0)
+};
+
+static const kmnd_spec_t kmnd_test_commands[] = {
+    { "run", "This is run.", kmnd_test_spec_run, "foobar run [options] file",
+      KMND_SPEC_ARRAY(kmnd_test_run_options),
+      KMND_SPEC_ARRAY(kmnd_test_run_inputs),
+      NULL, 0 },
+    { "list", "This is list.", NULL, NULL,
+      KMND_SPEC_ARRAY(kmnd_test_list_options),
+      NULL, 0,
+      NULL, 0 }
+};
+
+static const kmnd_option_spec_t kmnd_test_options[] = {
+    KMND_BOOLEAN_SPEC('v', "verbose", "This is verbose.", KMND_FLAGS_NONE, 0),
+    KMND_STRING_SPEC('n', "name", "This is name.", KMND_FLAGS_NONE, "abc"),
+    KMND_INT_SPEC(INT8, 'l', "level", "This is level.", KMND_FLAGS_NONE, -3)
+};
+
+static const kmnd_spec_t kmnd_test_spec = {
+    "foobar", "This is foobar.", NULL, "foobar [options] command",
+    KMND_SPEC_ARRAY(kmnd_test_options),
+    NULL, 0,
+    KMND_SPEC_ARRAY(kmnd_test_commands)
+};
+
+/*
+ * A tree that is created from a static spec should behave like one that is
+ * created with kmnd_new.
+ */
+TEST(SpecFixture, New) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *kmnd = kmnd_spec_new(&kmnd_test_spec);
+    ASSERT_TRUE(kmnd != NULL);
+
+    kmnd_memory(kmnd);
+
+    EXPECT_STREQ("abc", kmnd_string_get(kmnd, "name"));
+    EXPECT_EQ(-3, kmnd_int8_get(kmnd, "level"));
+    EXPECT_EQ(80, kmnd_uint16_get(kmnd, "run.size"));
+    EXPECT_EQ(4, kmnd_int32_get(kmnd, "run.threads"));
+
+    const char *args[6] = { "kmnd", "run", "-v", "--threads=8",
+                            "--name=def", "x.txt" };
+
+    kmnd_test_spec_called = 0;
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 6, args));
+    EXPECT_EQ(1, kmnd_test_spec_called);
+    EXPECT_EQ(1, kmnd_boolean_get(kmnd, "verbose"));
+    EXPECT_STREQ("def", kmnd_string_get(kmnd, "name"));
+    EXPECT_EQ(0.5, kmnd_double_get(kmnd, "run.ratio"));
+    EXPECT_STREQ("x.txt", kmnd_input_get(kmnd, "run.file"));
+    EXPECT_EQ(8, kmnd_test_threads);
+
+    /* The usage sections are part of the tree. */
+    const char *help[3] = { "kmnd", "run", "--help" };
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 3, help));
+
+    size_t length;
+    EXPECT_TRUE(strstr(kmnd_output(kmnd, &length), "--threads") != NULL);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Only the commands that are used should be created from the spec.
+ */
+TEST(SpecFixture, Lazy) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *kmnd = kmnd_spec_new(&kmnd_test_spec);
+    ASSERT_TRUE(kmnd != NULL);
+
+    kmnd_command_t *root = (kmnd_command_t *) kmnd;
+
+    EXPECT_TRUE(root->spec == &kmnd_test_spec);
+    EXPECT_EQ(0u, root->num_options);
+
+    const char *args[4] = { "kmnd", "run", "-v", "x.txt" };
+
+    EXPECT_EQ(0, kmnd_run(kmnd, 4, args));
+    EXPECT_TRUE(root->spec == NULL);
+    ASSERT_EQ(2u, root->num_commands);
+
+    kmnd_command_t *run = root->commands[0], *list = root->commands[1];
+
+    EXPECT_TRUE(run->spec == NULL);
+    EXPECT_EQ(3u, run->num_options);
+    EXPECT_TRUE(list->spec == &kmnd_test_commands[1]);
+    EXPECT_EQ(0u, list->num_options);
+
+    /* Paths create the commands they pass through. */
+    EXPECT_EQ(0, kmnd_boolean_get(kmnd, "list.all"));
+    EXPECT_TRUE(list->spec == NULL);
+    EXPECT_EQ(1u, list->num_options);
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/command.h"
+#include "../../src/template.h"
+
+#include "malloc.h"
+
+TEST(TemplateFixture, Spans) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_template_t *tmpl = kmnd_template_new("Copied `{0}` files to **{1}**");
+
+    /* Make sure that the format is split into text and placeholders. */
+    ASSERT_EQ(4u, tmpl->num_spans);
+
+    EXPECT_EQ(0, strncmp("Copied ", tmpl->spans[0].text,
+                         tmpl->spans[0].length));
+    EXPECT_EQ(0, tmpl->spans[1].placeholder);
+    EXPECT_EQ(KMND_TERMINAL_FOREGROUND_MAGENTA, tmpl->spans[1].options);
+    EXPECT_EQ(0, strncmp(" files to ", tmpl->spans[2].text,
+                         tmpl->spans[2].length));
+    EXPECT_EQ(1, tmpl->spans[3].placeholder);
+    EXPECT_EQ(KMND_TERMINAL_STYLE_BOLD, tmpl->spans[3].options);
+
+    /* Make sure that the width of the text is computed up front. */
+    EXPECT_EQ(7u, tmpl->spans[0].width);
+    EXPECT_EQ(10u, tmpl->spans[2].width);
+
+    kmnd_template_free(tmpl);
+
+    KMND_MEM_LEAK_POST();
+}
+
+TEST(TemplateFixture, Print) {
+    KMND_MEM_LEAK_PRE();
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar", NULL, NULL);
+    kmnd_fd(kmnd, fds[1]);
+
+    kmnd_template_t *tmpl = kmnd_template_new("Copied `{0}` files to {1} "
+                                              "({{2}) {2}");
+
+    const char *values[] = { "3", "/tmp" };
+    EXPECT_EQ(0, kmnd_template_print(kmnd, tmpl, values, 2));
+    EXPECT_EQ(0, kmnd_template_print(kmnd, tmpl, values, 1));
+
+    /* Make sure that placeholders are substituted and missing values are left
+     * empty. */
+    const char expected[] = "Copied 3 files to /tmp ({2}) \n"
+                            "Copied 3 files to  ({2}) \n";
+
+    char buffer[sizeof(expected)] = { 0 };
+    EXPECT_EQ((ssize_t) sizeof(expected) - 1,
+              read(fds[0], buffer, sizeof(buffer)));
+    EXPECT_STREQ(expected, buffer);
+
+    kmnd_template_free(tmpl);
+    kmnd_free(kmnd);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Spans that do not fit on the line should still be wrapped between words.
+ */
+TEST(TemplateFixture, Wrap) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new_memory();
+    terminal->num_columns = 20;
+
+    kmnd_template_t *tmpl = kmnd_template_new("Copied {0} files to {1} in "
+                                              "time\nand {0} more");
+
+    const char *values[] = { "12345", "/a/long/path" };
+    kmnd_template_render(tmpl, terminal, values, 2,
+                         KMND_TERMINAL_OPTIONS_NONE);
+
+    size_t length;
+    EXPECT_STREQ("Copied 12345 files\nto /a/long/path in\ntime\nand 12345 "
+                 "more\n", kmnd_terminal_output(terminal, &length));
+
+    kmnd_template_free(tmpl);
+    kmnd_terminal_free(terminal);
+
+    KMND_MEM_LEAK_POST();
+}
@@ -20,7 +20,10 @@
  * THE SOFTWARE.
  */
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <signal.h>
+#include <sys/ioctl.h>
 
 #include "../../src/terminal.h"
 
@@ -95,3 +98,437 @@ TEST(TerminalFixture, Free) {
 
     KMND_MEM_LEAK_POST();
 }
+
+/*
+ * Output should be buffered until the terminal is flushed.
+ */
+TEST(TerminalFixture, Flush) {
+    KMND_MEM_LEAK_PRE();
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    /* Create a new terminal that writes to the pipe. */
+    kmnd_terminal_t *terminal = kmnd_terminal_new(fds[1]);
+
+    kmnd_terminal_text(terminal, "foo", KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+    kmnd_terminal_text(terminal, "bar", KMND_TERMINAL_OPTIONS_NONE);
+
+    /* Make sure that nothing is written yet. */
+    char buffer[16];
+    EXPECT_EQ(-1, read(fds[0], buffer, sizeof(buffer)));
+
+    /* Flush the terminal and make sure that everything is written at once. */
+    EXPECT_EQ(0, kmnd_terminal_flush(terminal));
+    EXPECT_EQ(7, read(fds[0], buffer, sizeof(buffer)));
+    EXPECT_EQ(0, memcmp("foobar\n", buffer, 7));
+
+    /* Free the terminal. */
+    kmnd_terminal_free(terminal);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Text that does not fit in the buffer should be written immediately and in
+ * the right order.
+ */
+TEST(TerminalFixture, Overflow) {
+    KMND_MEM_LEAK_PRE();
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    /* Create a new terminal that writes to the pipe. */
+    kmnd_terminal_t *terminal = kmnd_terminal_new(fds[1]);
+
+    char text[3 * KMND_TERMINAL_BUFFER_SIZE + 1];
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+
+    kmnd_terminal_text(terminal, "b", KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+    kmnd_terminal_text(terminal, text, KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+    /* Make sure that the text has been written without flushing. */
+    char buffer[2];
+    EXPECT_EQ(2, read(fds[0], buffer, sizeof(buffer)));
+    EXPECT_EQ(0, memcmp("ba", buffer, 2));
+
+    /* Free the terminal. */
+    kmnd_terminal_free(terminal);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Terminals that do not write to a TTY should not use formatting and should
+ * default to 80 columns.
+ */
+TEST(TerminalFixture, NotATTY) {
+    KMND_MEM_LEAK_PRE();
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    /* Create a new terminal that writes to the pipe. */
+    kmnd_terminal_t *terminal = kmnd_terminal_new(fds[1]);
+
+    EXPECT_EQ(0, terminal->is_tty);
+    EXPECT_EQ(0, kmnd_terminal_supports_formatting(terminal));
+    EXPECT_EQ(80, terminal->num_columns);
+
+    /* Free the terminal. */
+    kmnd_terminal_free(terminal);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * The number of columns should be determined again after the window has been
+ * resized.
+ */
+TEST(TerminalFixture, Resize) {
+    KMND_MEM_LEAK_PRE();
+
+    /* Open a pseudo terminal with 100 columns. */
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, master);
+    ASSERT_EQ(0, grantpt(master));
+    ASSERT_EQ(0, unlockpt(master));
+
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, slave);
+
+    struct winsize size = {0};
+    size.ws_col = 100;
+    ASSERT_EQ(0, ioctl(slave, TIOCSWINSZ, &size));
+
+    /* Create a new terminal that writes to the pseudo terminal. */
+    kmnd_terminal_t *terminal = kmnd_terminal_new(slave);
+
+    EXPECT_EQ(1, terminal->is_tty);
+    EXPECT_EQ(100, terminal->num_columns);
+
+    /* Resize the window and notify the terminal. */
+    size.ws_col = 120;
+    ASSERT_EQ(0, ioctl(slave, TIOCSWINSZ, &size));
+    raise(SIGWINCH);
+
+    kmnd_terminal_text(terminal, "", KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+    EXPECT_EQ(120, terminal->num_columns);
+
+    /* Free the terminal. */
+    kmnd_terminal_free(terminal);
+
+    close(slave);
+    close(master);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Only the difference between the styles of consecutive texts should be
+ * written and the style should be reset when the terminal is flushed.
+ */
+TEST(TerminalFixture, Style) {
+    setenv("TERM", "xterm", 1);
+
+    KMND_MEM_LEAK_PRE();
+
+    /* Open a pseudo terminal that supports formatting. */
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, master);
+    ASSERT_EQ(0, grantpt(master));
+    ASSERT_EQ(0, unlockpt(master));
+
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, slave);
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new(slave);
+    ASSERT_EQ(1, kmnd_terminal_supports_formatting(terminal));
+
+    kmnd_terminal_text(terminal, "a", (kmnd_terminal_options_t)
+                       (KMND_TERMINAL_FOREGROUND_GREEN |
+                        KMND_TERMINAL_OPTIONS_NO_NEWLINE));
+    kmnd_terminal_text(terminal, "b", (kmnd_terminal_options_t)
+                       (KMND_TERMINAL_FOREGROUND_GREEN |
+                        KMND_TERMINAL_OPTIONS_NO_NEWLINE));
+    kmnd_terminal_text(terminal, "c", (kmnd_terminal_options_t)
+                       (KMND_TERMINAL_FOREGROUND_GREEN |
+                        KMND_TERMINAL_STYLE_BOLD |
+                        KMND_TERMINAL_OPTIONS_NO_NEWLINE));
+    kmnd_terminal_text(terminal, "d", (kmnd_terminal_options_t)
+                       (KMND_TERMINAL_FOREGROUND_RED |
+                        KMND_TERMINAL_OPTIONS_NO_NEWLINE));
+    kmnd_terminal_text(terminal, "e", (kmnd_terminal_options_t)
+                       (KMND_TERMINAL_STYLE_UNDERLINE |
+                        KMND_TERMINAL_OPTIONS_NO_NEWLINE));
+
+    EXPECT_EQ(0, kmnd_terminal_flush(terminal));
+
+    const char expected[] = "\x1B[32ma" "b" "\x1B[1mc" "\x1B[22;31md"
+                            "\x1B[4;39me" "\x1B[0m";
+
+    char buffer[sizeof(expected)] = { 0 };
+    EXPECT_EQ((ssize_t) sizeof(expected) - 1,
+              read(master, buffer, sizeof(buffer)));
+    EXPECT_STREQ(expected, buffer);
+
+    /* Free the terminal. */
+    kmnd_terminal_free(terminal);
+
+    close(slave);
+    close(master);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Text should wrap based on the number of columns that characters occupy
+ * rather than the number of bytes.
+ */
+TEST(TerminalFixture, Width) {
+    KMND_MEM_LEAK_PRE();
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new(fds[1]);
+    ASSERT_EQ(80, kmnd_terminal_columns(terminal));
+
+    char text[128];
+    memset(text, 'a', sizeof(text));
+
+    kmnd_terminal_capture_start(terminal);
+
+    /* Two-byte characters that occupy a single column. */
+    strcpy(text + 78, "\xC3\xA9\xC3\xA9");
+    kmnd_terminal_text(terminal, text, KMND_TERMINAL_OPTIONS_NONE);
+
+    /* A wide character that does not fit on the same line. */
+    memset(text, 'a', sizeof(text));
+    strcpy(text + 79, "\xE6\xBC\xA2");
+    kmnd_terminal_text(terminal, text, KMND_TERMINAL_OPTIONS_NONE);
+
+    /* A combining mark that stays with the character before it. */
+    memset(text, 'a', sizeof(text));
+    strcpy(text + 80, "\xCC\x81" "b");
+    kmnd_terminal_text(terminal, text, KMND_TERMINAL_OPTIONS_NONE);
+
+    size_t length;
+    char *output = kmnd_terminal_capture_end(terminal, &length);
+
+    std::string expected;
+    expected.append(78, 'a').append("\xC3\xA9\xC3\xA9\n");
+    expected.append(79, 'a').append("\n\xE6\xBC\xA2\n");
+    expected.append(80, 'a').append("\xCC\x81\nb\n");
+
+    EXPECT_EQ(expected, std::string(output, length));
+
+    free(output);
+
+    /* Free the terminal. */
+    kmnd_terminal_free(terminal);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    expected.clear();
+    expected.shrink_to_fit();
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Text should wrap between words and continue after the indent.
+ */
+TEST(TerminalFixture, Wrap) {
+    KMND_MEM_LEAK_PRE();
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new(fds[1]);
+
+    kmnd_terminal_capture_start(terminal);
+
+    kmnd_terminal_text(terminal, "    ", KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+    kmnd_terminal_indent(terminal, "    ", KMND_TERMINAL_OPTIONS_NONE);
+
+    kmnd_terminal_format(terminal, "Lorem ipsum dolor sit amet, consectetur "
+                         "adipiscing elit, sed do eiusmod tempor incididunt "
+                         "ut labore et **dolore** magna aliqua.",
+                         KMND_TERMINAL_OPTIONS_NONE);
+
+    kmnd_terminal_indent(terminal, NULL, KMND_TERMINAL_OPTIONS_NONE);
+
+    size_t length;
+    char *output = kmnd_terminal_capture_end(terminal, &length);
+
+    const char expected[] =
+        "    Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+        "eiusmod\n"
+        "    tempor incididunt ut labore et dolore magna aliqua.\n";
+
+    EXPECT_EQ(sizeof(expected) - 1, length);
+    EXPECT_EQ(0, memcmp(expected, output, sizeof(expected) - 1));
+
+    free(output);
+
+    /* Free the terminal. */
+    kmnd_terminal_free(terminal);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Text should still be written (without wrapping) if memory for the layout
+ * cannot be allocated.
+ */
+TEST(TerminalFixture, WrapWithoutMemory) {
+    KMND_MEM_LEAK_PRE();
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new(fds[1]);
+
+    kmnd_terminal_capture_start(terminal);
+    kmnd_terminal_indent(terminal, "  ", KMND_TERMINAL_OPTIONS_NONE);
+
+    kmnd_mem_disable_start();
+    kmnd_terminal_text(terminal, "Lorem ipsum\ndolor sit amet.",
+                       KMND_TERMINAL_OPTIONS_NONE);
+    EXPECT_EQ(1, kmnd_mem_disable_end());
+
+    kmnd_terminal_indent(terminal, NULL, KMND_TERMINAL_OPTIONS_NONE);
+
+    size_t length;
+    char *output = kmnd_terminal_capture_end(terminal, &length);
+
+    const char expected[] = "Lorem ipsum\n  dolor sit amet.\n";
+
+    EXPECT_EQ(sizeof(expected) - 1, length);
+    EXPECT_EQ(0, memcmp(expected, output, sizeof(expected) - 1));
+
+    free(output);
+
+    kmnd_terminal_free(terminal);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * A memory terminal should collect all output, including output that is
+ * larger than the buffer.
+ */
+TEST(TerminalFixture, Memory) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new_memory();
+
+    EXPECT_EQ(0, terminal->is_tty);
+    EXPECT_EQ(0, kmnd_terminal_supports_formatting(terminal));
+
+    char text[2 * KMND_TERMINAL_BUFFER_SIZE + 1];
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+
+    kmnd_terminal_text(terminal, "b", KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+    kmnd_terminal_text(terminal, text, KMND_TERMINAL_OPTIONS_NO_NEWLINE);
+
+    size_t length;
+    const char *output = kmnd_terminal_output(terminal, &length);
+
+    /* Long words are wrapped at 80 columns. */
+    EXPECT_EQ(sizeof(text) + (sizeof(text) - 1) / 80, length);
+    EXPECT_EQ(0, strncmp("ba", output, 2));
+    EXPECT_EQ('\0', output[length]);
+
+    kmnd_terminal_output_clear(terminal);
+
+    kmnd_terminal_text(terminal, "c", KMND_TERMINAL_OPTIONS_NONE);
+    EXPECT_STREQ("c\n", kmnd_terminal_output(terminal, &length));
+
+    kmnd_terminal_free(terminal);
+
+    KMND_MEM_LEAK_POST();
+}
+
+static int kmnd_terminal_test_callback(void *context, const char *data,
+                                       const size_t length) {
+    ((std::string *) context)->append(data, length);
+    return 0;
+}
+
+/*
+ * A callback terminal should pass its output to the callback when it is
+ * flushed.
+ */
+TEST(TerminalFixture, Callback) {
+    std::string output;
+    output.reserve(64);
+
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_terminal_t *terminal =
+        kmnd_terminal_new_callback(kmnd_terminal_test_callback, &output);
+
+    kmnd_terminal_format(terminal, "Hello **world**",
+                         KMND_TERMINAL_OPTIONS_NONE);
+    EXPECT_EQ(0u, output.size());
+
+    EXPECT_EQ(0, kmnd_terminal_flush(terminal));
+    EXPECT_EQ("Hello world\n", output);
+
+    kmnd_terminal_free(terminal);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * A FILE terminal should write to the stream and flush it.
+ */
+TEST(TerminalFixture, File) {
+    FILE *file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+
+    /* Make sure that the stream does not allocate its own buffer. */
+    char stream[BUFSIZ];
+    setvbuf(file, stream, _IOFBF, sizeof(stream));
+
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_terminal_t *terminal = kmnd_terminal_new_file(file);
+    EXPECT_EQ(fileno(file), terminal->fd);
+
+    kmnd_terminal_text(terminal, "Hello", KMND_TERMINAL_OPTIONS_NONE);
+    EXPECT_EQ(0, kmnd_terminal_flush(terminal));
+
+    kmnd_terminal_free(terminal);
+
+    KMND_MEM_LEAK_POST();
+
+    char buffer[7] = { 0 };
+    EXPECT_EQ(6, pread(fileno(file), buffer, 6, 0));
+    EXPECT_STREQ("Hello\n", buffer);
+
+    fclose(file);
+}
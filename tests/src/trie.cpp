@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/command.h"
+#include "../../src/trie.h"
+
+#include "malloc.h"
+
+/*
+ * The trie should find each child by its exact name, even when there are many
+ * siblings that share prefixes.
+ */
+TEST(TrieFixture, Find) {
+    KMND_MEM_LEAK_PRE();
+
+    char names[1000][8];
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, NULL);
+    kmnd_command_t *root = (kmnd_command_t *) kmnd;
+
+    root->commands = (kmnd_command_t **) malloc(1000 * sizeof(kmnd_t *));
+
+    size_t i;
+    for (i = 0; i < 1000; i ++) {
+        snprintf(names[i], sizeof(names[i]), "cmd%zu", i);
+        root->commands[root->num_commands ++] =
+            (kmnd_command_t *) kmnd_new(names[i], "This is a command.", NULL,
+                                        NULL);
+    }
+
+    ASSERT_EQ(0, kmnd_command_finalize(root));
+
+    for (i = 0; i < 1000; i ++) {
+        EXPECT_EQ((kmnd_t *) root->commands[i],
+                  kmnd_trie_find(&root->trie, names[i], strlen(names[i])));
+    }
+
+    EXPECT_TRUE(NULL == kmnd_trie_find(&root->trie, "cmd", 3));
+    EXPECT_TRUE(NULL == kmnd_trie_find(&root->trie, "cmd1000", 7));
+    EXPECT_EQ((kmnd_t *) root->commands[1],
+              kmnd_trie_find(&root->trie, "cmd10", 4));
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
+
+/*
+ * Subcommands should take precedence over options with the same name, and
+ * prefixes should only select a subcommand if they are unique.
+ */
+TEST(TrieFixture, Abbreviate) {
+    KMND_MEM_LEAK_PRE();
+
+    kmnd_t *status = kmnd_new("status", "This is status.", NULL, NULL),
+           *stash = kmnd_new("stash", "This is stash.", NULL, NULL),
+           *commit = kmnd_new("commit", "This is commit.", NULL, NULL),
+           *option = kmnd_boolean_new('s', "status", "This is status.",
+                                      KMND_FLAGS_NONE, 0),
+           *verbose = kmnd_boolean_new('v', "verbose", "This is verbose.",
+                                       KMND_FLAGS_NONE, 0);
+
+    kmnd_t *kmnd = kmnd_new("foobar", "This is foobar.", NULL, option,
+                            verbose, status, stash, commit, NULL);
+
+    kmnd_command_t *root = (kmnd_command_t *) kmnd;
+    ASSERT_EQ(0, kmnd_command_finalize(root));
+
+    EXPECT_EQ(status, kmnd_trie_find(&root->trie, "status", 6));
+    EXPECT_EQ(verbose, kmnd_trie_find(&root->trie, "verbose", 7));
+
+    kmnd_t *command = NULL;
+
+    EXPECT_EQ(0, kmnd_trie_find_command(&root->trie, "stash", 0, &command));
+    EXPECT_EQ(stash, command);
+
+    EXPECT_EQ(-1, kmnd_trie_find_command(&root->trie, "com", 0, &command));
+    EXPECT_EQ(0, kmnd_trie_find_command(&root->trie, "com", 1, &command));
+    EXPECT_EQ(commit, command);
+
+    EXPECT_EQ(0, kmnd_trie_find_command(&root->trie, "statu", 1, &command));
+    EXPECT_EQ(status, command);
+
+    EXPECT_EQ(-2, kmnd_trie_find_command(&root->trie, "sta", 1, &command));
+    EXPECT_EQ(-1, kmnd_trie_find_command(&root->trie, "verb", 1, &command));
+    EXPECT_EQ(-1, kmnd_trie_find_command(&root->trie, "stax", 1, &command));
+
+    kmnd_free(kmnd);
+
+    KMND_MEM_LEAK_POST();
+}
@@ -20,6 +20,8 @@
  * THE SOFTWARE.
  */
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <gtest/gtest.h>
 
 #include "../../src/usage.h"
@@ -168,3 +170,72 @@ TEST(UsageFixture, All) {
        "    -h/--help     Show help banner of specified command\n"
        "$");
 }
+
+/*
+ * This function returns the path of the only file in the only directory in the
+ * given directory.
+ */
+static std::string usage_cache_file(const std::string &directory) {
+    std::string path = directory;
+
+    for (int i = 0; i < 2; i ++) {
+        DIR *dir = opendir(path.c_str());
+        struct dirent *entry;
+
+        while ((entry = readdir(dir)) != NULL && entry->d_name[0] == '.')
+            continue;
+
+        path += std::string("/") + (entry ? entry->d_name : "");
+        closedir(dir);
+    }
+
+    return path;
+}
+
+TEST(UsageFixture, Cache) {
+    char directory[] = "/tmp/kmnd_cache_XXXXXX";
+    ASSERT_TRUE(mkdtemp(directory) != NULL);
+    setenv("XDG_CACHE_HOME", directory, 1);
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    kmnd_t *usage = kmnd_usage_new("sample `COMMAND|FILE`", "Sample.");
+    kmnd_t *sub = kmnd_new("sub", "This is a subcommand", NULL, NULL);
+    kmnd_t *kmnd = kmnd_new("sample", NULL, NULL, usage, sub, NULL);
+    kmnd_fd(kmnd, fds[1]);
+    kmnd_usage_cache(kmnd, 1);
+
+    /* The first time, the usage text is rendered and stored. */
+    kmnd_usage_print((kmnd_usage_t *) usage, (kmnd_command_t *) kmnd);
+
+    char first[1024] = { 0 };
+    ssize_t length = read(fds[0], first, sizeof(first));
+    ASSERT_LT(0, length);
+    EXPECT_EQ(0, strncmp("Usage:\n\n    $ sample COMMAND|FILE\n", first, 33));
+
+    /* Alter the cached text to make sure that it is used the next time. */
+    std::string file = usage_cache_file(std::string(directory) + "/kmnd");
+    int fd = open(file.c_str(), O_RDWR);
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(1, pwrite(fd, "z", 1, lseek(fd, 0, SEEK_END) - length + 1));
+    close(fd);
+
+    kmnd_usage_print((kmnd_usage_t *) usage, (kmnd_command_t *) kmnd);
+
+    char second[1024] = { 0 };
+    ASSERT_EQ(length, read(fds[0], second, sizeof(second)));
+    first[1] = 'z';
+    EXPECT_STREQ(first, second);
+
+    kmnd_free(kmnd);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    unlink(file.c_str());
+    rmdir(file.substr(0, file.rfind('/')).c_str());
+    rmdir((std::string(directory) + "/kmnd").c_str());
+    rmdir(directory);
+    unsetenv("XDG_CACHE_HOME");
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026-10-17, Tim van Elsloo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/width.h"
+
+TEST(WidthFixture, CodePoint) {
+    EXPECT_EQ(1, kmnd_width_code_point('a'));
+    EXPECT_EQ(0, kmnd_width_code_point('\n'));
+    EXPECT_EQ(1, kmnd_width_code_point(0xE9));
+    EXPECT_EQ(0, kmnd_width_code_point(0x301));
+    EXPECT_EQ(0, kmnd_width_code_point(0x200B));
+    EXPECT_EQ(2, kmnd_width_code_point(0x6F22));
+    EXPECT_EQ(2, kmnd_width_code_point(0xFF21));
+    EXPECT_EQ(2, kmnd_width_code_point(0x1F600));
+    EXPECT_EQ(1, kmnd_width_code_point(0x10FFFF));
+}
+
+TEST(WidthFixture, Text) {
+    EXPECT_EQ(0u, kmnd_width("", 0));
+    EXPECT_EQ(5u, kmnd_width("hello", 5));
+    EXPECT_EQ(4u, kmnd_width("caf\xC3\xA9", 5));
+    EXPECT_EQ(4u, kmnd_width("\xE6\xBC\xA2\xE5\xAD\x97", 6));
+
+    /* Escape sequences do not take any space. */
+    EXPECT_EQ(2u, kmnd_width("\x1B[1;31mab\x1B[0m", 13));
+
+    /* Invalid and truncated sequences count as one column per byte. */
+    EXPECT_EQ(2u, kmnd_width("\xFF\xC3", 2));
+    EXPECT_EQ(2u, kmnd_width("\xE6\xBC", 2));
+}
+
+TEST(WidthFixture, Fit) {
+    size_t width;
+
+    EXPECT_EQ(3u, kmnd_width_fit("abcdef", 6, 3, &width));
+    EXPECT_EQ(3u, width);
+
+    /* A wide character is never split. */
+    EXPECT_EQ(2u, kmnd_width_fit("ab\xE6\xBC\xA2", 5, 3, &width));
+    EXPECT_EQ(2u, width);
+
+    /* Combining marks stay with the character before them. */
+    EXPECT_EQ(5u, kmnd_width_fit("abe\xCC\x81" "c", 6, 3, &width));
+    EXPECT_EQ(3u, width);
+
+    EXPECT_EQ(0u, kmnd_width_fit("\xE6\xBC\xA2", 3, 1, &width));
+    EXPECT_EQ(0u, width);
+}